@@ -0,0 +1,55 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdio.h>
+
+#if __linux__ || __APPLE__
+#include <time.h>
+#elif _WIN32
+#include <windows.h>
+#else
+#error Unknown operating system
+#endif
+
+/**
+ * @brief Returns current monotonic clock time. (in seconds)
+ */
+static double getBenchmarkTime()
+{
+	#if __linux__ || __APPLE__
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec + (double)time.tv_nsec / 1000000000.0;
+	#elif _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+	#endif
+}
+
+/**
+ * @brief Prints benchmark result line.
+ * 
+ * @param[in] name benchmark name string
+ * @param operationCount measured operation count
+ * @param time elapsed time (in seconds)
+ */
+static void printBenchmarkResult(const char* name, size_t operationCount, double time)
+{
+	printf("%-40s %12.2f ns/op %14.0f op/s\n", name,
+		time * 1000000000.0 / (double)operationCount, (double)operationCount / time);
+	fflush(stdout);
+}
@@ -0,0 +1,168 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+#include "mpmt/defines.h"
+#include "mpmt/spinlock.h"
+#include "mpmt/sync.h"
+#include "mpmt/thread.h"
+
+#include <stdlib.h>
+
+#if __linux__ || __APPLE__
+#include <pthread.h>
+#endif
+
+#define BENCHMARK_MAX_THREAD_COUNT 8
+#define BENCHMARK_LOCK_COUNT 1000000
+
+typedef struct LockArgument
+{
+	Mutex mutex;
+	Spinlock spinlock;
+	TicketLock ticketLock;
+	#if __linux__ || __APPLE__
+	pthread_mutex_t* nativeMutex;
+	#elif _WIN32
+	CRITICAL_SECTION* nativeMutex;
+	#endif
+	volatile size_t counter;
+	size_t lockCount;
+} LockArgument;
+
+// Note: short critical section, the most common case for the thread pool and containers.
+static void onMutexLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+	Mutex mutex = lockArgument->mutex;
+
+	for (size_t i = 0; i < lockArgument->lockCount; i++)
+	{
+		lockMutex(mutex);
+		lockArgument->counter++;
+		unlockMutex(mutex);
+	}
+}
+static void onSpinlockLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+
+	for (size_t i = 0; i < lockArgument->lockCount; i++)
+	{
+		lockSpinlock(&lockArgument->spinlock);
+		lockArgument->counter++;
+		unlockSpinlock(&lockArgument->spinlock);
+	}
+}
+static void onTicketLockLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+
+	for (size_t i = 0; i < lockArgument->lockCount; i++)
+	{
+		lockTicketLock(&lockArgument->ticketLock);
+		lockArgument->counter++;
+		unlockTicketLock(&lockArgument->ticketLock);
+	}
+}
+static void onNativeMutexLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+
+	for (size_t i = 0; i < lockArgument->lockCount; i++)
+	{
+		#if __linux__ || __APPLE__
+		if (pthread_mutex_lock(lockArgument->nativeMutex) != 0) abort();
+		lockArgument->counter++;
+		if (pthread_mutex_unlock(lockArgument->nativeMutex) != 0) abort();
+		#elif _WIN32
+		EnterCriticalSection(lockArgument->nativeMutex);
+		lockArgument->counter++;
+		LeaveCriticalSection(lockArgument->nativeMutex);
+		#endif
+	}
+}
+
+static void benchmarkContention(const char* mutexName, void (*onLock)(void*), LockArgument* lockArgument)
+{
+	for (size_t threadCount = 1; threadCount <= BENCHMARK_MAX_THREAD_COUNT; threadCount *= 2)
+	{
+		Thread threads[BENCHMARK_MAX_THREAD_COUNT];
+		lockArgument->counter = 0;
+		lockArgument->lockCount = BENCHMARK_LOCK_COUNT / threadCount;
+
+		double time = getBenchmarkTime();
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			threads[i] = createThread(onLock, lockArgument);
+			if (!threads[i])
+				abort();
+		}
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			joinThread(threads[i]);
+			destroyThread(threads[i]);
+		}
+		time = getBenchmarkTime() - time;
+
+		if (lockArgument->counter != lockArgument->lockCount * threadCount)
+			abort();
+
+		char name[64];
+		snprintf(name, sizeof(name), "%s (threads: %zu)", mutexName, threadCount);
+		printBenchmarkResult(name, lockArgument->counter, time);
+	}
+}
+
+int main()
+{
+	LockArgument lockArgument;
+	lockArgument.mutex = createMutex();
+	if (!lockArgument.mutex)
+		abort();
+	initSpinlock(&lockArgument.spinlock);
+	initTicketLock(&lockArgument.ticketLock);
+
+	#if __linux__ || __APPLE__
+	pthread_mutex_t nativeMutex;
+	if (pthread_mutex_init(&nativeMutex, NULL) != 0)
+		abort();
+	const char* nativeName = "pthread mutex";
+	#elif _WIN32
+	CRITICAL_SECTION nativeMutex;
+	InitializeCriticalSection(&nativeMutex);
+	const char* nativeName = "critical section";
+	#endif
+	lockArgument.nativeMutex = &nativeMutex;
+
+	#if defined(MPMT_USE_FUTEX) && __linux__
+	const char* mutexName = "futex mutex";
+	#else
+	const char* mutexName = "mutex";
+	#endif
+
+	printf("Mutex lock/unlock contention:\n");
+	benchmarkContention(mutexName, onMutexLock, &lockArgument);
+	benchmarkContention(nativeName, onNativeMutexLock, &lockArgument);
+	benchmarkContention("spinlock", onSpinlockLock, &lockArgument);
+	benchmarkContention("ticket lock", onTicketLockLock, &lockArgument);
+
+	#if __linux__ || __APPLE__
+	pthread_mutex_destroy(&nativeMutex);
+	#elif _WIN32
+	DeleteCriticalSection(&nativeMutex);
+	#endif
+	destroyMutex(lockArgument.mutex);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+#include "mpmt/object_pool.h"
+#include "mpmt/thread_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_THREAD_COUNT 4
+#define BENCHMARK_TASK_COUNT 1000000
+#define BENCHMARK_TASK_CAPACITY 1024
+#define BENCHMARK_BLOCK_CAPACITY 4096
+
+typedef struct TaskArgument
+{
+	ObjectPool objectPool;
+	size_t values[5];
+} TaskArgument;
+
+// Note: argument is allocated on the producer thread and freed on the worker thread.
+static void onMallocTask(void* argument)
+{
+	TaskArgument* taskArgument = (TaskArgument*)argument;
+	taskArgument->values[0] += taskArgument->values[4];
+	free(taskArgument);
+}
+static void onObjectPoolTask(void* argument)
+{
+	TaskArgument* taskArgument = (TaskArgument*)argument;
+	taskArgument->values[0] += taskArgument->values[4];
+	freeObjectPoolObject(taskArgument->objectPool, taskArgument);
+}
+
+static void onInlineTask(void* payload)
+{
+	TaskArgument taskArgument;
+	memcpy(&taskArgument, payload, sizeof(TaskArgument));
+	taskArgument.values[0] += taskArgument.values[4];
+}
+
+static void benchmarkTaskArguments(const char* name, ObjectPool objectPool, TaskOrder taskOrder)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, BENCHMARK_TASK_CAPACITY, taskOrder);
+	if (!threadPool)
+		abort();
+
+	ThreadPoolTask task;
+	task.function = objectPool ? onObjectPoolTask : onMallocTask;
+
+	double time = getBenchmarkTime();
+	for (size_t i = 0; i < BENCHMARK_TASK_COUNT; i++)
+	{
+		TaskArgument* argument = objectPool ? 
+			allocateObjectPoolObject(objectPool) : malloc(sizeof(TaskArgument));
+		if (!argument)
+			abort();
+
+		argument->objectPool = objectPool;
+		argument->values[0] = i;
+		argument->values[4] = i;
+		task.argument = argument;
+		addThreadPoolTask(threadPool, task);
+	}
+	waitThreadPool(threadPool);
+	time = getBenchmarkTime() - time;
+
+	destroyThreadPool(threadPool);
+	printBenchmarkResult(name, BENCHMARK_TASK_COUNT, time);
+}
+// Note: argument is copied into the task buffer, no allocation at all.
+static void benchmarkInlineArguments(const char* name, TaskOrder taskOrder)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, BENCHMARK_TASK_CAPACITY, taskOrder);
+	if (!threadPool)
+		abort();
+
+	ThreadPoolInlineTask task;
+	task.function = onInlineTask;
+
+	double time = getBenchmarkTime();
+	for (size_t i = 0; i < BENCHMARK_TASK_COUNT; i++)
+	{
+		TaskArgument argument;
+		argument.objectPool = NULL;
+		argument.values[0] = i;
+		argument.values[4] = i;
+		memcpy(task.payload, &argument, sizeof(TaskArgument));
+		addThreadPoolInlineTask(threadPool, &task);
+	}
+	waitThreadPool(threadPool);
+	time = getBenchmarkTime() - time;
+
+	destroyThreadPool(threadPool);
+	printBenchmarkResult(name, BENCHMARK_TASK_COUNT, time);
+}
+
+int main()
+{
+	ObjectPool objectPool = createObjectPool(sizeof(TaskArgument), BENCHMARK_BLOCK_CAPACITY);
+	if (!objectPool)
+		abort();
+
+	printf("Producer allocates, worker frees task argument:\n");
+	benchmarkTaskArguments("malloc (queue)", NULL, QUEUE_TASK_ORDER);
+	benchmarkTaskArguments("object pool (queue)", objectPool, QUEUE_TASK_ORDER);
+	benchmarkInlineArguments("inline payload (queue)", QUEUE_TASK_ORDER);
+	benchmarkTaskArguments("malloc (lock-free)", NULL, LOCK_FREE_TASK_ORDER);
+	benchmarkTaskArguments("object pool (lock-free)", objectPool, LOCK_FREE_TASK_ORDER);
+	benchmarkInlineArguments("inline payload (lock-free)", LOCK_FREE_TASK_ORDER);
+
+	destroyObjectPool(objectPool);
+	return EXIT_SUCCESS;
+}
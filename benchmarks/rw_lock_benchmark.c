@@ -0,0 +1,171 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+#include "mpmt/sync.h"
+#include "mpmt/thread.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define BENCHMARK_MAX_THREAD_COUNT 8
+#define BENCHMARK_OPERATION_COUNT 1000000
+#define BENCHMARK_TABLE_SIZE 16
+
+typedef struct LockArgument
+{
+	Mutex mutex;
+	RwLock rwLock;
+	DistRwLock distRwLock;
+	size_t table[BENCHMARK_TABLE_SIZE];
+	size_t operationCount;
+	size_t writeRate;
+	volatile size_t result;
+} LockArgument;
+
+// Note: reads are summing the small table, writes are updating one of its entries.
+static size_t readTable(LockArgument* lockArgument)
+{
+	size_t sum = 0;
+	for (size_t i = 0; i < BENCHMARK_TABLE_SIZE; i++)
+		sum += lockArgument->table[i];
+	return sum;
+}
+
+static void onMutexLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+	Mutex mutex = lockArgument->mutex;
+	size_t writeRate = lockArgument->writeRate, sum = 0;
+
+	for (size_t i = 0; i < lockArgument->operationCount; i++)
+	{
+		lockMutex(mutex);
+		if (i % writeRate == 0)
+			lockArgument->table[i % BENCHMARK_TABLE_SIZE]++;
+		else
+			sum += readTable(lockArgument);
+		unlockMutex(mutex);
+	}
+	lockArgument->result = sum;
+}
+static void onRwLockLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+	RwLock rwLock = lockArgument->rwLock;
+	size_t writeRate = lockArgument->writeRate, sum = 0;
+
+	for (size_t i = 0; i < lockArgument->operationCount; i++)
+	{
+		if (i % writeRate == 0)
+		{
+			writeLockRwLock(rwLock);
+			lockArgument->table[i % BENCHMARK_TABLE_SIZE]++;
+			writeUnlockRwLock(rwLock);
+		}
+		else
+		{
+			readLockRwLock(rwLock);
+			sum += readTable(lockArgument);
+			readUnlockRwLock(rwLock);
+		}
+	}
+	lockArgument->result = sum;
+}
+
+static void onDistRwLockLock(void* argument)
+{
+	LockArgument* lockArgument = (LockArgument*)argument;
+	DistRwLock distRwLock = lockArgument->distRwLock;
+	size_t writeRate = lockArgument->writeRate, sum = 0;
+
+	for (size_t i = 0; i < lockArgument->operationCount; i++)
+	{
+		if (i % writeRate == 0)
+		{
+			writeLockDistRwLock(distRwLock);
+			lockArgument->table[i % BENCHMARK_TABLE_SIZE]++;
+			writeUnlockDistRwLock(distRwLock);
+		}
+		else
+		{
+			readLockDistRwLock(distRwLock);
+			sum += readTable(lockArgument);
+			readUnlockDistRwLock(distRwLock);
+		}
+	}
+	lockArgument->result = sum;
+}
+
+static void benchmarkWorkload(const char* lockName, void (*onLock)(void*), 
+	LockArgument* lockArgument, size_t writeRate)
+{
+	for (size_t threadCount = 1; threadCount <= BENCHMARK_MAX_THREAD_COUNT; threadCount *= 2)
+	{
+		Thread threads[BENCHMARK_MAX_THREAD_COUNT];
+		lockArgument->operationCount = BENCHMARK_OPERATION_COUNT / threadCount;
+		lockArgument->writeRate = writeRate;
+
+		double time = getBenchmarkTime();
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			threads[i] = createThread(onLock, lockArgument);
+			if (!threads[i])
+				abort();
+		}
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			joinThread(threads[i]);
+			destroyThread(threads[i]);
+		}
+		time = getBenchmarkTime() - time;
+
+		char name[64];
+		snprintf(name, sizeof(name), "%s (threads: %zu)", lockName, threadCount);
+		printBenchmarkResult(name, lockArgument->operationCount * threadCount, time);
+	}
+}
+
+int main()
+{
+	LockArgument* lockArgument = calloc(1, sizeof(LockArgument));
+	if (!lockArgument)
+		abort();
+	lockArgument->mutex = createMutex();
+	lockArgument->rwLock = createRwLock();
+	lockArgument->distRwLock = createDistRwLock(0);
+	if (!lockArgument->mutex || !lockArgument->rwLock || !lockArgument->distRwLock)
+		abort();
+
+	printf("Read scaling (reads only):\n");
+	benchmarkWorkload("dist rwlock", onDistRwLockLock, lockArgument, SIZE_MAX);
+	benchmarkWorkload("rwlock", onRwLockLock, lockArgument, SIZE_MAX);
+	benchmarkWorkload("mutex", onMutexLock, lockArgument, SIZE_MAX);
+
+	printf("\nRead-heavy workload (99%% reads, 1%% writes):\n");
+	benchmarkWorkload("dist rwlock", onDistRwLockLock, lockArgument, 100);
+	benchmarkWorkload("rwlock", onRwLockLock, lockArgument, 100);
+	benchmarkWorkload("mutex", onMutexLock, lockArgument, 100);
+
+	printf("\nMixed workload (50%% reads, 50%% writes):\n");
+	benchmarkWorkload("dist rwlock", onDistRwLockLock, lockArgument, 2);
+	benchmarkWorkload("rwlock", onRwLockLock, lockArgument, 2);
+	benchmarkWorkload("mutex", onMutexLock, lockArgument, 2);
+
+	destroyDistRwLock(lockArgument->distRwLock);
+	destroyRwLock(lockArgument->rwLock);
+	destroyMutex(lockArgument->mutex);
+	free(lockArgument);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,407 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+#include "mpmt/task_graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_THREAD_COUNT 4
+#define BENCHMARK_TASK_COUNT 1000000
+
+static void onEmptyTask(void* argument)
+{
+}
+
+static void benchmarkQueueDepth(size_t taskCapacity, TaskOrder taskOrder)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, taskCapacity, taskOrder);
+	if (!threadPool)
+		abort();
+
+	ThreadPoolTask task = { onEmptyTask, NULL };
+
+	double time = getBenchmarkTime();
+	addThreadPoolTaskNumber(threadPool, task, BENCHMARK_TASK_COUNT);
+	waitThreadPool(threadPool);
+	time = getBenchmarkTime() - time;
+
+	destroyThreadPool(threadPool);
+
+	char name[64];
+	static const char* orderNames[TASK_ORDER_COUNT] = { 
+		"stack", "queue", "stealing", "lock-free", "numa", "segmented" 
+	};
+	const char* orderName = orderNames[taskOrder];
+	if (taskCapacity == THREAD_POOL_UNBOUNDED_CAPACITY)
+		snprintf(name, sizeof(name), "%s (capacity: unbounded)", orderName);
+	else
+		snprintf(name, sizeof(name), "%s (capacity: %zu)", orderName, taskCapacity);
+	printBenchmarkResult(name, BENCHMARK_TASK_COUNT, time);
+}
+
+//**********************************************************************************************************************
+#define BENCHMARK_RANGE_SIZE 16777216
+#define BENCHMARK_CHUNK_SIZE 4096
+
+typedef struct ChunkArgument
+{
+	float* values;
+	size_t rangeBegin;
+	size_t rangeEnd;
+} ChunkArgument;
+
+static void onRangeFunction(void* context, size_t rangeBegin, size_t rangeEnd)
+{
+	float* values = (float*)context;
+	for (size_t i = rangeBegin; i < rangeEnd; i++)
+		values[i] = values[i] * 0.5f + 1.0f;
+}
+static void onChunkTask(void* argument)
+{
+	ChunkArgument* chunk = (ChunkArgument*)argument;
+	onRangeFunction(chunk->values, chunk->rangeBegin, chunk->rangeEnd);
+	free(chunk);
+}
+
+static void benchmarkParallelFor()
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, 
+		BENCHMARK_RANGE_SIZE / BENCHMARK_CHUNK_SIZE, STACK_TASK_ORDER);
+	float* values = calloc(BENCHMARK_RANGE_SIZE, sizeof(float));
+	if (!threadPool || !values)
+		abort();
+	onRangeFunction(values, 0, BENCHMARK_RANGE_SIZE); // Note: warming up memory pages.
+
+	double time = getBenchmarkTime();
+	for (size_t i = 0; i < BENCHMARK_RANGE_SIZE; i += BENCHMARK_CHUNK_SIZE)
+	{
+		ChunkArgument* chunk = malloc(sizeof(ChunkArgument));
+		if (!chunk)
+			abort();
+		chunk->values = values;
+		chunk->rangeBegin = i;
+		chunk->rangeEnd = i + BENCHMARK_CHUNK_SIZE;
+
+		ThreadPoolTask task = { onChunkTask, chunk };
+		addThreadPoolTask(threadPool, task);
+	}
+	waitThreadPool(threadPool);
+	time = getBenchmarkTime() - time;
+	printBenchmarkResult("chunk tasks", BENCHMARK_RANGE_SIZE, time);
+
+	time = getBenchmarkTime();
+	parallelForThreadPool(threadPool, 0, BENCHMARK_RANGE_SIZE, 
+		BENCHMARK_CHUNK_SIZE, onRangeFunction, values);
+	time = getBenchmarkTime() - time;
+	printBenchmarkResult("parallel for", BENCHMARK_RANGE_SIZE, time);
+
+	free(values);
+	destroyThreadPool(threadPool);
+}
+
+//**********************************************************************************************************************
+#define BENCHMARK_NODE_CHUNK_COUNT 256
+#define BENCHMARK_NODE_CHUNK_SIZE 65536
+#define BENCHMARK_NODE_PASS_COUNT 8
+
+static void onInitNodeChunk(void* argument)
+{
+	float* values = (float*)argument;
+	for (size_t i = 0; i < BENCHMARK_NODE_CHUNK_SIZE; i++)
+		values[i] = (float)i; // Note: first touch places pages on the worker node.
+}
+static void onSumNodeChunk(void* argument)
+{
+	float* values = (float*)argument;
+	float sum = 0.0f;
+	for (size_t i = 0; i < BENCHMARK_NODE_CHUNK_SIZE; i++)
+		sum += values[i];
+	values[0] = sum * 0.0f;
+}
+
+static void benchmarkMemoryBound(TaskOrder taskOrder)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, BENCHMARK_NODE_CHUNK_COUNT, taskOrder);
+	float** chunks = malloc(BENCHMARK_NODE_CHUNK_COUNT * sizeof(float*));
+	if (!threadPool || !chunks)
+		abort();
+
+	size_t nodeCount = getThreadPoolNodeCount(threadPool);
+	for (size_t i = 0; i < BENCHMARK_NODE_CHUNK_COUNT; i++)
+	{
+		chunks[i] = malloc(BENCHMARK_NODE_CHUNK_SIZE * sizeof(float));
+		if (!chunks[i])
+			abort();
+
+		ThreadPoolTask task = { onInitNodeChunk, chunks[i] };
+		addThreadPoolNodeTask(threadPool, task, i % nodeCount);
+	}
+	waitThreadPool(threadPool);
+
+	double time = getBenchmarkTime();
+	for (size_t pass = 0; pass < BENCHMARK_NODE_PASS_COUNT; pass++)
+	{
+		for (size_t i = 0; i < BENCHMARK_NODE_CHUNK_COUNT; i++)
+		{
+			ThreadPoolTask task = { onSumNodeChunk, chunks[i] };
+			addThreadPoolNodeTask(threadPool, task, i % nodeCount);
+		}
+	}
+	waitThreadPool(threadPool);
+	time = getBenchmarkTime() - time;
+
+	destroyThreadPool(threadPool);
+	for (size_t i = 0; i < BENCHMARK_NODE_CHUNK_COUNT; i++)
+		free(chunks[i]);
+	free(chunks);
+
+	char name[64];
+	snprintf(name, sizeof(name), "memory bound %s (nodes: %zu)", 
+		taskOrder == NUMA_TASK_ORDER ? "numa" : "queue", nodeCount);
+	printBenchmarkResult(name, (size_t)BENCHMARK_NODE_CHUNK_COUNT * 
+		BENCHMARK_NODE_CHUNK_SIZE * BENCHMARK_NODE_PASS_COUNT, time);
+}
+
+//**********************************************************************************************************************
+#define BENCHMARK_LATENCY_SAMPLE_COUNT 2000
+#define BENCHMARK_LATENCY_GAP 0.0002
+
+typedef struct LatencyPayload
+{
+	double* latencies;
+	double submitTime;
+	size_t index;
+} LatencyPayload;
+
+static void onLatencyTask(void* payload)
+{
+	const LatencyPayload* latency = (const LatencyPayload*)payload;
+	latency->latencies[latency->index] = getBenchmarkTime() - latency->submitTime;
+}
+static int compareLatencies(const void* a, const void* b)
+{
+	double latencyA = *(const double*)a, latencyB = *(const double*)b;
+	return (latencyA > latencyB) - (latencyA < latencyB);
+}
+
+static void benchmarkIdleLatency(TaskOrder taskOrder, IdlePolicy idlePolicy)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, BENCHMARK_THREAD_COUNT * 4, taskOrder);
+	double* latencies = malloc(BENCHMARK_LATENCY_SAMPLE_COUNT * sizeof(double));
+	if (!threadPool || !latencies)
+		abort();
+
+	setThreadPoolIdlePolicy(threadPool, idlePolicy, 
+		THREAD_POOL_DEFAULT_SPIN_COUNT, THREAD_POOL_DEFAULT_YIELD_COUNT);
+
+	// Note: gap between the tasks lets the workers go idle, like with the sporadic requests.
+	for (size_t i = 0; i < BENCHMARK_LATENCY_SAMPLE_COUNT; i++)
+	{
+		ThreadPoolInlineTask task;
+		LatencyPayload payload;
+		payload.latencies = latencies;
+		payload.index = i;
+		task.function = onLatencyTask;
+
+		sleepThread(BENCHMARK_LATENCY_GAP);
+		payload.submitTime = getBenchmarkTime();
+		memcpy(task.payload, &payload, sizeof(LatencyPayload));
+		addThreadPoolInlineTask(threadPool, &task);
+		waitThreadPool(threadPool);
+	}
+
+	destroyThreadPool(threadPool);
+	qsort(latencies, BENCHMARK_LATENCY_SAMPLE_COUNT, sizeof(double), compareLatencies);
+
+	static const char* policyNames[IDLE_POLICY_COUNT] = { "park", "adaptive", "busy-poll" };
+	char name[64];
+	snprintf(name, sizeof(name), "%s %s", taskOrder == QUEUE_TASK_ORDER ? 
+		"queue" : "lock-free", policyNames[idlePolicy]);
+	printf("%-40s %9.2f us p50 %9.2f us p99\n", name, 
+		latencies[BENCHMARK_LATENCY_SAMPLE_COUNT / 2] * 1000000.0, 
+		latencies[BENCHMARK_LATENCY_SAMPLE_COUNT * 99 / 100] * 1000000.0);
+	fflush(stdout);
+	free(latencies);
+}
+
+//**********************************************************************************************************************
+#define BENCHMARK_BACKLOG_SAMPLE_COUNT 200
+#define BENCHMARK_BACKLOG_TASK_COUNT 1024
+#define BENCHMARK_BACKLOG_TASK_WORK 2000
+
+typedef struct BacklogSample
+{
+	double submitTime;
+	double latency;
+} BacklogSample;
+
+static void onBacklogTask(void* argument)
+{
+	volatile size_t counter = 0;
+	for (size_t i = 0; i < BENCHMARK_BACKLOG_TASK_WORK; i++)
+		counter++;
+}
+static void onBacklogProbeTask(void* argument)
+{
+	BacklogSample* sample = (BacklogSample*)argument;
+	sample->latency = getBenchmarkTime() - sample->submitTime;
+}
+
+static void benchmarkPriorityLatency(TaskPriority priority)
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, 
+		BENCHMARK_BACKLOG_TASK_COUNT * 2, QUEUE_TASK_ORDER);
+	double* latencies = malloc(BENCHMARK_BACKLOG_SAMPLE_COUNT * sizeof(double));
+	if (!threadPool || !latencies)
+		abort();
+
+	// Note: probe task is added behind the backlog of the background tasks.
+	ThreadPoolTask backlogTask = { onBacklogTask, NULL };
+	for (size_t i = 0; i < BENCHMARK_BACKLOG_SAMPLE_COUNT; i++)
+	{
+		BacklogSample sample;
+		ThreadPoolTask probeTask = { onBacklogProbeTask, &sample };
+		addThreadPoolPriorityTaskNumber(threadPool, backlogTask, BENCHMARK_BACKLOG_TASK_COUNT, LOW_TASK_PRIORITY);
+
+		sample.submitTime = getBenchmarkTime();
+		addThreadPoolPriorityTask(threadPool, probeTask, priority);
+		waitThreadPool(threadPool);
+		latencies[i] = sample.latency;
+	}
+
+	destroyThreadPool(threadPool);
+	qsort(latencies, BENCHMARK_BACKLOG_SAMPLE_COUNT, sizeof(double), compareLatencies);
+
+	static const char* priorityNames[TASK_PRIORITY_COUNT] = { "high", "normal", "low" };
+	char name[64];
+	snprintf(name, sizeof(name), "%s priority behind low backlog", priorityNames[priority]);
+	printf("%-40s %9.2f us p50 %9.2f us p99\n", name, 
+		latencies[BENCHMARK_BACKLOG_SAMPLE_COUNT / 2] * 1000000.0, 
+		latencies[BENCHMARK_BACKLOG_SAMPLE_COUNT * 99 / 100] * 1000000.0);
+	fflush(stdout);
+	free(latencies);
+}
+
+//**********************************************************************************************************************
+#define BENCHMARK_GRAPH_LAYER_COUNT 10
+#define BENCHMARK_GRAPH_LAYER_SIZE 20
+#define BENCHMARK_GRAPH_RUN_COUNT 1000
+
+// Note: uneven node work, so that the wave barriers wait for the slowest node of the layer.
+static void onGraphNodeTask(void* argument)
+{
+	volatile size_t counter = 0;
+	size_t work = (size_t)argument;
+	for (size_t i = 0; i < work; i++)
+		counter++;
+}
+
+static void benchmarkTaskGraph()
+{
+	ThreadPool threadPool = createThreadPool(BENCHMARK_THREAD_COUNT, 
+		BENCHMARK_GRAPH_LAYER_SIZE * 4, QUEUE_TASK_ORDER);
+	if (!threadPool)
+		abort();
+
+	TaskGraph taskGraph = createTaskGraph(threadPool);
+	if (!taskGraph)
+		abort();
+
+	ThreadPoolTask tasks[BENCHMARK_GRAPH_LAYER_COUNT][BENCHMARK_GRAPH_LAYER_SIZE];
+	srand(1);
+
+	for (size_t i = 0; i < BENCHMARK_GRAPH_LAYER_COUNT; i++)
+	{
+		for (size_t j = 0; j < BENCHMARK_GRAPH_LAYER_SIZE; j++)
+		{
+			size_t node = i * BENCHMARK_GRAPH_LAYER_SIZE + j;
+			tasks[i][j].function = onGraphNodeTask;
+			tasks[i][j].argument = (void*)(size_t)(rand() % 8 == 0 ? 20000 : 1000);
+			if (!addTaskGraphNode(taskGraph, tasks[i][j], NULL))
+				abort();
+			if (i == 0)
+				continue;
+
+			for (size_t k = 0; k < 2; k++)
+			{
+				size_t predecessor = (i - 1) * BENCHMARK_GRAPH_LAYER_SIZE + (size_t)rand() % BENCHMARK_GRAPH_LAYER_SIZE;
+				if (!addTaskGraphEdge(taskGraph, predecessor, node))
+					abort();
+			}
+		}
+	}
+
+	double time = getBenchmarkTime();
+	for (size_t i = 0; i < BENCHMARK_GRAPH_RUN_COUNT; i++)
+	{
+		for (size_t j = 0; j < BENCHMARK_GRAPH_LAYER_COUNT; j++)
+		{
+			addThreadPoolTasks(threadPool, tasks[j], BENCHMARK_GRAPH_LAYER_SIZE);
+			waitThreadPool(threadPool);
+		}
+	}
+	time = getBenchmarkTime() - time;
+	printBenchmarkResult("barrier-separated waves", BENCHMARK_GRAPH_RUN_COUNT, time);
+
+	time = getBenchmarkTime();
+	for (size_t i = 0; i < BENCHMARK_GRAPH_RUN_COUNT; i++)
+	{
+		if (!runTaskGraph(taskGraph))
+			abort();
+	}
+	time = getBenchmarkTime() - time;
+	printBenchmarkResult("task graph", BENCHMARK_GRAPH_RUN_COUNT, time);
+
+	destroyTaskGraph(taskGraph);
+	destroyThreadPool(threadPool);
+}
+
+int main()
+{
+	printf("Thread pool task throughput:\n");
+	for (size_t taskCapacity = 64; taskCapacity <= 65536; taskCapacity *= 4)
+		benchmarkQueueDepth(taskCapacity, QUEUE_TASK_ORDER);
+	for (size_t taskCapacity = 64; taskCapacity <= 65536; taskCapacity *= 4)
+		benchmarkQueueDepth(taskCapacity, STACK_TASK_ORDER);
+	for (size_t taskCapacity = 64; taskCapacity <= 65536; taskCapacity *= 4)
+		benchmarkQueueDepth(taskCapacity, LOCK_FREE_TASK_ORDER);
+	for (size_t taskCapacity = 64; taskCapacity <= 65536; taskCapacity *= 4)
+		benchmarkQueueDepth(taskCapacity, NUMA_TASK_ORDER);
+	for (size_t taskCapacity = 64; taskCapacity <= 65536; taskCapacity *= 4)
+		benchmarkQueueDepth(taskCapacity, SEGMENTED_TASK_ORDER);
+	benchmarkQueueDepth(THREAD_POOL_UNBOUNDED_CAPACITY, SEGMENTED_TASK_ORDER);
+
+	printf("\nData parallel loop:\n");
+	benchmarkParallelFor();
+
+	printf("\nMemory bandwidth bound tasks:\n");
+	benchmarkMemoryBound(QUEUE_TASK_ORDER);
+	benchmarkMemoryBound(NUMA_TASK_ORDER);
+
+	printf("\nSubmit to start latency:\n");
+	for (IdlePolicy idlePolicy = 0; idlePolicy < IDLE_POLICY_COUNT; idlePolicy++)
+		benchmarkIdleLatency(QUEUE_TASK_ORDER, idlePolicy);
+	for (IdlePolicy idlePolicy = 0; idlePolicy < IDLE_POLICY_COUNT; idlePolicy++)
+		benchmarkIdleLatency(LOCK_FREE_TASK_ORDER, idlePolicy);
+
+	printf("\nPriority task latency:\n");
+	for (TaskPriority priority = 0; priority < TASK_PRIORITY_COUNT; priority++)
+		benchmarkPriorityLatency(priority);
+
+	printf("\nTask graph run:\n");
+	benchmarkTaskGraph();
+	return EXIT_SUCCESS;
+}
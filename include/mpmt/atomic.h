@@ -22,13 +22,14 @@
  * race conditions and ensure correct behavior when multiple threads are concurrently accessing shared data.
  */
 
-// TODO: compare exchange, test/set/clear, thread fences and barriers.
-// TODO: relaxed barrier functions.
+// TODO: test/set/clear.
 
 #pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #if __linux__ || __APPLE__
-#include <stdint.h>
 
 /**
  * @brief Integer type for atomic operations. (int8)
@@ -266,116 +267,134 @@
  */
 #define atomicFetchAdd64(memory, value) __atomic_fetch_add(memory, value, __ATOMIC_SEQ_CST)
 
-#elif _WIN32
-#include <intrin.h>
-#include <windows.h>
-
 /***********************************************************************************************************************
- * @brief Integer type for atomic operations. (int8)
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
  */
-#define atomic_int8 volatile CHAR
+#define atomicCompareExchange8(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 /**
- * @brief Integer type for atomic operations. (int16)
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
  */
-#define atomic_int16 volatile SHORT
+#define atomicCompareExchange16(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 /**
- * @brief Integer type for atomic operations. (int32)
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
  */
-#define atomic_int32 volatile LONG
+#define atomicCompareExchange32(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 /**
- * @brief Integer type for atomic operations. (int64)
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
  */
-#define atomic_int64 volatile LONG64
+#define atomicCompareExchange64(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 
+/***********************************************************************************************************************
+ * @brief Relaxed memory order, only atomicity is guaranteed. (Statistics counters)
+ */
+#define ATOMIC_RELAXED __ATOMIC_RELAXED
+/**
+ * @brief Acquire memory order, later memory operations can not be reordered before the load.
+ */
+#define ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+/**
+ * @brief Release memory order, earlier memory operations can not be reordered after the store.
+ */
+#define ATOMIC_RELEASE __ATOMIC_RELEASE
 /**
+ * @brief Acquire and release memory order, for the read-modify-write operations.
+ */
+#define ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+/**
+ * @brief Sequentially consistent memory order, single total order of all operations. (Default)
+ */
+#define ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+/**
+ * @brief Returns the memory order for the failed compare exchange. (Can not contain release)
+ */
+#define atomicFailureOrder(order) ((order) == __ATOMIC_RELEASE ? __ATOMIC_RELAXED : \
+	((order) == __ATOMIC_ACQ_REL ? __ATOMIC_ACQUIRE : (order)))
+
+/***********************************************************************************************************************
  * @brief Atomically loads the value from the variable that memory points to.
  * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  * @return The current value of the variable that memory points to.
  */
-static inline atomic_int8 atomicLoad8(atomic_int8* memory)
-{
-	atomic_int8 value = *memory;
-	MemoryBarrier();
-	return value;
-}
+#define atomicLoadExplicit8(memory, order) __atomic_load_n(memory, order)
 /**
  * @brief Atomically loads the value from the variable that memory points to.
  * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  * @return The current value of the variable that memory points to.
  */
-static inline atomic_int16 atomicLoad16(atomic_int16* memory)
-{
-	atomic_int16 value = *memory;
-	MemoryBarrier();
-	return value;
-}
+#define atomicLoadExplicit16(memory, order) __atomic_load_n(memory, order)
 /**
  * @brief Atomically loads the value from the variable that memory points to.
  * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  * @return The current value of the variable that memory points to.
  */
-static inline atomic_int32 atomicLoad32(atomic_int32* memory)
-{
-	atomic_int32 value = *memory;
-	MemoryBarrier();
-	return value;
-}
+#define atomicLoadExplicit32(memory, order) __atomic_load_n(memory, order)
 /**
  * @brief Atomically loads the value from the variable that memory points to.
  * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  * @return The current value of the variable that memory points to.
  */
-static inline atomic_int64 atomicLoad64(atomic_int64* memory)
-{
-	atomic_int64 value = *memory;
-	MemoryBarrier();
-	return value;
-}
+#define atomicLoadExplicit64(memory, order) __atomic_load_n(memory, order)
 
 /***********************************************************************************************************************
  * @brief Atomically stores the value to the variable that memory points to.
  *
  * @param[out] memory pointer of a variable to which the value is to be stored
  * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-static inline void atomicStore8(atomic_int8* memory, atomic_int8 value)
-{
-	*memory = value;
-	MemoryBarrier();
-}
+#define atomicStoreExplicit8(memory, value, order) __atomic_store_n(memory, value, order)
 /**
  * @brief Atomically stores the value to the variable that memory points to.
  *
  * @param[out] memory pointer of a variable to which the value is to be stored
  * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-static inline void atomicStore16(atomic_int16* memory, atomic_int16 value)
-{
-	*memory = value;
-	MemoryBarrier();
-}
+#define atomicStoreExplicit16(memory, value, order) __atomic_store_n(memory, value, order)
 /**
  * @brief Atomically stores the value to the variable that memory points to.
  *
  * @param[out] memory pointer of a variable to which the value is to be stored
  * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-static inline void atomicStore32(atomic_int32* memory, atomic_int32 value)
-{
-	*memory = value;
-	MemoryBarrier();
-}
+#define atomicStoreExplicit32(memory, value, order) __atomic_store_n(memory, value, order)
 /**
  * @brief Atomically stores the value to the variable that memory points to.
  *
  * @param[out] memory pointer of a variable to which the value is to be stored
  * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
-{
-	*memory = value;
-	MemoryBarrier();
-}
+#define atomicStoreExplicit64(memory, value, order) __atomic_store_n(memory, value, order)
 
 /***********************************************************************************************************************
  * @brief Atomically exchanges the value of the variable that memory points to.
@@ -383,32 +402,36 @@ static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
  *
  * @param[in,out] memory pointer of a variable to which the value is to be written
  * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicExchange8(memory, value) _InterlockedExchange8(memory, value)
+#define atomicExchangeExplicit8(memory, value, order) __atomic_exchange_n(memory, value, order)
 /**
  * @brief Atomically exchanges the value of the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the value is to be written
  * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicExchange16(memory, value) _InterlockedExchange16(memory, value)
+#define atomicExchangeExplicit16(memory, value, order) __atomic_exchange_n(memory, value, order)
 /**
  * @brief Atomically exchanges the value of the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the value is to be written
  * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicExchange32(memory, value) _InterlockedExchange(memory, value)
+#define atomicExchangeExplicit32(memory, value, order) __atomic_exchange_n(memory, value, order)
 /**
  * @brief Atomically exchanges the value of the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the value is to be written
  * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicExchange64(memory, value) _InterlockedExchange64(memory, value)
+#define atomicExchangeExplicit64(memory, value, order) __atomic_exchange_n(memory, value, order)
 
 /***********************************************************************************************************************
  * @brief Atomically performs AND operation to the variable that memory points to.
@@ -416,32 +439,36 @@ static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
  *
  * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
  * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAnd8(memory, value) _InterlockedAnd8(memory, value)
+#define atomicFetchAndExplicit8(memory, value, order) __atomic_fetch_and(memory, value, order)
 /**
  * @brief Atomically performs AND operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
  * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAnd16(memory, value) _InterlockedAnd16(memory, value)
+#define atomicFetchAndExplicit16(memory, value, order) __atomic_fetch_and(memory, value, order)
 /**
  * @brief Atomically performs AND operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
  * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAnd32(memory, value) _InterlockedAnd(memory, value)
+#define atomicFetchAndExplicit32(memory, value, order) __atomic_fetch_and(memory, value, order)
 /**
  * @brief Atomically performs AND operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
  * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAnd64(memory, value) _InterlockedAnd64(memory, value)
+#define atomicFetchAndExplicit64(memory, value, order) __atomic_fetch_and(memory, value, order)
 
 /***********************************************************************************************************************
  * @brief Atomically performs OR operation to the variable that memory points to.
@@ -449,32 +476,36 @@ static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
  *
  * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
  * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchOr8(memory, value) _InterlockedOr8(memory, value)
+#define atomicFetchOrExplicit8(memory, value, order) __atomic_fetch_or(memory, value, order)
 /**
  * @brief Atomically performs OR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
  * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchOr16(memory, value) _InterlockedOr16(memory, value)
+#define atomicFetchOrExplicit16(memory, value, order) __atomic_fetch_or(memory, value, order)
 /**
  * @brief Atomically performs OR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
  * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchOr32(memory, value) _InterlockedOr(memory, value)
+#define atomicFetchOrExplicit32(memory, value, order) __atomic_fetch_or(memory, value, order)
 /**
  * @brief Atomically performs OR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
  * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchOr64(memory, value) _InterlockedOr64(memory, value)
+#define atomicFetchOrExplicit64(memory, value, order) __atomic_fetch_or(memory, value, order)
 
 /***********************************************************************************************************************
  * @brief Atomically performs XOR operation to the variable that memory points to.
@@ -482,66 +513,1599 @@ static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
  *
  * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
  * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchXor8(memory, value) _InterlockedXor8(memory, value)
+#define atomicFetchXorExplicit8(memory, value, order) __atomic_fetch_xor(memory, value, order)
 /**
  * @brief Atomically performs XOR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
  * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchXor16(memory, value) _InterlockedXor16(memory, value)
+#define atomicFetchXorExplicit16(memory, value, order) __atomic_fetch_xor(memory, value, order)
 /**
  * @brief Atomically performs XOR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
  * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchXor32(memory, value) _InterlockedXor(memory, value)
+#define atomicFetchXorExplicit32(memory, value, order) __atomic_fetch_xor(memory, value, order)
 /**
  * @brief Atomically performs XOR operation to the variable that memory points to.
  * @return The current value of the variable that memory points to.
  *
  * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
  * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchXor64(memory, value) _InterlockedXor64(memory, value)
+#define atomicFetchXorExplicit64(memory, value, order) __atomic_fetch_xor(memory, value, order)
 
 /***********************************************************************************************************************
  * @brief Atomically adds the value to the variable that memory points to.
  * @return The initial value of the variable that memory points to.
- * 
+ *
  * @param[in,out] memory pointer of a variable to which the value is to be added
  * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAdd8(memory, value) _InterlockedExchangeAdd8(memory, value)
+#define atomicFetchAddExplicit8(memory, value, order) __atomic_fetch_add(memory, value, order)
 /**
  * @brief Atomically adds the value to the variable that memory points to.
  * @return The initial value of the variable that memory points to.
- * 
+ *
  * @param[in,out] memory pointer of a variable to which the value is to be added
  * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAdd16(memory, value) _InterlockedExchangeAdd16(memory, value)
+#define atomicFetchAddExplicit16(memory, value, order) __atomic_fetch_add(memory, value, order)
 /**
  * @brief Atomically adds the value to the variable that memory points to.
  * @return The initial value of the variable that memory points to.
- * 
+ *
  * @param[in,out] memory pointer of a variable to which the value is to be added
  * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAdd32(memory, value) _InterlockedExchangeAdd(memory, value)
+#define atomicFetchAddExplicit32(memory, value, order) __atomic_fetch_add(memory, value, order)
 /**
  * @brief Atomically adds the value to the variable that memory points to.
  * @return The initial value of the variable that memory points to.
- * 
+ *
  * @param[in,out] memory pointer of a variable to which the value is to be added
  * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
  */
-#define atomicFetchAdd64(memory, value) _InterlockedExchangeAdd64(memory, value)
+#define atomicFetchAddExplicit64(memory, value, order) __atomic_fetch_add(memory, value, order)
 
-#else
-#error Unknown operating system
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak8(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak16(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak32(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak64(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit8(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit16(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit32(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit64(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit8(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit16(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit32(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, order, atomicFailureOrder(order))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit64(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, true, order, atomicFailureOrder(order))
+
+/***********************************************************************************************************************
+ * @brief Memory fence, orders memory operations between threads without an associated atomic operation.
+ * @param order memory order of the fence (ATOMIC_ACQUIRE, ATOMIC_RELEASE, etc.)
+ */
+#define atomicThreadFence(order) __atomic_thread_fence(order)
+/**
+ * @brief Compiler only fence, orders memory operations between a thread and a signal handler executed on it.
+ * @param order memory order of the fence (ATOMIC_ACQUIRE, ATOMIC_RELEASE, etc.)
+ */
+#define atomicSignalFence(order) __atomic_signal_fence(order)
+
+/***********************************************************************************************************************
+ * @brief Integer pair for the 128-bit atomic operations. (Pointer and tag, etc.)
+ */
+typedef struct __attribute__((aligned(16))) Int128
+{
+	int64_t low;
+	int64_t high;
+} Int128;
+
+#if defined(__x86_64__) || defined(__aarch64__)
+/**
+ * @brief 128-bit compare exchange is supported by the target CPU.
+ */
+#define MPMT_ATOMIC_INT128
+/**
+ * @brief Integer type for atomic operations. (int128)
+ */
+#define atomic_int128 volatile Int128
+
+/**
+ * @brief Atomically compares and exchanges the 128-bit value of the variable that memory points to.
+ * @details Available only if the MPMT_ATOMIC_INT128 is defined. Memory should be aligned to the 16 bytes.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange128(atomic_int128* memory, Int128* expected, Int128 desired)
+{
+	#if defined(__SANITIZE_THREAD__)
+	// Note: thread sanitizer can't see inline assembly, but its runtime provides 128-bit atomics.
+	__int128 value; __builtin_memcpy(&value, &desired, sizeof(Int128));
+	return __atomic_compare_exchange_n((volatile __int128*)memory, 
+		(__int128*)expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	#elif defined(__x86_64__)
+	bool result;
+	__asm__ __volatile__("lock cmpxchg16b %1\n\tsetz %0"
+		: "=q"(result), "+m"(*(Int128*)memory), "+a"(expected->low), "+d"(expected->high)
+		: "b"(desired.low), "c"(desired.high) : "memory", "cc");
+	return result;
+	#else
+	int64_t low, high; uint32_t status;
+	do
+	{
+		__asm__ __volatile__("ldaxp %0, %1, [%2]" : "=&r"(low), "=&r"(high) : "r"(memory) : "memory");
+		if (low != expected->low || high != expected->high)
+		{
+			// Note: storing loaded value back to make sure that it was read atomically.
+			__asm__ __volatile__("stlxp %w0, %2, %3, [%1]"
+				: "=&r"(status) : "r"(memory), "r"(low), "r"(high) : "memory");
+			if (status != 0)
+				continue;
+			expected->low = low; expected->high = high;
+			return false;
+		}
+		__asm__ __volatile__("stlxp %w0, %2, %3, [%1]"
+			: "=&r"(status) : "r"(memory), "r"(desired.low), "r"(desired.high) : "memory");
+	}
+	while (status != 0);
+	return true;
+	#endif
+}
+#endif
+
+/***********************************************************************************************************************
+ * @brief Pointer type for atomic operations.
+ */
+#define atomic_ptr void* volatile
+/**
+ * @brief Size type for atomic operations. (size_t)
+ */
+#define atomic_size volatile size_t
+
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadPtr(memory) __atomic_load_n(memory, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadExplicitPtr(memory, order) __atomic_load_n(memory, order)
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+#define atomicStorePtr(memory, value) __atomic_store_n(memory, value, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicStoreExplicitPtr(memory, value, order) __atomic_store_n(memory, value, order)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchangePtr(memory, value) __atomic_exchange_n(memory, value, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangePtr(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicitPtr(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+
+/***********************************************************************************************************************
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadSize(memory) __atomic_load_n(memory, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadExplicitSize(memory, order) __atomic_load_n(memory, order)
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+#define atomicStoreSize(memory, value) __atomic_store_n(memory, value, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicStoreExplicitSize(memory, value, order) __atomic_store_n(memory, value, order)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchangeSize(memory, value) __atomic_exchange_n(memory, value, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAddSize(memory, value) __atomic_fetch_add(memory, value, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicitSize(memory, value, order) __atomic_fetch_add(memory, value, order)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeSize(memory, expected, desired) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicitSize(memory, expected, desired, order) __atomic_compare_exchange_n(\
+	memory, expected, desired, false, order, atomicFailureOrder(order))
+
+#elif _WIN32
+#include <intrin.h>
+#include <windows.h>
+
+/***********************************************************************************************************************
+ * @brief Integer type for atomic operations. (int8)
+ */
+#define atomic_int8 volatile CHAR
+/**
+ * @brief Integer type for atomic operations. (int16)
+ */
+#define atomic_int16 volatile SHORT
+/**
+ * @brief Integer type for atomic operations. (int32)
+ */
+#define atomic_int32 volatile LONG
+/**
+ * @brief Integer type for atomic operations. (int64)
+ */
+#define atomic_int64 volatile LONG64
+
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int8 atomicLoad8(atomic_int8* memory)
+{
+	atomic_int8 value = *memory;
+	MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int16 atomicLoad16(atomic_int16* memory)
+{
+	atomic_int16 value = *memory;
+	MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int32 atomicLoad32(atomic_int32* memory)
+{
+	atomic_int32 value = *memory;
+	MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int64 atomicLoad64(atomic_int64* memory)
+{
+	atomic_int64 value = *memory;
+	MemoryBarrier();
+	return value;
+}
+
+/***********************************************************************************************************************
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+static inline void atomicStore8(atomic_int8* memory, atomic_int8 value)
+{
+	*memory = value;
+	MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+static inline void atomicStore16(atomic_int16* memory, atomic_int16 value)
+{
+	*memory = value;
+	MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+static inline void atomicStore32(atomic_int32* memory, atomic_int32 value)
+{
+	*memory = value;
+	MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+static inline void atomicStore64(atomic_int64* memory, atomic_int64 value)
+{
+	*memory = value;
+	MemoryBarrier();
+}
+
+/***********************************************************************************************************************
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchange8(memory, value) _InterlockedExchange8(memory, value)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchange16(memory, value) _InterlockedExchange16(memory, value)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchange32(memory, value) _InterlockedExchange(memory, value)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchange64(memory, value) _InterlockedExchange64(memory, value)
+
+/***********************************************************************************************************************
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ */
+#define atomicFetchAnd8(memory, value) _InterlockedAnd8(memory, value)
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ */
+#define atomicFetchAnd16(memory, value) _InterlockedAnd16(memory, value)
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ */
+#define atomicFetchAnd32(memory, value) _InterlockedAnd(memory, value)
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ */
+#define atomicFetchAnd64(memory, value) _InterlockedAnd64(memory, value)
+
+/***********************************************************************************************************************
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ */
+#define atomicFetchOr8(memory, value) _InterlockedOr8(memory, value)
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ */
+#define atomicFetchOr16(memory, value) _InterlockedOr16(memory, value)
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ */
+#define atomicFetchOr32(memory, value) _InterlockedOr(memory, value)
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ */
+#define atomicFetchOr64(memory, value) _InterlockedOr64(memory, value)
+
+/***********************************************************************************************************************
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ */
+#define atomicFetchXor8(memory, value) _InterlockedXor8(memory, value)
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ */
+#define atomicFetchXor16(memory, value) _InterlockedXor16(memory, value)
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ */
+#define atomicFetchXor32(memory, value) _InterlockedXor(memory, value)
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ */
+#define atomicFetchXor64(memory, value) _InterlockedXor64(memory, value)
+
+/***********************************************************************************************************************
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ * 
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAdd8(memory, value) _InterlockedExchangeAdd8(memory, value)
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ * 
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAdd16(memory, value) _InterlockedExchangeAdd16(memory, value)
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ * 
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAdd32(memory, value) _InterlockedExchangeAdd(memory, value)
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ * 
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAdd64(memory, value) _InterlockedExchangeAdd64(memory, value)
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange8(atomic_int8* memory, CHAR* expected, CHAR desired)
+{
+	CHAR comparand = *expected;
+	CHAR value = _InterlockedCompareExchange8(memory, desired, comparand);
+	if (value == comparand)
+		return true;
+	*expected = value;
+	return false;
+}
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange16(atomic_int16* memory, SHORT* expected, SHORT desired)
+{
+	SHORT comparand = *expected;
+	SHORT value = _InterlockedCompareExchange16(memory, desired, comparand);
+	if (value == comparand)
+		return true;
+	*expected = value;
+	return false;
+}
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange32(atomic_int32* memory, LONG* expected, LONG desired)
+{
+	LONG comparand = *expected;
+	LONG value = _InterlockedCompareExchange(memory, desired, comparand);
+	if (value == comparand)
+		return true;
+	*expected = value;
+	return false;
+}
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange64(atomic_int64* memory, LONG64* expected, LONG64 desired)
+{
+	LONG64 comparand = *expected;
+	LONG64 value = _InterlockedCompareExchange64(memory, desired, comparand);
+	if (value == comparand)
+		return true;
+	*expected = value;
+	return false;
+}
+
+/***********************************************************************************************************************
+ * @brief Relaxed memory order, only atomicity is guaranteed. (Statistics counters)
+ */
+#define ATOMIC_RELAXED 0
+/**
+ * @brief Acquire memory order, later memory operations can not be reordered before the load.
+ */
+#define ATOMIC_ACQUIRE 2
+/**
+ * @brief Release memory order, earlier memory operations can not be reordered after the store.
+ */
+#define ATOMIC_RELEASE 3
+/**
+ * @brief Acquire and release memory order, for the read-modify-write operations.
+ */
+#define ATOMIC_ACQ_REL 4
+/**
+ * @brief Sequentially consistent memory order, single total order of all operations. (Default)
+ */
+#define ATOMIC_SEQ_CST 5
+
+/***********************************************************************************************************************
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int8 atomicLoadExplicit8(atomic_int8* memory, int order)
+{
+	atomic_int8 value = *memory;
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int16 atomicLoadExplicit16(atomic_int16* memory, int order)
+{
+	atomic_int16 value = *memory;
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int32 atomicLoadExplicit32(atomic_int32* memory, int order)
+{
+	atomic_int32 value = *memory;
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+static inline atomic_int64 atomicLoadExplicit64(atomic_int64* memory, int order)
+{
+	atomic_int64 value = *memory;
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	return value;
+}
+
+/***********************************************************************************************************************
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+static inline void atomicStoreExplicit8(atomic_int8* memory, atomic_int8 value, int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	*memory = value;
+	if (order == ATOMIC_SEQ_CST)
+		MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+static inline void atomicStoreExplicit16(atomic_int16* memory, atomic_int16 value, int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	*memory = value;
+	if (order == ATOMIC_SEQ_CST)
+		MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+static inline void atomicStoreExplicit32(atomic_int32* memory, atomic_int32 value, int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	*memory = value;
+	if (order == ATOMIC_SEQ_CST)
+		MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+static inline void atomicStoreExplicit64(atomic_int64* memory, atomic_int64 value, int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	*memory = value;
+	if (order == ATOMIC_SEQ_CST)
+		MemoryBarrier();
+}
+
+/***********************************************************************************************************************
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @note Interlocked operations are always sequentially consistent on Windows.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicExchangeExplicit8(memory, value, order) ((void)(order), atomicExchange8(memory, value))
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicExchangeExplicit16(memory, value, order) ((void)(order), atomicExchange16(memory, value))
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicExchangeExplicit32(memory, value, order) ((void)(order), atomicExchange32(memory, value))
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicExchangeExplicit64(memory, value, order) ((void)(order), atomicExchange64(memory, value))
+
+/***********************************************************************************************************************
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @note Interlocked operations are always sequentially consistent on Windows.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAndExplicit8(memory, value, order) ((void)(order), atomicFetchAnd8(memory, value))
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAndExplicit16(memory, value, order) ((void)(order), atomicFetchAnd16(memory, value))
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAndExplicit32(memory, value, order) ((void)(order), atomicFetchAnd32(memory, value))
+/**
+ * @brief Atomically performs AND operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the AND operation is to be performed
+ * @param value variable whose value is to be used for an AND operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAndExplicit64(memory, value, order) ((void)(order), atomicFetchAnd64(memory, value))
+
+/***********************************************************************************************************************
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @note Interlocked operations are always sequentially consistent on Windows.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchOrExplicit8(memory, value, order) ((void)(order), atomicFetchOr8(memory, value))
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchOrExplicit16(memory, value, order) ((void)(order), atomicFetchOr16(memory, value))
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchOrExplicit32(memory, value, order) ((void)(order), atomicFetchOr32(memory, value))
+/**
+ * @brief Atomically performs OR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the OR operation is to be performed
+ * @param value variable whose value is to be used for an OR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchOrExplicit64(memory, value, order) ((void)(order), atomicFetchOr64(memory, value))
+
+/***********************************************************************************************************************
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @note Interlocked operations are always sequentially consistent on Windows.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchXorExplicit8(memory, value, order) ((void)(order), atomicFetchXor8(memory, value))
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchXorExplicit16(memory, value, order) ((void)(order), atomicFetchXor16(memory, value))
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchXorExplicit32(memory, value, order) ((void)(order), atomicFetchXor32(memory, value))
+/**
+ * @brief Atomically performs XOR operation to the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the XOR operation is to be performed
+ * @param value variable whose value is to be used for an XOR operation
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchXorExplicit64(memory, value, order) ((void)(order), atomicFetchXor64(memory, value))
+
+/***********************************************************************************************************************
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @note Interlocked operations are always sequentially consistent on Windows.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicit8(memory, value, order) ((void)(order), atomicFetchAdd8(memory, value))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicit16(memory, value, order) ((void)(order), atomicFetchAdd16(memory, value))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicit32(memory, value, order) ((void)(order), atomicFetchAdd32(memory, value))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicit64(memory, value, order) ((void)(order), atomicFetchAdd64(memory, value))
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak8(memory, expected, desired) atomicCompareExchange8(memory, expected, desired)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak16(memory, expected, desired) atomicCompareExchange16(memory, expected, desired)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak32(memory, expected, desired) atomicCompareExchange32(memory, expected, desired)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeWeak64(memory, expected, desired) atomicCompareExchange64(memory, expected, desired)
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit8(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange8(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit16(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange16(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit32(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange32(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicit64(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange64(memory, expected, desired))
+
+/***********************************************************************************************************************
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit8(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange8(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit16(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange16(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit32(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange32(memory, expected, desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @details Weak version is allowed to fail spuriously, use it inside the retry loops.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeWeakExplicit64(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchange64(memory, expected, desired))
+
+/***********************************************************************************************************************
+ * @brief Memory fence, orders memory operations between threads without an associated atomic operation.
+ * @param order memory order of the fence (ATOMIC_ACQUIRE, ATOMIC_RELEASE, etc.)
+ */
+static inline void atomicThreadFence(int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+}
+/**
+ * @brief Compiler only fence, orders memory operations between a thread and a signal handler executed on it.
+ * @param order memory order of the fence (ATOMIC_ACQUIRE, ATOMIC_RELEASE, etc.)
+ */
+static inline void atomicSignalFence(int order)
+{
+	if (order != ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+}
+
+/***********************************************************************************************************************
+ * @brief Integer pair for the 128-bit atomic operations. (Pointer and tag, etc.)
+ */
+typedef struct __declspec(align(16)) Int128
+{
+	LONG64 low;
+	LONG64 high;
+} Int128;
+
+#if defined(_M_X64) || defined(_M_ARM64)
+/**
+ * @brief 128-bit compare exchange is supported by the target CPU.
+ */
+#define MPMT_ATOMIC_INT128
+/**
+ * @brief Integer type for atomic operations. (int128)
+ */
+#define atomic_int128 volatile Int128
+
+/**
+ * @brief Atomically compares and exchanges the 128-bit value of the variable that memory points to.
+ * @details Available only if the MPMT_ATOMIC_INT128 is defined. Memory should be aligned to the 16 bytes.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchange128(atomic_int128* memory, Int128* expected, Int128 desired)
+{
+	return _InterlockedCompareExchange128((volatile LONG64*)memory,
+		desired.high, desired.low, (LONG64*)expected) != 0;
+}
+#endif
+
+/***********************************************************************************************************************
+ * @brief Pointer type for atomic operations.
+ */
+#define atomic_ptr void* volatile
+/**
+ * @brief Size type for atomic operations. (size_t)
+ */
+#define atomic_size volatile SIZE_T
+
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+static inline void* atomicLoadPtr(atomic_ptr* memory)
+{
+	void* value = *memory;
+	MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+static inline void* atomicLoadExplicitPtr(atomic_ptr* memory, int order)
+{
+	void* value = *memory;
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	return value;
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+static inline void atomicStorePtr(atomic_ptr* memory, void* value)
+{
+	*memory = value;
+	MemoryBarrier();
+}
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+static inline void atomicStoreExplicitPtr(atomic_ptr* memory, void* value, int order)
+{
+	if (order != ATOMIC_RELAXED)
+		MemoryBarrier();
+	*memory = value;
+	if (order == ATOMIC_SEQ_CST)
+		MemoryBarrier();
+}
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchangePtr(memory, value) InterlockedExchangePointer((PVOID volatile*)(memory), value)
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchangePtr(atomic_ptr* memory, void** expected, void* desired)
+{
+	void* comparand = *expected;
+	void* value = InterlockedCompareExchangePointer((PVOID volatile*)memory, desired, comparand);
+	if (value == comparand)
+		return true;
+	*expected = value;
+	return false;
+}
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicitPtr(memory, expected, desired, order) \
+	((void)(order), atomicCompareExchangePtr(memory, expected, desired))
+
+#if _WIN64
+/***********************************************************************************************************************
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadSize(memory) ((size_t)atomicLoad64((atomic_int64*)(memory)))
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadExplicitSize(memory, order) ((size_t)atomicLoadExplicit64((atomic_int64*)(memory), order))
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+#define atomicStoreSize(memory, value) atomicStore64((atomic_int64*)(memory), (LONG64)(value))
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicStoreExplicitSize(memory, value, order) \
+	atomicStoreExplicit64((atomic_int64*)(memory), (LONG64)(value), order)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchangeSize(memory, value) ((size_t)atomicExchange64((atomic_int64*)(memory), (LONG64)(value)))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAddSize(memory, value) ((size_t)atomicFetchAdd64((atomic_int64*)(memory), (LONG64)(value)))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicitSize(memory, value, order) \
+	((void)(order), ((size_t)atomicFetchAdd64((atomic_int64*)(memory), (LONG64)(value))))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeSize(memory, expected, desired) atomicCompareExchange64(\
+	(atomic_int64*)(memory), (LONG64*)(expected), (LONG64)(desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicitSize(memory, expected, desired, order) ((void)(order), atomicCompareExchange64(\
+	(atomic_int64*)(memory), (LONG64*)(expected), (LONG64)(desired)))
+#else
+/***********************************************************************************************************************
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadSize(memory) ((size_t)atomicLoad32((atomic_int32*)(memory)))
+/**
+ * @brief Atomically loads the value from the variable that memory points to.
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ * @return The current value of the variable that memory points to.
+ */
+#define atomicLoadExplicitSize(memory, order) ((size_t)atomicLoadExplicit32((atomic_int32*)(memory), order))
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ */
+#define atomicStoreSize(memory, value) atomicStore32((atomic_int32*)(memory), (LONG)(value))
+/**
+ * @brief Atomically stores the value to the variable that memory points to.
+ *
+ * @param[out] memory pointer of a variable to which the value is to be stored
+ * @param value variable whose value is to be stored to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicStoreExplicitSize(memory, value, order) \
+	atomicStoreExplicit32((atomic_int32*)(memory), (LONG)(value), order)
+/**
+ * @brief Atomically exchanges the value of the variable that memory points to.
+ * @return The current value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be written
+ * @param value variable whose value is to be written to the variable that memory points to
+ */
+#define atomicExchangeSize(memory, value) ((size_t)atomicExchange32((atomic_int32*)(memory), (LONG)(value)))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ */
+#define atomicFetchAddSize(memory, value) ((size_t)atomicFetchAdd32((atomic_int32*)(memory), (LONG)(value)))
+/**
+ * @brief Atomically adds the value to the variable that memory points to.
+ * @return The initial value of the variable that memory points to.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be added
+ * @param value variable whose value is to be added to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicFetchAddExplicitSize(memory, value, order) \
+	((void)(order), ((size_t)atomicFetchAdd32((atomic_int32*)(memory), (LONG)(value))))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ */
+#define atomicCompareExchangeSize(memory, expected, desired) atomicCompareExchange32(\
+	(atomic_int32*)(memory), (LONG*)(expected), (LONG)(desired))
+/**
+ * @brief Atomically compares and exchanges the value of the variable that memory points to.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired variable whose value is to be written to the variable that memory points to
+ * @param order memory order of the operation (ATOMIC_RELAXED, ATOMIC_ACQUIRE, etc.)
+ */
+#define atomicCompareExchangeExplicitSize(memory, expected, desired, order) ((void)(order), atomicCompareExchange32(\
+	(atomic_int32*)(memory), (LONG*)(expected), (LONG)(desired)))
+#endif
+
+#else
+#error Unknown operating system
+#endif
+
+#if defined(MPMT_ATOMIC_INT128)
+/***********************************************************************************************************************
+ * @brief Tagged pointer support, pointer and counter are compared and exchanged together.
+ */
+#define MPMT_ATOMIC_TAGGED_PTR
+
+/**
+ * @brief Pointer with the modification counter. (ABA-safe)
+ * @details Each successful compare exchange increments the tag, so that the same pointer pushed back by another
+ *          thread in the meantime (ABA problem) is still detected as a change.
+ */
+typedef union TaggedPtr
+{
+	struct
+	{
+		void* ptr;
+		uint64_t tag;
+	};
+	Int128 value;
+} TaggedPtr;
+
+/**
+ * @brief Tagged pointer type for atomic operations.
+ */
+#define atomic_tagged_ptr volatile TaggedPtr
+
+/**
+ * @brief Loads the tagged pointer value from the variable that memory points to.
+ * @details Tag is loaded before the pointer, the pair can be torn, but then the following compare exchange fails.
+ * 
+ * @param[in] memory pointer of a variable from which the value is to be loaded
+ * @return The current tagged pointer value.
+ */
+static inline TaggedPtr atomicLoadTaggedPtr(atomic_tagged_ptr* memory)
+{
+	TaggedPtr value;
+	value.tag = (uint64_t)atomicLoad64((atomic_int64*)&memory->value.high);
+	value.ptr = (void*)atomicLoad64((atomic_int64*)&memory->value.low);
+	return value;
+}
+/**
+ * @brief Atomically compares and exchanges the tagged pointer, incrementing its tag.
+ * @return True if the value was exchanged, otherwise false and expected is updated with the current value.
+ *
+ * @param[in,out] memory pointer of a variable to which the value is to be compared and written
+ * @param[in,out] expected pointer of a variable whose value is to be compared and updated on failure
+ * @param desired pointer which is to be written to the variable that memory points to
+ */
+static inline bool atomicCompareExchangeTaggedPtr(atomic_tagged_ptr* memory, TaggedPtr* expected, void* desired)
+{
+	TaggedPtr value;
+	value.ptr = desired;
+	value.tag = expected->tag + 1;
+	return atomicCompareExchange128((atomic_int128*)memory, &expected->value, value.value);
+}
 #endif
\ No newline at end of file
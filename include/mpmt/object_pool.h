@@ -0,0 +1,101 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief Object pool functions.
+ * 
+ * @details
+ * A fixed-size object allocator for the short-lived objects, that are allocated on one thread and freed on another 
+ * (task arguments, messages, etc.). Each thread works with its own cache of free objects, so that the most 
+ * allocations and frees don't touch any shared memory. When the cache is empty or too big, free objects are moved 
+ * between the cache and the lock-free global freelist in batches. Memory is allocated in blocks and returned to 
+ * the system only when the pool is destroyed.
+ */
+
+#pragma once
+#include <stddef.h>
+
+/**
+ * @brief Object count moved between the thread cache and the global freelist at once.
+ */
+#define OBJECT_POOL_BATCH_SIZE 32
+/**
+ * @brief Object pool object alignment in bytes.
+ */
+#define OBJECT_POOL_ALIGNMENT 16
+
+/**
+ * @brief Object pool structure.
+ */
+typedef struct ObjectPool_T ObjectPool_T;
+/**
+ * @brief Object pool instance.
+ */
+typedef ObjectPool_T* ObjectPool;
+
+/**
+ * @brief Creates a new object pool instance.
+ * @note You should destroy created object pool instance manually.
+ * 
+ * @param objectSize size of the one object in bytes
+ * @param blockCapacity object count allocated at once, when the pool runs out of free objects
+ * 
+ * @return Object pool instance on success, otherwise NULL.
+ */
+ObjectPool createObjectPool(size_t objectSize, size_t blockCapacity);
+
+/**
+ * @brief Destroys object pool instance and all allocated objects.
+ * @warning Pool should not be used by other threads during destruction.
+ * @param objectPool object pool instance or NULL
+ */
+void destroyObjectPool(ObjectPool objectPool);
+
+/**
+ * @brief Returns object pool object size in bytes. (Rounded up to the alignment)
+ * @param objectPool object pool instance
+ */
+size_t getObjectPoolObjectSize(ObjectPool objectPool);
+
+/**
+ * @brief Returns object pool block capacity.
+ * @param objectPool object pool instance
+ */
+size_t getObjectPoolBlockCapacity(ObjectPool objectPool);
+
+/**
+ * @brief Returns total object count allocated by the object pool, used and free.
+ * @param objectPool object pool instance
+ */
+size_t getObjectPoolCapacity(ObjectPool objectPool);
+
+/***********************************************************************************************************************
+ * @brief Allocates a new object from the object pool.
+ * @details Object content is undefined. Thread safe, object can be freed on any thread.
+ * 
+ * @param objectPool object pool instance
+ * @return Pointer to the object memory on success, otherwise NULL.
+ */
+void* allocateObjectPoolObject(ObjectPool objectPool);
+
+/**
+ * @brief Returns allocated object back to the object pool.
+ * @details Thread safe, object can be allocated on any thread.
+ * @warning Object should be allocated from the same pool.
+ * 
+ * @param objectPool object pool instance
+ * @param[in] object pointer to the object memory or NULL
+ */
+void freeObjectPoolObject(ObjectPool objectPool, void* object);
@@ -0,0 +1,94 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief Lock-free queue functions.
+ * 
+ * @details
+ * A bounded multi-producer multi-consumer queue, based on the sequence numbered ring buffer (Vyukov queue). 
+ * Each cell of the ring has a sequence number, which tells producers and consumers whether the cell is free 
+ * or filled for the current lap. Producers and consumers claim cells with a single compare exchange, so threads 
+ * never block each other and a preempted thread can't stall the whole queue with a held lock.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Lock-free queue structure.
+ */
+typedef struct LockFreeQueue_T LockFreeQueue_T;
+/**
+ * @brief Lock-free queue instance.
+ */
+typedef LockFreeQueue_T* LockFreeQueue;
+
+/**
+ * @brief Creates a new lock-free queue instance.
+ * @note You should destroy created lock-free queue instance manually.
+ * 
+ * @param capacity maximal queue item count (rounded up to the power of two)
+ * @param itemSize size of the one queue item in bytes
+ * 
+ * @return Lock-free queue instance on success, otherwise NULL.
+ */
+LockFreeQueue createLockFreeQueue(size_t capacity, size_t itemSize);
+
+/**
+ * @brief Destroys lock-free queue instance.
+ * @warning Queue should not be used by other threads during destruction.
+ * @param queue lock-free queue instance or NULL
+ */
+void destroyLockFreeQueue(LockFreeQueue queue);
+
+/**
+ * @brief Returns lock-free queue capacity.
+ * @param queue lock-free queue instance
+ */
+size_t getLockFreeQueueCapacity(LockFreeQueue queue);
+
+/**
+ * @brief Returns lock-free queue item size in bytes.
+ * @param queue lock-free queue instance
+ */
+size_t getLockFreeQueueItemSize(LockFreeQueue queue);
+
+/**
+ * @brief Returns approximate lock-free queue item count.
+ * @details Value can be outdated by the time it is returned, if other threads are using the queue.
+ * @param queue lock-free queue instance
+ */
+size_t getLockFreeQueueSize(LockFreeQueue queue);
+
+/***********************************************************************************************************************
+ * @brief Pushes a new item to the lock-free queue end, if enough space.
+ * 
+ * @param queue lock-free queue instance
+ * @param[in] item pointer to the item data to copy
+ * 
+ * @return True if item successfully pushed, otherwise false.
+ */
+bool tryPushLockFreeQueue(LockFreeQueue queue, const void* item);
+
+/**
+ * @brief Pops an item from the lock-free queue front, if not empty.
+ * 
+ * @param queue lock-free queue instance
+ * @param[out] item pointer to the item data to copy to
+ * 
+ * @return True if item successfully popped, otherwise false.
+ */
+bool tryPopLockFreeQueue(LockFreeQueue queue, void* item);
@@ -0,0 +1,198 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief Spinlock and ticket lock functions.
+ * 
+ * @details
+ * Lightweight busy-waiting locks for the very short critical sections (a few dozen instructions), where the 
+ * sleeping @ref Mutex is too heavy. Locks are plain structures, that can be embedded next to the protected data 
+ * and are initialized with zeros. Waiting threads are spinning with the CPU pause hint and exponential backoff,
+ * and yield the rest of the time slice when the lock is held for too long.
+ */
+
+#pragma once
+#include "mpmt/atomic.h"
+#include "mpmt/thread.h"
+
+/**
+ * @brief Maximal number of pause hints between two spinlock checks.
+ */
+#define SPINLOCK_MAX_BACKOFF 1024
+/**
+ * @brief Number of pause hints per ticket ahead of the waiting thread.
+ */
+#define TICKET_LOCK_BACKOFF 32
+/**
+ * @brief Maximal number of pause hints before the ticket lock waiter starts yielding.
+ */
+#define TICKET_LOCK_MAX_SPIN 256
+
+/**
+ * @brief Spinlock structure. (Test-and-test-and-set)
+ * @details Not fair, but has the lowest overhead when uncontended.
+ */
+typedef struct Spinlock
+{
+	atomic_int32 isLocked;
+} Spinlock;
+
+/**
+ * @brief Ticket lock structure. (Fair, FIFO order)
+ * @details Each thread takes a ticket and waits until it is served, so that threads acquire the lock in order.
+ *          Degrades when there are more waiting threads than CPUs, because the next owner can be preempted.
+ */
+typedef struct TicketLock
+{
+	atomic_int64 nextTicket;
+	atomic_int64 currentTicket;
+} TicketLock;
+
+/**
+ * @brief Hints the CPU that the thread is spinning in a busy-wait loop.
+ * @details Reduces power usage and memory order violation penalties, and frees resources for the sibling SMT thread.
+ */
+static inline void spinPause()
+{
+	#if _WIN32
+	YieldProcessor();
+	#elif defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+	#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+	#endif
+}
+
+/***********************************************************************************************************************
+ * @brief Initializes spinlock in the unlocked state.
+ * @param[out] spinlock spinlock instance
+ */
+static inline void initSpinlock(Spinlock* spinlock)
+{
+	atomicStore32(&spinlock->isLocked, 0);
+}
+
+/**
+ * @brief Tries to lock the spinlock.
+ * @param[in,out] spinlock spinlock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+static inline bool tryLockSpinlock(Spinlock* spinlock)
+{
+	return atomicLoadExplicit32(&spinlock->isLocked, ATOMIC_RELAXED) == 0 &&
+		atomicExchangeExplicit32(&spinlock->isLocked, 1, ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * @brief Locks the spinlock, spins if the spinlock is not available.
+ * @warning If lock is called by a thread that already owns the spinlock, it will deadlock.
+ * @param[in,out] spinlock spinlock instance
+ */
+static inline void lockSpinlock(Spinlock* spinlock)
+{
+	uint32_t backoff = 1;
+	while (atomicExchangeExplicit32(&spinlock->isLocked, 1, ATOMIC_ACQUIRE) != 0)
+	{
+		// Note: waiting on the shared cache line copy, exchange is retried only when the lock looks free.
+		do
+		{
+			for (uint32_t i = 0; i < backoff; i++)
+				spinPause();
+
+			if (backoff < SPINLOCK_MAX_BACKOFF)
+				backoff <<= 1;
+			else
+				yieldThread();
+		}
+		while (atomicLoadExplicit32(&spinlock->isLocked, ATOMIC_RELAXED) != 0);
+	}
+}
+
+/**
+ * @brief Unlocks locked spinlock.
+ * @warning The spinlock must be locked by the current thread, otherwise, the behavior is undefined.
+ * @param[in,out] spinlock spinlock instance
+ */
+static inline void unlockSpinlock(Spinlock* spinlock)
+{
+	atomicStoreExplicit32(&spinlock->isLocked, 0, ATOMIC_RELEASE);
+}
+
+/***********************************************************************************************************************
+ * @brief Initializes ticket lock in the unlocked state.
+ * @param[out] ticketLock ticket lock instance
+ */
+static inline void initTicketLock(TicketLock* ticketLock)
+{
+	atomicStore64(&ticketLock->nextTicket, 0);
+	atomicStore64(&ticketLock->currentTicket, 0);
+}
+
+/**
+ * @brief Tries to lock the ticket lock.
+ * @details Succeeds only if there is no owner and no waiting threads.
+ * 
+ * @param[in,out] ticketLock ticket lock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+static inline bool tryLockTicketLock(TicketLock* ticketLock)
+{
+	int64_t currentTicket = atomicLoadExplicit64(&ticketLock->currentTicket, ATOMIC_ACQUIRE);
+	int64_t nextTicket = currentTicket;
+	return atomicCompareExchangeExplicit64(&ticketLock->nextTicket, &nextTicket, currentTicket + 1, ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Locks the ticket lock, spins until all previous threads are served.
+ * @warning If lock is called by a thread that already owns the ticket lock, it will deadlock.
+ * @param[in,out] ticketLock ticket lock instance
+ */
+static inline void lockTicketLock(TicketLock* ticketLock)
+{
+	int64_t ticket = atomicFetchAddExplicit64(&ticketLock->nextTicket, 1, ATOMIC_RELAXED);
+	uint32_t spinCount = 0;
+
+	while (true)
+	{
+		int64_t distance = ticket - atomicLoadExplicit64(&ticketLock->currentTicket, ATOMIC_ACQUIRE);
+		if (distance == 0)
+			return;
+
+		// Note: ticket lock collapses if the next owner is preempted, so waiters yield after a short spin.
+		if (spinCount >= TICKET_LOCK_MAX_SPIN)
+		{
+			yieldThread();
+			continue;
+		}
+
+		// Note: backoff is proportional to the queue position, so that waiters do not hammer the cache line.
+		uint32_t backoff = (uint32_t)distance * TICKET_LOCK_BACKOFF;
+		for (uint32_t i = 0; i < backoff; i++)
+			spinPause();
+		spinCount += backoff;
+	}
+}
+
+/**
+ * @brief Unlocks locked ticket lock, passing it to the next waiting thread.
+ * @warning The ticket lock must be locked by the current thread, otherwise, the behavior is undefined.
+ * @param[in,out] ticketLock ticket lock instance
+ */
+static inline void unlockTicketLock(TicketLock* ticketLock)
+{
+	// Note: only the owner thread modifies the current ticket.
+	int64_t currentTicket = atomicLoadExplicit64(&ticketLock->currentTicket, ATOMIC_RELAXED);
+	atomicStoreExplicit64(&ticketLock->currentTicket, currentTicket + 1, ATOMIC_RELEASE);
+}
\ No newline at end of file
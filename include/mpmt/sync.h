@@ -14,6 +14,8 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /***********************************************************************************************************************
  * @file
@@ -24,10 +26,26 @@
  * shared resources, preventing race conditions, and ensuring thread safety.
  */
 
+/**
+ * @brief Mutex storage size in bytes, the same on all platforms.
+ */
+#define MUTEX_STORAGE_SIZE 72
+/**
+ * @brief Condition variable storage size in bytes, the same on all platforms.
+ */
+#define COND_STORAGE_SIZE 48
+
 /**
  * @brief Mutual exclusion structure.
+ * 
+ * @details
+ * Opaque storage that can be embedded directly into the user structures and arrays. 
+ * Embedded mutex should be initialized with the @ref initMutex() and deinitialized with the @ref deinitMutex().
  */
-typedef struct Mutex_T Mutex_T;
+typedef struct Mutex_T
+{
+	uint64_t _storage[MUTEX_STORAGE_SIZE / sizeof(uint64_t)];
+} Mutex_T;
 /**
  * @brief Mutual exclusion instance.
  */
@@ -35,13 +53,50 @@ typedef Mutex_T* Mutex;
 
 /**
  * @brief Condition variable structure.
+ * 
+ * @details
+ * Opaque storage that can be embedded directly into the user structures and arrays. 
+ * Embedded cond should be initialized with the @ref initCond() and deinitialized with the @ref deinitCond().
  */
-typedef struct Cond_T Cond_T;
+typedef struct Cond_T
+{
+	uint64_t _storage[COND_STORAGE_SIZE / sizeof(uint64_t)];
+} Cond_T;
 /**
  * @brief Condition variable instance.
  */
 typedef Cond_T* Cond;
 
+/**
+ * @brief Reader-writer lock storage size in bytes, the same on all platforms.
+ */
+#define RW_LOCK_STORAGE_SIZE 200
+
+/**
+ * @brief Reader-writer lock structure.
+ * 
+ * @details
+ * Opaque storage that can be embedded directly into the user structures and arrays. 
+ * Embedded lock should be initialized with the @ref initRwLock() and deinitialized with the @ref deinitRwLock().
+ */
+typedef struct RwLock_T
+{
+	uint64_t _storage[RW_LOCK_STORAGE_SIZE / sizeof(uint64_t)];
+} RwLock_T;
+/**
+ * @brief Reader-writer lock instance.
+ */
+typedef RwLock_T* RwLock;
+
+/**
+ * @brief Distributed reader-writer lock structure.
+ */
+typedef struct DistRwLock_T DistRwLock_T;
+/**
+ * @brief Distributed reader-writer lock instance.
+ */
+typedef DistRwLock_T* DistRwLock;
+
 /**
  * @brief Create a new mutex instance.
  * @note You should destroy created mutex instance manually.
@@ -60,6 +115,23 @@ Mutex createMutex();
  */
 void destroyMutex(Mutex mutex);
 
+/**
+ * @brief Initializes embedded mutex storage.
+ * @note You should deinitialize initialized mutex manually.
+ * @details Same as the @ref createMutex(), but without the memory allocation.
+ * 
+ * @param[out] mutex mutex storage
+ * @return True on success, otherwise false.
+ */
+bool initMutex(Mutex mutex);
+
+/**
+ * @brief Deinitializes embedded mutex storage.
+ * @warning The mutex should be unlocked.
+ * @param mutex mutex storage
+ */
+void deinitMutex(Mutex mutex);
+
 /***********************************************************************************************************************
  * @brief Locks the mutex, blocks if the mutex is not available.
  * 
@@ -94,6 +166,7 @@ bool tryLockMutex(Mutex mutex);
 
 /**
  * @brief Returns pointer to the native mutex handle.
+ * @details On Linux it is a pthread_mutex_t, or an int32_t futex word if built with the MPMT_USE_FUTEX.
  * @warning You should not free returned pointer or use it after mutex destruction.
  *
  * @param mutex mutex instance
@@ -118,6 +191,23 @@ Cond createCond();
  */
 void destroyCond(Cond cond);
 
+/**
+ * @brief Initializes embedded condition variable storage.
+ * @note You should deinitialize initialized condition variable manually.
+ * @details Same as the @ref createCond(), but without the memory allocation.
+ * 
+ * @param[out] cond condition variable storage
+ * @return True on success, otherwise false.
+ */
+bool initCond(Cond cond);
+
+/**
+ * @brief Deinitializes embedded condition variable storage.
+ * @warning There should be no waiting threads.
+ * @param cond condition variable storage
+ */
+void deinitCond(Cond cond);
+
 /**
  * @brief Notifies one waiting thread.
  * @details If any threads are waiting on this cond, calling signal() unblocks one of the waiting threads.
@@ -157,8 +247,161 @@ void waitCondFor(Cond cond, Mutex mutex, double timeout);
 
 /**
  * @brief Returns pointer to the native condition variable handle.
+ * @details On Linux it is a pthread_cond_t, or an int32_t futex word if built with the MPMT_USE_FUTEX.
  * @warning You should not free returned pointer or use it after cond destruction.
  *
  * @param cond condition variable instance
  */
-const void* getCondNative(Cond cond);
\ No newline at end of file
+const void* getCondNative(Cond cond);
+
+/***********************************************************************************************************************
+ * @brief Create a new reader-writer lock instance.
+ * @note You should destroy created reader-writer lock instance manually.
+ * 
+ * @details
+ * The reader-writer lock allows multiple threads to read shared data simultaneously, 
+ * while the write access is exclusive. Writers are preferred: once a writer is waiting, 
+ * new readers are blocked until it finishes, so that writers are not starved by the constant reads.
+ *  
+ * @return A new reader-writer lock instance on success, otherwise NULL.
+ */
+RwLock createRwLock();
+
+/**
+ * @brief Destroys reader-writer lock instance.
+ * @param rwLock reader-writer lock instance or NULL
+ */
+void destroyRwLock(RwLock rwLock);
+
+/**
+ * @brief Initializes embedded reader-writer lock storage.
+ * @note You should deinitialize initialized reader-writer lock manually.
+ * @details Same as the @ref createRwLock(), but without the memory allocation.
+ * 
+ * @param[out] rwLock reader-writer lock storage
+ * @return True on success, otherwise false.
+ */
+bool initRwLock(RwLock rwLock);
+
+/**
+ * @brief Deinitializes embedded reader-writer lock storage.
+ * @warning The reader-writer lock should be unlocked.
+ * @param rwLock reader-writer lock storage
+ */
+void deinitRwLock(RwLock rwLock);
+
+/**
+ * @brief Locks the reader-writer lock for reading, blocks if it is locked for writing.
+ * @warning If the current thread already owns the lock, the behavior is undefined.
+ * @param rwLock reader-writer lock instance
+ */
+void readLockRwLock(RwLock rwLock);
+
+/**
+ * @brief Unlocks reader-writer lock locked for reading.
+ * @param rwLock reader-writer lock instance
+ */
+void readUnlockRwLock(RwLock rwLock);
+
+/**
+ * @brief Tries to lock the reader-writer lock for reading.
+ * @details This function is allowed to fail spuriously.
+ *
+ * @param rwLock reader-writer lock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+bool tryReadLockRwLock(RwLock rwLock);
+
+/**
+ * @brief Locks the reader-writer lock for writing, blocks until all readers and writers are finished.
+ * @warning If the current thread already owns the lock, the behavior is undefined.
+ * @param rwLock reader-writer lock instance
+ */
+void writeLockRwLock(RwLock rwLock);
+
+/**
+ * @brief Unlocks reader-writer lock locked for writing.
+ * @param rwLock reader-writer lock instance
+ */
+void writeUnlockRwLock(RwLock rwLock);
+
+/**
+ * @brief Tries to lock the reader-writer lock for writing.
+ * @details This function is allowed to fail spuriously.
+ *
+ * @param rwLock reader-writer lock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+bool tryWriteLockRwLock(RwLock rwLock);
+
+/***********************************************************************************************************************
+ * @brief Create a new distributed reader-writer lock instance.
+ * @note You should destroy created distributed reader-writer lock instance manually.
+ * 
+ * @details
+ * Scalable reader-writer lock for the read-mostly data. Each reader increments only its own cache line 
+ * padded slot counter, so that readers on different cores do not bounce the same cache line. Writers 
+ * are exclusive, they block new readers and sweep all slots, so writing is much slower than with @ref RwLock.
+ * Threads are assigned to the slots in a round-robin order on the first use.
+ *
+ * @param slotCount reader slot count, or 0 to use the logical CPU count
+ * @return A new distributed reader-writer lock instance on success, otherwise NULL.
+ */
+DistRwLock createDistRwLock(size_t slotCount);
+
+/**
+ * @brief Destroys distributed reader-writer lock instance.
+ * @param distRwLock distributed reader-writer lock instance or NULL
+ */
+void destroyDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Returns distributed reader-writer lock reader slot count.
+ * @param distRwLock distributed reader-writer lock instance
+ */
+size_t getDistRwLockSlotCount(DistRwLock distRwLock);
+
+/**
+ * @brief Locks the distributed reader-writer lock for reading, blocks if it is locked for writing.
+ * @warning If the current thread already owns the lock, the behavior is undefined.
+ * @param distRwLock distributed reader-writer lock instance
+ */
+void readLockDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Unlocks distributed reader-writer lock locked for reading.
+ * @warning Should be called from the same thread that has locked it.
+ * @param distRwLock distributed reader-writer lock instance
+ */
+void readUnlockDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Tries to lock the distributed reader-writer lock for reading.
+ * @details This function is allowed to fail spuriously.
+ *
+ * @param distRwLock distributed reader-writer lock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+bool tryReadLockDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Locks the distributed reader-writer lock for writing, blocks until all readers and writers are finished.
+ * @warning If the current thread already owns the lock, the behavior is undefined.
+ * @param distRwLock distributed reader-writer lock instance
+ */
+void writeLockDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Unlocks distributed reader-writer lock locked for writing.
+ * @param distRwLock distributed reader-writer lock instance
+ */
+void writeUnlockDistRwLock(DistRwLock distRwLock);
+
+/**
+ * @brief Tries to lock the distributed reader-writer lock for writing.
+ * @details This function is allowed to fail spuriously.
+ *
+ * @param distRwLock distributed reader-writer lock instance
+ * @return True on successful lock acquisition, otherwise false. 
+ */
+bool tryWriteLockDistRwLock(DistRwLock distRwLock);
\ No newline at end of file
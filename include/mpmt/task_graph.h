@@ -0,0 +1,131 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief Task graph functions.
+ *
+ * @details
+ * A task graph is a directed acyclic graph of the thread pool tasks, that is declared once and executed
+ * many times. Each node has an atomic counter of the not completed predecessors, the node task is added
+ * to the thread pool the moment the counter reaches zero, so there are no barriers between the graph levels.
+ * Successor lists are built on the first run after the graph change, the next runs don't allocate memory.
+ */
+
+#pragma once
+#include "mpmt/thread_pool.h"
+
+/**
+ * @brief Task graph structure.
+ */
+typedef struct TaskGraph_T TaskGraph_T;
+/**
+ * @brief Task graph instance.
+ */
+typedef TaskGraph_T* TaskGraph;
+
+/**
+ * @brief Creates a new empty task graph instance.
+ * @note You should destroy created task graph instance manually.
+ *
+ * @param threadPool thread pool instance, that executes graph tasks
+ * @return Task graph instance on success, otherwise NULL.
+ */
+TaskGraph createTaskGraph(ThreadPool threadPool);
+
+/**
+ * @brief Destroys task graph instance. (Blocking)
+ * @details Waits for the task graph run completion before destroying.
+ * @param taskGraph task graph instance or NULL
+ */
+void destroyTaskGraph(TaskGraph taskGraph);
+
+/**
+ * @brief Returns task graph thread pool instance.
+ * @param taskGraph task graph instance
+ */
+ThreadPool getTaskGraphThreadPool(TaskGraph taskGraph);
+
+/**
+ * @brief Returns task graph node count.
+ * @param taskGraph task graph instance
+ */
+size_t getTaskGraphNodeCount(TaskGraph taskGraph);
+
+/**
+ * @brief Adds a new node to the task graph.
+ * @warning You can't change task graph while it is running.
+ *
+ * @param taskGraph task graph instance
+ * @param task node thread pool task
+ * @param[out] node pointer to the node index or NULL (equals to the previous node count)
+ *
+ * @return True on success, false on memory allocation failure.
+ */
+bool addTaskGraphNode(TaskGraph taskGraph, ThreadPoolTask task, size_t* node);
+
+/**
+ * @brief Adds a new edge to the task graph, successor node runs only after the predecessor is completed.
+ * @warning You can't change task graph while it is running.
+ *
+ * @param taskGraph task graph instance
+ * @param predecessor predecessor node index
+ * @param successor successor node index
+ *
+ * @return True on success, false on memory allocation failure.
+ */
+bool addTaskGraphEdge(TaskGraph taskGraph, size_t predecessor, size_t successor);
+
+/**
+ * @brief Removes all task graph nodes and edges.
+ * @warning You can't change task graph while it is running.
+ * @param taskGraph task graph instance
+ */
+void clearTaskGraph(TaskGraph taskGraph);
+
+/**
+ * @brief Starts task graph execution on the thread pool.
+ * @warning You can't start task graph while it is already running.
+ *
+ * @details
+ * Nodes without predecessors are added to the thread pool first. When a node task is completed, it decrements
+ * counters of its successors, adds all released successors except one to the thread pool, and runs the remaining
+ * one on the same thread. First run after the graph change also checks it for cycles.
+ *
+ * @param taskGraph task graph instance
+ * @return True on success, false if the graph has a cycle or on memory allocation failure.
+ */
+bool startTaskGraph(TaskGraph taskGraph);
+
+/**
+ * @brief Waits for the task graph run completion. (Blocking)
+ * @details Current thread helps to execute thread pool tasks while waiting.
+ * @param taskGraph task graph instance
+ */
+void waitTaskGraph(TaskGraph taskGraph);
+
+/**
+ * @brief Runs task graph and waits for its completion. (Blocking)
+ * @details See the @ref startTaskGraph().
+ *
+ * @param taskGraph task graph instance
+ * @return True on success, false if the graph has a cycle or on memory allocation failure.
+ */
+bool runTaskGraph(TaskGraph taskGraph);
+
+/**
+ * @brief Returns true if any task graph node is not completed yet.
+ * @param taskGraph task graph instance
+ */
+bool isTaskGraphRunning(TaskGraph taskGraph);
@@ -14,6 +14,7 @@
 
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 /***********************************************************************************************************************
@@ -36,6 +37,42 @@ typedef struct Thread_T Thread_T;
  */
 typedef Thread_T* Thread;
 
+/**
+ * @brief Thread priority types.
+ */
+typedef enum ThreadPriority_T
+{
+	NORMAL_THREAD_PRIORITY = 0,
+	BACKGROUND_THREAD_PRIORITY = 1,
+	FOREGROUND_THREAD_PRIORITY = 2,
+	THREAD_PRIORITY_COUNT = 3,
+} ThreadPriority_T;
+/**
+ * @brief Thread priority type.
+ */
+typedef uint8_t ThreadPriority;
+
+/**
+ * @brief Thread creation options.
+ * 
+ * @details
+ * Zero initialized options (or NULL) give the default thread. Stack size, guard page, detach state 
+ * and affinity are set before the thread starts, name and priority are set by the thread itself 
+ * before calling the function. Small stacks without guard page reduce virtual memory 
+ * and page faults when creating many helper threads.
+ */
+typedef struct ThreadOptions
+{
+	size_t stackSize; // 0 = OS default
+	void* stack; // Caller provided stack of the stackSize, or NULL (not on Windows)
+	const char* name; // Up to 15 characters (longer is truncated), or NULL
+	const size_t* cpus; // Affinity logical CPUs, or NULL
+	size_t cpuCount;
+	ThreadPriority priority;
+	bool isDetached; // Releases OS resources on exit, can't be joined
+	bool isGuardless; // No stack guard page, overflows are not detected
+} ThreadOptions;
+
 /**
  * @brief Creates a new thread executing the specified function.
  * 
@@ -51,8 +88,22 @@ typedef Thread_T* Thread;
  */
 Thread createThread(void (*function)(void*), void* argument);
 
+/**
+ * @brief Creates a new thread executing the specified function, configured with the options.
+ * @details See the @ref createThread() and @ref ThreadOptions.
+ * @warning Detached thread can't be joined, but you should still destroy its instance to release it.
+ *
+ * @param[in] function pointer to the function that should be invoked
+ * @param[in] argument argument that will be passed to the function or NULL
+ * @param[in] options thread creation options or NULL
+ * 
+ * @return Thread instance on success, otherwise NULL.
+ */
+Thread createThreadWithOptions(void (*function)(void*), void* argument, const ThreadOptions* options);
+
 /**
  * @brief Destroys thread instance.
+ * @details Detached thread instance is freed after both this call and the thread function return.
  * @param thread thread instance or NULL
  */
 void destroyThread(Thread thread);
@@ -95,6 +146,37 @@ bool isThreadCurrent(Thread thread);
  */
 const void* getThreadNative(Thread thread);
 
+/**
+ * @brief Sets thread CPU affinity. (Pins thread to the specified logical CPUs)
+ * 
+ * @details
+ * Thread will be scheduled only on the specified logical CPUs, which keeps its data in the same 
+ * L1/L2/L3 caches and memory node. Affinity is not supported on macOS, where it always returns false.
+ * On Windows only the first 64 logical CPUs (first processor group) can be used.
+ *
+ * @param thread thread instance
+ * @param[in] cpus array of the logical CPU indices
+ * @param cpuCount logical CPU index array size
+ * 
+ * @return True on success, otherwise false.
+ */
+bool setThreadAffinity(Thread thread, const size_t* cpus, size_t cpuCount);
+
+/**
+ * @brief Returns thread CPU affinity. (Logical CPUs it can run on)
+ * 
+ * @details
+ * Writes up to the capacity logical CPU indices in ascending order.
+ * Returned count can be bigger than the capacity, call it again with a bigger array.
+ *
+ * @param thread thread instance
+ * @param[out] cpus pointer to the logical CPU index array or NULL
+ * @param capacity logical CPU index array size
+ * 
+ * @return Allowed logical CPU count on success, otherwise 0.
+ */
+size_t getThreadAffinity(Thread thread, size_t* cpus, size_t capacity);
+
 /***********************************************************************************************************************
  * @brief Sets current thread as main.
  */
@@ -132,4 +214,32 @@ void setThreadForegroundPriority();
 /**
  * @brief Sets current thread priority to background.
  */
-void setThreadBackgroundPriority();
\ No newline at end of file
+void setThreadBackgroundPriority();
+
+/**
+ * @brief Sets current thread CPU affinity. (Pins thread to the specified logical CPUs)
+ * @details See the @ref setThreadAffinity().
+ * 
+ * @param[in] cpus array of the logical CPU indices
+ * @param cpuCount logical CPU index array size
+ * 
+ * @return True on success, otherwise false.
+ */
+bool setCurrentThreadAffinity(const size_t* cpus, size_t cpuCount);
+
+/**
+ * @brief Returns current thread CPU affinity. (Logical CPUs it can run on)
+ * @details See the @ref getThreadAffinity().
+ * 
+ * @param[out] cpus pointer to the logical CPU index array or NULL
+ * @param capacity logical CPU index array size
+ * 
+ * @return Allowed logical CPU count on success, otherwise 0.
+ */
+size_t getCurrentThreadAffinity(size_t* cpus, size_t capacity);
+
+/**
+ * @brief Returns logical CPU index the current thread is running on, or SIZE_MAX if unknown.
+ * @note Thread can be migrated to another CPU right after the call, unless it is pinned.
+ */
+size_t getCurrentThreadCpu();
\ No newline at end of file
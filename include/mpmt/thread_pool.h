@@ -28,21 +28,131 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "mpmt/thread.h"
 
 /**
  * @brief Task order types.
+ * 
+ * @details
+ * Stealing order gives each thread its own task deque. Tasks added from inside of the 
+ * pool threads are pushed to the local deque, and idle threads steal tasks from the others. 
+ * 
+ * Lock-free order stores tasks in the @ref LockFreeQueue, so adding and taking 
+ * tasks doesn't lock the pool mutex, it is used only to put idle threads to sleep.
+ * 
+ * NUMA order discovers memory nodes (from the /sys/devices/system/node on Linux), splits workers into 
+ * per-node groups bound to the node CPUs and gives each node its own task queue, allocated on that node. 
+ * Tasks can be added with the preferred node hint, idle workers steal from the other nodes only 
+ * when their own node queue is empty. Without NUMA information all workers belong to the single node.
+ * 
+ * Segmented order stores tasks in the linked fixed size chunks, allocated on demand and recycled after use, 
+ * so that the queue grows without copying. Task capacity limits the queued task count (memory usage), 
+ * use @ref THREAD_POOL_UNBOUNDED_CAPACITY to never block the adding threads.
+ * 
+ * Stealing, lock-free, NUMA and segmented orders can be selected only at the thread pool creation time.
  */
 typedef enum TaskOrder_T
 {
 	STACK_TASK_ORDER = 0, // Faster than queue
 	QUEUE_TASK_ORDER = 1,
-	TASK_ORDER_COUNT = 2,
+	STEALING_TASK_ORDER = 2, // Per-thread deques, best for nested tasks
+	LOCK_FREE_TASK_ORDER = 3, // Approximately queue order
+	NUMA_TASK_ORDER = 4, // Per-node queues, best for memory bound tasks
+	SEGMENTED_TASK_ORDER = 5, // Growable queue, best for bursts
+	TASK_ORDER_COUNT = 6,
 } TaskOrder_T;
 /**
  * @brief Task order type.
  */
 typedef uint8_t TaskOrder;
 
+/**
+ * @brief Thread pool worker pinning types.
+ * 
+ * @details
+ * Compact pinning places workers on the neighbouring logical CPUs (SMT siblings first, then 
+ * cores of the same package), so that they share L2/L3 caches. Scatter pinning spreads workers 
+ * across the packages and physical cores first, to get more caches and memory bandwidth. 
+ * Both use logical CPUs allowed for the creating thread, and wrap around if there are more workers.
+ * Explicit pinning places worker i on the cpus[i % cpuCount] logical CPU.
+ */
+typedef enum ThreadPinning_T
+{
+	NO_THREAD_PINNING = 0,
+	COMPACT_THREAD_PINNING = 1, // Best for workers sharing data
+	SCATTER_THREAD_PINNING = 2, // Best for memory bandwidth bound tasks
+	EXPLICIT_THREAD_PINNING = 3,
+	THREAD_PINNING_COUNT = 4,
+} ThreadPinning_T;
+/**
+ * @brief Thread pinning type.
+ */
+typedef uint8_t ThreadPinning;
+
+/**
+ * @brief Thread pool idle worker policy types.
+ * 
+ * @details
+ * Park policy puts idle workers to sleep on the condition variable right away, so that adding the first task 
+ * of a burst pays for the wake up and the scheduler latency. Adaptive policy keeps checking for the new tasks 
+ * with the CPU pause hint for the spin count iterations, then yields the rest of the time slice for the yield 
+ * count iterations, and only then goes to sleep. Busy-poll policy never sleeps, workers alternate spinning 
+ * and yielding until the thread pool is destroyed, it is intended for the dedicated low latency cores.
+ */
+typedef enum IdlePolicy_T
+{
+	PARK_IDLE_POLICY = 0, // Lowest CPU usage
+	ADAPTIVE_IDLE_POLICY = 1, // Spin, yield, then park
+	BUSY_POLL_IDLE_POLICY = 2, // Lowest latency, always consumes CPU
+	IDLE_POLICY_COUNT = 3,
+} IdlePolicy_T;
+/**
+ * @brief Idle policy type.
+ */
+typedef uint8_t IdlePolicy;
+
+/**
+ * @brief Thread pool task priority types.
+ * 
+ * @details
+ * Each priority has its own task queue, workers take tasks from the higher priority queue first. To prevent 
+ * the starvation, after the weight count of tasks in a row from the higher priority queue, workers take one task 
+ * from the lower priority queue (weighted-fair dequeue). Zero weight means the strict priority order.
+ * Priorities are supported by the stack, queue and segmented task orders, other orders run all tasks 
+ * in their own order, as if they have the normal priority. In the stack and queue orders, if there is no memory
+ * for the priority queue, the task is added with the normal priority instead.
+ */
+typedef enum TaskPriority_T
+{
+	HIGH_TASK_PRIORITY = 0, // Latency sensitive tasks
+	NORMAL_TASK_PRIORITY = 1,
+	LOW_TASK_PRIORITY = 2, // Background tasks
+	TASK_PRIORITY_COUNT = 3,
+} TaskPriority_T;
+/**
+ * @brief Task priority type.
+ */
+typedef uint8_t TaskPriority;
+
+/**
+ * @brief Default number of higher priority tasks taken in a row, before one lower priority task.
+ */
+#define THREAD_POOL_DEFAULT_PRIORITY_WEIGHT 8
+
+/**
+ * @brief Default number of idle worker task checks with the CPU pause hint.
+ */
+#define THREAD_POOL_DEFAULT_SPIN_COUNT 256
+/**
+ * @brief Default number of idle worker task checks with the thread yield.
+ */
+#define THREAD_POOL_DEFAULT_YIELD_COUNT 16
+
+/**
+ * @brief Default idle worker retire timeout of the fixed size thread pools. (in seconds)
+ */
+#define THREAD_POOL_DEFAULT_KEEP_ALIVE 1.0
+
 /**
  * @brief Thread pool task structure.
  */
@@ -52,6 +162,35 @@ typedef struct ThreadPoolTask
 	void* argument;
 } ThreadPoolTask;
 
+/**
+ * @brief Thread pool inline task payload size in bytes.
+ */
+#define THREAD_POOL_TASK_PAYLOAD_SIZE 48
+
+/**
+ * @brief Thread pool task structure with the inline argument payload.
+ * 
+ * @details
+ * Payload is copied into the thread pool task buffer, so that small arguments (indices, a few pointers) 
+ * don't need a separate heap allocation. Function receives pointer to the payload copy, 
+ * which is aligned to 8 bytes and valid only during the function call.
+ */
+typedef struct ThreadPoolInlineTask
+{
+	void (*function)(void* payload);
+	uint8_t payload[THREAD_POOL_TASK_PAYLOAD_SIZE];
+} ThreadPoolInlineTask;
+
+/**
+ * @brief Segmented thread pool task capacity without the queued task count limit.
+ */
+#define THREAD_POOL_UNBOUNDED_CAPACITY SIZE_MAX
+
+/**
+ * @brief Thread pool task node hint, that selects the current worker or CPU node.
+ */
+#define THREAD_POOL_ANY_NODE SIZE_MAX
+
 /**
  * @brief Thread pool structure.
  */
@@ -61,6 +200,34 @@ typedef struct ThreadPool_T ThreadPool_T;
  */
 typedef ThreadPool_T* ThreadPool;
 
+/**
+ * @brief Thread pool task group structure.
+ */
+typedef struct TaskGroup_T TaskGroup_T;
+/**
+ * @brief Thread pool task group instance.
+ */
+typedef TaskGroup_T* TaskGroup;
+
+/**
+ * @brief Thread pool future structure.
+ */
+typedef struct Future_T Future_T;
+/**
+ * @brief Thread pool future instance.
+ */
+typedef Future_T* Future;
+
+/**
+ * @brief Future task or continuation function.
+ * 
+ * @param argument function argument
+ * @param result antecedent future result, or NULL for the future task
+ * 
+ * @return Result of the function future.
+ */
+typedef void* (*FutureFunction)(void* argument, void* result);
+
 /***********************************************************************************************************************
  * @brief Creates a new thread pool instance.
  * @note You should destroy created thread pool instance manually.
@@ -69,7 +236,7 @@ typedef ThreadPool_T* ThreadPool;
  * Internally it allocates the necessary mutexes, condvars and arrays.
  * It also creates and starts the specified number of threads.
  *
- * @param threadCount target thread count in the pool
+ * @param threadCount target thread count in the pool, or 0 to use the @ref getAvailableCpuCount()
  * @param taskCapacity task buffer size
  * @param taskOrder task order type
  * 
@@ -77,6 +244,72 @@ typedef ThreadPool_T* ThreadPool;
  */
 ThreadPool createThreadPool(size_t threadCount, size_t taskCapacity, TaskOrder taskOrder);
 
+/**
+ * @brief Creates a new thread pool instance with workers pinned to the logical CPUs.
+ * @note You should destroy created thread pool instance manually.
+ * 
+ * @details
+ * Each worker thread is pinned to a single logical CPU, see the @ref ThreadPinning_T.
+ * With the NUMA task order compact and scatter pinning use CPUs of the worker node, 
+ * and explicit pinning moves worker to the node of its CPU.
+ * Fails if the thread affinity can't be set, for example on macOS. (See the @ref setThreadAffinity())
+ *
+ * @param threadCount target thread count in the pool, or 0 to use the @ref getAvailableCpuCount()
+ * @param taskCapacity task buffer size
+ * @param taskOrder task order type
+ * @param pinning worker thread pinning type
+ * @param[in] cpus explicit pinning logical CPU indices or NULL
+ * @param cpuCount explicit pinning logical CPU index array size or 0
+ * 
+ * @return Thread pool instance on success, otherwise NULL.
+ */
+ThreadPool createPinnedThreadPool(size_t threadCount, size_t taskCapacity, 
+	TaskOrder taskOrder, ThreadPinning pinning, const size_t* cpus, size_t cpuCount);
+
+/**
+ * @brief Creates a new thread pool instance with the worker thread options.
+ * @note You should destroy created thread pool instance manually.
+ * 
+ * @details
+ * Worker threads are created with the specified stack size, guard page, priority and affinity. 
+ * Worker name gets its index appended, for example "worker" becomes "worker0", "worker1", ... 
+ * Pinning and NUMA node binding override the options affinity. (See the @ref createPinnedThreadPool())
+ *
+ * @param threadCount target thread count in the pool, or 0 to use the @ref getAvailableCpuCount()
+ * @param taskCapacity task buffer size
+ * @param taskOrder task order type
+ * @param pinning worker thread pinning type
+ * @param[in] cpus explicit pinning logical CPU indices or NULL
+ * @param cpuCount explicit pinning logical CPU index array size or 0
+ * @param[in] workerOptions worker thread options or NULL (can't be detached or have the stack)
+ * 
+ * @return Thread pool instance on success, otherwise NULL.
+ */
+ThreadPool createThreadPoolWithOptions(size_t threadCount, size_t taskCapacity, TaskOrder taskOrder, 
+	ThreadPinning pinning, const size_t* cpus, size_t cpuCount, const ThreadOptions* workerOptions);
+
+/**
+ * @brief Creates a new elastic thread pool instance.
+ * @note You should destroy created thread pool instance manually.
+ * 
+ * @details
+ * Pool starts with the minimal thread count and adds one more worker each time tasks are added while none 
+ * of the workers is sleeping and at least spawn depth tasks are waiting in the queue, or the adding thread 
+ * has to wait for the free space. Workers above the minimal count retire after staying idle for the 
+ * keep-alive time. Stealing pool deques and NUMA worker groups are allocated for the maximal thread count.
+ *
+ * @param minThreadCount minimal thread count in the pool (always running)
+ * @param maxThreadCount maximal thread count in the pool, or 0 to use the @ref getAvailableCpuCount()
+ * @param taskCapacity task buffer size
+ * @param taskOrder task order type
+ * @param spawnDepth queued task count that starts a new worker
+ * @param keepAlive idle worker retire timeout (in seconds)
+ * 
+ * @return Thread pool instance on success, otherwise NULL.
+ */
+ThreadPool createElasticThreadPool(size_t minThreadCount, size_t maxThreadCount, 
+	size_t taskCapacity, TaskOrder taskOrder, size_t spawnDepth, double keepAlive);
+
 /**
  * @brief Destroys thread pool instance. (Blocking)
  * @param threadPool thread pool instance or NULL
@@ -84,10 +317,51 @@ ThreadPool createThreadPool(size_t threadCount, size_t taskCapacity, TaskOrder t
 void destroyThreadPool(ThreadPool threadPool);
 
 /**
- * @brief Returns thread pool thread count.
+ * @brief Returns thread pool running thread count.
  * @param threadPool thread pool instance
  */
 size_t getThreadPoolThreadCount(ThreadPool threadPool);
+/**
+ * @brief Returns thread pool worker slot count. (Maximal thread count at the creation time)
+ * @param threadPool thread pool instance
+ */
+size_t getThreadPoolThreadCapacity(ThreadPool threadPool);
+/**
+ * @brief Returns thread pool minimal thread count.
+ * @param threadPool thread pool instance
+ */
+size_t getThreadPoolMinThreadCount(ThreadPool threadPool);
+/**
+ * @brief Returns thread pool maximal thread count.
+ * @param threadPool thread pool instance
+ */
+size_t getThreadPoolMaxThreadCount(ThreadPool threadPool);
+
+/**
+ * @brief Sets thread pool minimal and maximal thread count.
+ * 
+ * @details
+ * Missing workers are started right away, extra workers retire once they are idle, so the pool is not drained.
+ * Fixed size pool becomes elastic if the minimal count is less than the maximal, it uses spawn depth 1 
+ * and the @ref THREAD_POOL_DEFAULT_KEEP_ALIVE time. (See the @ref createElasticThreadPool())
+ * 
+ * @param threadPool thread pool instance
+ * @param minThreadCount minimal thread count in the pool
+ * @param maxThreadCount maximal thread count (can't be greater than the thread capacity)
+ * 
+ * @return True on success, false if failed to start a new worker thread.
+ */
+bool setThreadPoolThreadLimits(ThreadPool threadPool, size_t minThreadCount, size_t maxThreadCount);
+/**
+ * @brief Sets thread pool thread count, making it fixed size.
+ * @details See the @ref setThreadPoolThreadLimits().
+ * 
+ * @param threadPool thread pool instance
+ * @param threadCount target thread count (can't be greater than the thread capacity)
+ * 
+ * @return True on success, false if failed to start a new worker thread.
+ */
+bool setThreadPoolThreadCount(ThreadPool threadPool, size_t threadCount);
 
 /**
  * @brief Returns thread pool task capacity.
@@ -107,8 +381,49 @@ bool isThreadPoolRunning(ThreadPool threadPool);
  */
 TaskOrder getThreadPoolTaskOrder(ThreadPool threadPool);
 
+/**
+ * @brief Returns thread pool worker pinning type.
+ * @param threadPool thread pool instance
+ */
+ThreadPinning getThreadPoolPinning(ThreadPool threadPool);
+
+/**
+ * @brief Returns logical CPU index of the pinned thread pool worker, or SIZE_MAX if not pinned.
+ * 
+ * @param threadPool thread pool instance
+ * @param threadIndex thread pool worker index
+ */
+size_t getThreadPoolThreadCpu(ThreadPool threadPool, size_t threadIndex);
+
+/**
+ * @brief Returns thread pool idle worker policy type.
+ * @param threadPool thread pool instance
+ */
+IdlePolicy getThreadPoolIdlePolicy(ThreadPool threadPool);
+/**
+ * @brief Sets thread pool idle worker policy type.
+ * @details New thread pools are created with the park idle policy.
+ * 
+ * @param threadPool thread pool instance
+ * @param idlePolicy idle policy type
+ * @param spinCount task checks with the CPU pause hint before yielding
+ * @param yieldCount task checks with the thread yield before sleeping (ignored by busy-poll)
+ */
+void setThreadPoolIdlePolicy(ThreadPool threadPool, IdlePolicy idlePolicy, uint32_t spinCount, uint32_t yieldCount);
+
+/**
+ * @brief Sets thread pool task priority weights.
+ * @details New thread pools are created with the @ref THREAD_POOL_DEFAULT_PRIORITY_WEIGHT weights.
+ * 
+ * @param threadPool thread pool instance
+ * @param highWeight high priority tasks taken before one normal or low priority task, or zero (strict)
+ * @param normalWeight normal priority tasks taken before one low priority task, or zero (strict)
+ */
+void setThreadPoolPriorityWeights(ThreadPool threadPool, uint32_t highWeight, uint32_t normalWeight);
+
 /**
  * @brief Sets thread pool task order type. (Blocking)
+ * @warning You can only switch between the stack and queue task orders.
  *
  * @param threadPool thread pool instance
  * @param taskOrder task order type
@@ -116,17 +431,22 @@ TaskOrder getThreadPoolTaskOrder(ThreadPool threadPool);
 void setThreadPoolTaskOrder(ThreadPool threadPool, TaskOrder taskOrder);
 
 /**
- * @brief Resize thread pool task buffer. (Blocking)
+ * @brief Resize thread pool task buffer.
+ * @note Lock-free and NUMA task order thread pools can't be resized.
+ * 
+ * @details
+ * Queued tasks are moved to the new buffer under the pool mutex, the pool is not drained. 
+ * Segmented task order only changes the queued task count limit, it can be less than the current count.
  *
  * @param threadPool thread pool instance
- * @param taskCapacity task buffer size
+ * @param taskCapacity task buffer size, or queued task count limit
  * 
- * @return True on success, otherwise false.
+ * @return True on success, false if the buffer can't fit queued tasks or on allocation failure.
  */
 bool resizeThreadPoolTasks(ThreadPool threadPool, size_t taskCapacity);
 
 /***********************************************************************************************************************
- * @brief Adds a new task to the thread pool, if enough space.
+ * @brief Adds a new task to the thread pool, if enough space and memory for it.
  * 
  * @param threadPool thread pool instance
  * @param task target thread pool task
@@ -161,8 +481,373 @@ void addThreadPoolTasks(ThreadPool threadPool, ThreadPoolTask* tasks, size_t tas
  */
 void addThreadPoolTaskNumber(ThreadPool threadPool, ThreadPoolTask task, size_t taskCount);
 
+/**
+ * @brief Adds a new task to the thread pool priority queue, if enough space.
+ * @details See the @ref TaskPriority_T.
+ * 
+ * @param threadPool thread pool instance
+ * @param task target thread pool task
+ * @param priority task priority type
+ * 
+ * @return True if task successfully added, otherwise false.
+ */
+bool tryAddThreadPoolPriorityTask(ThreadPool threadPool, ThreadPoolTask task, TaskPriority priority);
+
+/**
+ * @brief Adds a new task to the thread pool priority queue. (Blocking)
+ * @details See the @ref TaskPriority_T.
+ *
+ * @param threadPool thread pool instance
+ * @param task target thread pool task
+ * @param priority task priority type
+ */
+void addThreadPoolPriorityTask(ThreadPool threadPool, ThreadPoolTask task, TaskPriority priority);
+
+/**
+ * @brief Adds a new tasks to the thread pool priority queue. (Blocking)
+ * @details See the @ref TaskPriority_T.
+ *
+ * @param threadPool thread pool instance
+ * @param[in] tasks target thread pool tasks
+ * @param taskCount task array size
+ * @param priority task priority type
+ */
+void addThreadPoolPriorityTasks(ThreadPool threadPool, const ThreadPoolTask* tasks, 
+	size_t taskCount, TaskPriority priority);
+
+/**
+ * @brief Adds a new tasks to the thread pool priority queue. (Blocking)
+ * @details See the @ref TaskPriority_T.
+ *
+ * @param threadPool thread pool instance
+ * @param task target thread pool task
+ * @param taskCount task count
+ * @param priority task priority type
+ */
+void addThreadPoolPriorityTaskNumber(ThreadPool threadPool, ThreadPoolTask task, 
+	size_t taskCount, TaskPriority priority);
+
+/**
+ * @brief Adds a new inline task to the thread pool, if enough space.
+ * 
+ * @param threadPool thread pool instance
+ * @param[in] task target thread pool inline task
+ * 
+ * @return True if task successfully added, otherwise false.
+ */
+bool tryAddThreadPoolInlineTask(ThreadPool threadPool, const ThreadPoolInlineTask* task);
+
+/**
+ * @brief Adds a new inline task to the thread pool. (Blocking)
+ *
+ * @param threadPool thread pool instance
+ * @param[in] task target thread pool inline task
+ */
+void addThreadPoolInlineTask(ThreadPool threadPool, const ThreadPoolInlineTask* task);
+
+/**
+ * @brief Adds a new inline tasks to the thread pool. (Blocking)
+ *
+ * @param threadPool thread pool instance
+ * @param[in] tasks target thread pool inline tasks
+ * @param taskCount task array size
+ */
+void addThreadPoolInlineTasks(ThreadPool threadPool, const ThreadPoolInlineTask* tasks, size_t taskCount);
+
+/**
+ * @brief Adds a new inline tasks to the thread pool. (Blocking)
+ * @details Each task receives its own copy of the same payload.
+ *
+ * @param threadPool thread pool instance
+ * @param[in] task target thread pool inline task
+ * @param taskCount task count
+ */
+void addThreadPoolInlineTaskNumber(ThreadPool threadPool, const ThreadPoolInlineTask* task, size_t taskCount);
+
+/**
+ * @brief Adds a new task to the thread pool node queue, if enough space.
+ * @details Node is only a hint, task is added to the other node if the preferred one is full.
+ * 
+ * @param threadPool thread pool instance
+ * @param task target thread pool task
+ * @param node preferred memory node index or @ref THREAD_POOL_ANY_NODE
+ * 
+ * @return True if task successfully added, otherwise false.
+ */
+bool tryAddThreadPoolNodeTask(ThreadPool threadPool, ThreadPoolTask task, size_t node);
+
+/**
+ * @brief Adds a new task to the thread pool node queue. (Blocking)
+ * @details See the @ref tryAddThreadPoolNodeTask().
+ *
+ * @param threadPool thread pool instance
+ * @param task target thread pool task
+ * @param node preferred memory node index or @ref THREAD_POOL_ANY_NODE
+ */
+void addThreadPoolNodeTask(ThreadPool threadPool, ThreadPoolTask task, size_t node);
+
+/**
+ * @brief Adds a new tasks to the thread pool node queue. (Blocking)
+ * @details See the @ref tryAddThreadPoolNodeTask().
+ *
+ * @param threadPool thread pool instance
+ * @param[in] tasks target thread pool tasks
+ * @param taskCount task array size
+ * @param node preferred memory node index or @ref THREAD_POOL_ANY_NODE
+ */
+void addThreadPoolNodeTasks(ThreadPool threadPool, const ThreadPoolTask* tasks, size_t taskCount, size_t node);
+
+/**
+ * @brief Returns thread pool memory node count.
+ * @details Always 1 if the thread pool task order is not the NUMA.
+ * @param threadPool thread pool instance
+ */
+size_t getThreadPoolNodeCount(ThreadPool threadPool);
+
+/**
+ * @brief Returns thread pool worker memory node index.
+ * 
+ * @param threadPool thread pool instance
+ * @param threadIndex thread pool worker index
+ */
+size_t getThreadPoolThreadNode(ThreadPool threadPool, size_t threadIndex);
+
 /**
  * @brief Waits until the thread pool has completed all tasks. (Blocking)
  * @param threadPool thread pool instance.
  */
-void waitThreadPool(ThreadPool threadPool);
\ No newline at end of file
+void waitThreadPool(ThreadPool threadPool);
+
+/***********************************************************************************************************************
+ * @brief Thread pool parallel for range function.
+ * 
+ * @param[in] context user context passed to the @ref parallelForThreadPool()
+ * @param rangeBegin first index of the range
+ * @param rangeEnd index after the last one of the range
+ */
+typedef void (*ParallelForFunction)(void* context, size_t rangeBegin, size_t rangeEnd);
+
+/**
+ * @brief Runs function over the index range using thread pool threads. (Blocking)
+ * 
+ * @details
+ * Range is split into the guided chunks, large at the start and smaller to the end, but not less than the grain. 
+ * Calling thread also executes chunks, and function returns as soon as all range chunks are finished, 
+ * without waiting for the other thread pool tasks. It can be called from inside of the thread pool tasks.
+ * On memory allocation failure the whole range is executed by the calling thread.
+ *
+ * @param threadPool thread pool instance
+ * @param begin first index of the range
+ * @param end index after the last one of the range
+ * @param grain minimal chunk size, or 0 for automatic
+ * @param[in] function range function to invoke for each chunk
+ * @param[in] context user context that will be passed to the function or NULL
+ */
+void parallelForThreadPool(ThreadPool threadPool, size_t begin, size_t end, 
+	size_t grain, ParallelForFunction function, void* context);
+
+/***********************************************************************************************************************
+ * @brief Creates a new thread pool task group instance.
+ * @note You should destroy created task group instance manually.
+ * 
+ * @details
+ * Task group tracks completion of the tasks added through it, so that
+ * they can be awaited without waiting for the other thread pool tasks.
+ *
+ * @param threadPool thread pool instance
+ * @return Task group instance on success, otherwise NULL.
+ */
+TaskGroup createTaskGroup(ThreadPool threadPool);
+
+/**
+ * @brief Destroys task group instance. (Blocking)
+ * @details Waits for the task group tasks completion before destroying.
+ * @param taskGroup task group instance or NULL
+ */
+void destroyTaskGroup(TaskGroup taskGroup);
+
+/**
+ * @brief Returns task group thread pool instance.
+ * @param taskGroup task group instance
+ */
+ThreadPool getTaskGroupThreadPool(TaskGroup taskGroup);
+
+/**
+ * @brief Returns true if any task group task is not completed yet.
+ * @param taskGroup task group instance
+ */
+bool isTaskGroupRunning(TaskGroup taskGroup);
+
+/**
+ * @brief Adds a new task to the task group, if enough space.
+ * 
+ * @param taskGroup task group instance
+ * @param task target thread pool task
+ * 
+ * @return True if task successfully added, otherwise false.
+ */
+bool tryAddTaskGroupTask(TaskGroup taskGroup, ThreadPoolTask task);
+
+/**
+ * @brief Adds a new task to the task group. (Blocking)
+ *
+ * @param taskGroup task group instance
+ * @param task target thread pool task
+ */
+void addTaskGroupTask(TaskGroup taskGroup, ThreadPoolTask task);
+
+/**
+ * @brief Adds a new tasks to the task group. (Blocking)
+ *
+ * @param taskGroup task group instance
+ * @param[in] tasks target thread pool tasks
+ * @param taskCount task array size
+ */
+void addTaskGroupTasks(TaskGroup taskGroup, ThreadPoolTask* tasks, size_t taskCount);
+
+/**
+ * @brief Adds a new tasks to the task group. (Blocking)
+ *
+ * @param taskGroup task group instance
+ * @param task target thread pool task
+ * @param taskCount task count
+ */
+void addTaskGroupTaskNumber(TaskGroup taskGroup, ThreadPoolTask task, size_t taskCount);
+
+/**
+ * @brief Adds a new inline task to the task group, if enough space.
+ * 
+ * @param taskGroup task group instance
+ * @param[in] task target thread pool inline task
+ * 
+ * @return True if task successfully added, otherwise false.
+ */
+bool tryAddTaskGroupInlineTask(TaskGroup taskGroup, const ThreadPoolInlineTask* task);
+
+/**
+ * @brief Adds a new inline task to the task group. (Blocking)
+ *
+ * @param taskGroup task group instance
+ * @param[in] task target thread pool inline task
+ */
+void addTaskGroupInlineTask(TaskGroup taskGroup, const ThreadPoolInlineTask* task);
+
+/**
+ * @brief Adds a new inline tasks to the task group. (Blocking)
+ *
+ * @param taskGroup task group instance
+ * @param[in] tasks target thread pool inline tasks
+ * @param taskCount task array size
+ */
+void addTaskGroupInlineTasks(TaskGroup taskGroup, const ThreadPoolInlineTask* tasks, size_t taskCount);
+
+/**
+ * @brief Adds a new inline tasks to the task group. (Blocking)
+ * @details Each task receives its own copy of the same payload.
+ *
+ * @param taskGroup task group instance
+ * @param[in] task target thread pool inline task
+ * @param taskCount task count
+ */
+void addTaskGroupInlineTaskNumber(TaskGroup taskGroup, const ThreadPoolInlineTask* task, size_t taskCount);
+
+/**
+ * @brief Waits until the task group has completed all tasks. (Blocking)
+ * 
+ * @details
+ * Waiting thread helps to execute thread pool tasks instead of sleeping, 
+ * so it can be safely called from inside of the thread pool tasks.
+ * 
+ * @param taskGroup task group instance
+ */
+void waitTaskGroup(TaskGroup taskGroup);
+
+/***********************************************************************************************************************
+ * @brief Creates a new not ready thread pool future instance. (Promise)
+ * @note You should destroy created future instance manually.
+ * 
+ * @details
+ * Future holds a result of the asynchronous operation, it becomes ready when the result is set with the 
+ * @ref setFutureResult() or when its future task is completed. Continuations are added to the thread pool
+ * the moment their antecedent future becomes ready, so that the async pipelines don't block worker threads.
+ * 
+ * Future memory is freed after the last reference is released: the user handle, the not completed future task 
+ * or the not scheduled continuation. Result memory is owned by the user.
+ *
+ * @param threadPool thread pool instance, that executes future continuations
+ * @return Future instance on success, otherwise NULL.
+ */
+Future createFuture(ThreadPool threadPool);
+
+/**
+ * @brief Releases future instance user handle.
+ * @details Pending future task and continuations are still executed.
+ * @param future future instance or NULL
+ */
+void destroyFuture(Future future);
+
+/**
+ * @brief Returns future thread pool instance.
+ * @param future future instance
+ */
+ThreadPool getFutureThreadPool(Future future);
+
+/**
+ * @brief Returns true if future result is set.
+ * @param future future instance
+ */
+bool isFutureReady(Future future);
+
+/**
+ * @brief Returns future result.
+ * @warning Future should be ready.
+ * @param future future instance
+ */
+void* getFutureResult(Future future);
+
+/**
+ * @brief Sets future result and adds its continuations to the thread pool. (Blocking)
+ * @warning Future result can be set only once, and only if it has no future task.
+ * 
+ * @param future future instance
+ * @param[in] result future result or NULL
+ */
+void setFutureResult(Future future, void* result);
+
+/**
+ * @brief Waits until the future is ready and returns its result. (Blocking)
+ * 
+ * @details
+ * Waiting thread helps to execute thread pool tasks instead of sleeping, 
+ * so it can be safely called from inside of the thread pool tasks.
+ * 
+ * @param future future instance
+ */
+void* waitFuture(Future future);
+
+/**
+ * @brief Adds a new future task to the thread pool. (Blocking)
+ * @details Future becomes ready with the function result, after the task is completed.
+ * 
+ * @param threadPool thread pool instance
+ * @param[in] function future task function
+ * @param[in] argument function argument or NULL
+ * 
+ * @return Future instance on success, otherwise NULL.
+ */
+Future addThreadPoolFutureTask(ThreadPool threadPool, FutureFunction function, void* argument);
+
+/**
+ * @brief Adds a new continuation to the future. (Blocking)
+ * 
+ * @details
+ * Continuation task is added to the future thread pool when the antecedent future becomes ready, or right away 
+ * if it is already ready. It receives antecedent future result, and its own future becomes ready with the result.
+ * 
+ * @param future antecedent future instance
+ * @param[in] function continuation function
+ * @param[in] argument function argument or NULL
+ * 
+ * @return Continuation future instance on success, otherwise NULL.
+ */
+Future addFutureContinuation(Future future, FutureFunction function, void* argument);
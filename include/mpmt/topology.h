@@ -0,0 +1,109 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief CPU topology functions.
+ * 
+ * @details
+ * Topology describes the shape of the machine: logical CPUs (hardware threads), physical cores 
+ * they belong to, CPU packages (sockets), cache hierarchy and NUMA memory nodes. It is used to pick 
+ * the worker thread count, to pin threads and to size per-thread data without oversubscribing 
+ * the machine or container CPU limits. Values are read from the OS on each call, cache them if needed.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Returns logical CPU (hardware thread) count online in the system.
+ */
+size_t getLogicalCpuCount();
+
+/**
+ * @brief Returns physical CPU core count in the system.
+ * @details Returns logical CPU count if the core topology is unknown.
+ */
+size_t getPhysicalCoreCount();
+
+/**
+ * @brief Returns CPU package (socket) count in the system.
+ */
+size_t getCpuPackageCount();
+
+/**
+ * @brief Returns maximal SMT sibling count per physical core. (1 if there is no SMT)
+ */
+size_t getSmtSiblingCount();
+
+/**
+ * @brief Returns CPU package (socket) index of the logical CPU, or SIZE_MAX if unknown.
+ * @param cpu logical CPU index
+ */
+size_t getCpuPackage(size_t cpu);
+
+/**
+ * @brief Returns physical core index of the logical CPU, or SIZE_MAX if unknown.
+ * @details SMT siblings have the same package and core index.
+ * @param cpu logical CPU index
+ */
+size_t getCpuCore(size_t cpu);
+
+/***********************************************************************************************************************
+ * @brief Returns data or unified CPU cache size in bytes, or 0 if there is no such level.
+ * @param level target cache level (1 = L1, 2 = L2, 3 = L3, ...)
+ */
+size_t getCpuCacheSize(uint8_t level);
+
+/**
+ * @brief Returns data or unified CPU cache line size in bytes, or 0 if there is no such level.
+ * @param level target cache level (1 = L1, 2 = L2, 3 = L3, ...)
+ */
+size_t getCpuCacheLineSize(uint8_t level);
+
+/***********************************************************************************************************************
+ * @brief Returns NUMA memory node count in the system. (1 if there is no NUMA)
+ */
+size_t getNumaNodeCount();
+
+/**
+ * @brief Returns logical CPUs of the NUMA memory node.
+ * 
+ * @details
+ * Writes up to the capacity logical CPU indices in ascending order. Nodes are 
+ * numbered from 0 to the @ref getNumaNodeCount(), even if the OS node IDs are sparse.
+ *
+ * @param node NUMA memory node index
+ * @param[out] cpus pointer to the logical CPU index array or NULL
+ * @param capacity logical CPU index array size
+ * 
+ * @return Node logical CPU count, 0 if node has no CPUs or it is unknown.
+ */
+size_t getNumaNodeCpus(size_t node, size_t* cpus, size_t capacity);
+
+/***********************************************************************************************************************
+ * @brief Returns process CPU quota, in CPUs, or 0.0 if it is not limited.
+ * @details On Linux it is read from the cgroup v2 "cpu.max" or v1 "cpu.cfs_quota_us" files.
+ */
+double getCpuQuota();
+
+/**
+ * @brief Returns logical CPU count the process can actually use.
+ * 
+ * @details
+ * Logical CPUs allowed by the current thread affinity, limited by the rounded up CPU quota, 
+ * so that containers are not oversubscribed. Use it as the worker thread count. (At least 1)
+ */
+size_t getAvailableCpuCount();
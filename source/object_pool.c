@@ -0,0 +1,331 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/object_pool.h"
+#include "mpmt/atomic.h"
+#include "mpmt/spinlock.h"
+#include "mpmt/sync.h"
+#include "mpmt/topology.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#if __linux__ || __APPLE__
+#define THREAD_LOCAL __thread
+#elif _WIN32
+#define THREAD_LOCAL __declspec(thread)
+#else
+#error Unknown operating system
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+// Note: free objects are linked inside the cache, first object of the batch also links the next batch.
+typedef struct FreeObject
+{
+	struct FreeObject* next;
+	atomic_ptr nextBatch;
+	size_t count;
+} FreeObject;
+
+typedef struct ObjectCache
+{
+	Spinlock spinlock;
+	FreeObject* head;
+	size_t count;
+	uint8_t _padding[CACHE_LINE_SIZE - sizeof(Spinlock) - sizeof(FreeObject*) - sizeof(size_t)];
+} ObjectCache;
+
+struct ObjectPool_T
+{
+	#ifdef MPMT_ATOMIC_TAGGED_PTR
+	atomic_tagged_ptr freeBatches;
+	#else
+	Spinlock freeSpinlock;
+	FreeObject* freeBatches;
+	#endif
+	uint8_t _freePadding[CACHE_LINE_SIZE];
+	ObjectCache* caches;
+	void* cacheMemory;
+	uint32_t cacheMask;
+	size_t objectSize;
+	size_t blockCapacity;
+	size_t blockHeaderSize;
+	Mutex_T blockMutex;
+	void* blocks;
+	atomic_size blockCount;
+};
+
+static atomic_int32 threadCacheCounter = 0;
+static THREAD_LOCAL uint32_t threadCache = 0;
+
+// Note: each thread gets its own cache index once, threads above the cache count are sharing caches.
+static ObjectCache* getThreadCache(ObjectPool objectPool)
+{
+	uint32_t cache = threadCache;
+	if (cache == 0)
+	{
+		cache = (uint32_t)atomicFetchAddExplicit32(&threadCacheCounter, 1, ATOMIC_RELAXED) + 1;
+		threadCache = cache;
+	}
+	return &objectPool->caches[(cache - 1) & objectPool->cacheMask];
+}
+static uint32_t getCacheCount()
+{
+	size_t cpuCount = getLogicalCpuCount();
+
+	// Note: there are usually more producer and worker threads than CPUs.
+	uint32_t cacheCount = 4;
+	while ((size_t)cacheCount < cpuCount * 4 && cacheCount < 1024)
+		cacheCount <<= 1;
+	return cacheCount;
+}
+
+//**********************************************************************************************************************
+static void pushFreeBatch(ObjectPool objectPool, FreeObject* batch)
+{
+	#ifdef MPMT_ATOMIC_TAGGED_PTR
+	TaggedPtr expected = atomicLoadTaggedPtr(&objectPool->freeBatches);
+	do atomicStoreExplicitPtr(&batch->nextBatch, expected.ptr, ATOMIC_RELAXED);
+	while (!atomicCompareExchangeTaggedPtr(&objectPool->freeBatches, &expected, batch));
+	#else
+	lockSpinlock(&objectPool->freeSpinlock);
+	batch->nextBatch = objectPool->freeBatches;
+	objectPool->freeBatches = batch;
+	unlockSpinlock(&objectPool->freeSpinlock);
+	#endif
+}
+static FreeObject* popFreeBatch(ObjectPool objectPool)
+{
+	#ifdef MPMT_ATOMIC_TAGGED_PTR
+	// Note: popped batch can be reused by another thread meanwhile, the tag makes the compare exchange fail then.
+	TaggedPtr expected = atomicLoadTaggedPtr(&objectPool->freeBatches);
+	FreeObject* batch;
+	do
+	{
+		batch = (FreeObject*)expected.ptr;
+		if (!batch)
+			return NULL;
+	}
+	while (!atomicCompareExchangeTaggedPtr(&objectPool->freeBatches, 
+		&expected, atomicLoadExplicitPtr(&batch->nextBatch, ATOMIC_RELAXED)));
+	return batch;
+	#else
+	lockSpinlock(&objectPool->freeSpinlock);
+	FreeObject* batch = objectPool->freeBatches;
+	if (batch)
+		objectPool->freeBatches = (FreeObject*)batch->nextBatch;
+	unlockSpinlock(&objectPool->freeSpinlock);
+	return batch;
+	#endif
+}
+
+// Note: splits a new block into batches, returns the first one and makes others available to all threads.
+static FreeObject* allocateObjectBlock(ObjectPool objectPool)
+{
+	Mutex blockMutex = &objectPool->blockMutex;
+	lockMutex(blockMutex);
+
+	FreeObject* batch = popFreeBatch(objectPool);
+	if (batch)
+	{
+		unlockMutex(blockMutex);
+		return batch; // Note: another thread has already allocated a block.
+	}
+
+	size_t objectSize = objectPool->objectSize, blockCapacity = objectPool->blockCapacity;
+	uint8_t* block = malloc(objectPool->blockHeaderSize + objectSize * blockCapacity);
+	if (!block)
+	{
+		unlockMutex(blockMutex);
+		return NULL;
+	}
+
+	*(void**)block = objectPool->blocks;
+	objectPool->blocks = block;
+	uint8_t* objects = block + objectPool->blockHeaderSize;
+
+	for (size_t i = 0; i < blockCapacity; i += OBJECT_POOL_BATCH_SIZE)
+	{
+		size_t count = blockCapacity - i < OBJECT_POOL_BATCH_SIZE ? blockCapacity - i : OBJECT_POOL_BATCH_SIZE;
+		for (size_t j = 0; j < count; j++)
+		{
+			FreeObject* object = (FreeObject*)(objects + (i + j) * objectSize);
+			object->next = j + 1 < count ? (FreeObject*)(objects + (i + j + 1) * objectSize) : NULL;
+		}
+
+		FreeObject* first = (FreeObject*)(objects + i * objectSize);
+		first->count = count;
+
+		if (i == 0)
+			batch = first;
+		else
+			pushFreeBatch(objectPool, first);
+	}
+
+	atomicFetchAddSize(&objectPool->blockCount, 1);
+	unlockMutex(blockMutex);
+	return batch;
+}
+
+//**********************************************************************************************************************
+ObjectPool createObjectPool(size_t objectSize, size_t blockCapacity)
+{
+	assert(objectSize > 0);
+	assert(blockCapacity > 0);
+
+	ObjectPool objectPool = calloc(1, sizeof(ObjectPool_T));
+	if (!objectPool)
+		return NULL;
+
+	uint32_t cacheCount = getCacheCount();
+	void* cacheMemory = calloc(1, cacheCount * sizeof(ObjectCache) + CACHE_LINE_SIZE);
+	if (!cacheMemory)
+	{
+		free(objectPool);
+		return NULL;
+	}
+
+	if (!initMutex(&objectPool->blockMutex))
+	{
+		free(cacheMemory);
+		free(objectPool);
+		return NULL;
+	}
+
+	if (objectSize < sizeof(FreeObject))
+		objectSize = sizeof(FreeObject);
+	objectSize = (objectSize + (OBJECT_POOL_ALIGNMENT - 1)) & ~(size_t)(OBJECT_POOL_ALIGNMENT - 1);
+
+	// Note: aligning caches to the cache line, so that threads don't share lines.
+	size_t cacheAddress = ((size_t)cacheMemory + (CACHE_LINE_SIZE - 1)) & ~(size_t)(CACHE_LINE_SIZE - 1);
+	objectPool->caches = (ObjectCache*)cacheAddress;
+	objectPool->cacheMemory = cacheMemory;
+	objectPool->cacheMask = cacheCount - 1;
+	objectPool->objectSize = objectSize;
+	objectPool->blockCapacity = blockCapacity;
+	objectPool->blockHeaderSize = OBJECT_POOL_ALIGNMENT;
+	return objectPool;
+}
+void destroyObjectPool(ObjectPool objectPool)
+{
+	if (!objectPool)
+		return;
+
+	void* block = objectPool->blocks;
+	while (block)
+	{
+		void* nextBlock = *(void**)block;
+		free(block);
+		block = nextBlock;
+	}
+
+	deinitMutex(&objectPool->blockMutex);
+	free(objectPool->cacheMemory);
+	free(objectPool);
+}
+
+//**********************************************************************************************************************
+size_t getObjectPoolObjectSize(ObjectPool objectPool)
+{
+	assert(objectPool);
+	return objectPool->objectSize;
+}
+size_t getObjectPoolBlockCapacity(ObjectPool objectPool)
+{
+	assert(objectPool);
+	return objectPool->blockCapacity;
+}
+size_t getObjectPoolCapacity(ObjectPool objectPool)
+{
+	assert(objectPool);
+	return atomicLoadExplicitSize(&objectPool->blockCount, ATOMIC_RELAXED) * objectPool->blockCapacity;
+}
+
+//**********************************************************************************************************************
+void* allocateObjectPoolObject(ObjectPool objectPool)
+{
+	assert(objectPool);
+	ObjectCache* cache = getThreadCache(objectPool);
+
+	lockSpinlock(&cache->spinlock);
+	FreeObject* object = cache->head;
+	if (object)
+	{
+		cache->head = object->next;
+		cache->count--;
+		unlockSpinlock(&cache->spinlock);
+		return object;
+	}
+	unlockSpinlock(&cache->spinlock);
+
+	object = popFreeBatch(objectPool);
+	if (!object)
+	{
+		object = allocateObjectBlock(objectPool);
+		if (!object)
+			return NULL;
+	}
+
+	FreeObject* rest = object->next;
+	if (!rest)
+		return object;
+	rest->count = object->count - 1;
+
+	lockSpinlock(&cache->spinlock);
+	if (!cache->head)
+	{
+		cache->head = rest;
+		cache->count = rest->count;
+		rest = NULL;
+	}
+	unlockSpinlock(&cache->spinlock);
+
+	// Note: the cache was refilled by another thread sharing it meanwhile.
+	if (rest)
+		pushFreeBatch(objectPool, rest);
+	return object;
+}
+void freeObjectPoolObject(ObjectPool objectPool, void* object)
+{
+	assert(objectPool);
+	if (!object)
+		return;
+
+	ObjectCache* cache = getThreadCache(objectPool);
+	FreeObject* freeObject = (FreeObject*)object;
+	FreeObject* batch = NULL;
+
+	lockSpinlock(&cache->spinlock);
+	freeObject->next = cache->head;
+	cache->head = freeObject;
+
+	// Note: keeping one batch in the cache, so that alternating allocate and free don't hit the freelist.
+	if (++cache->count >= OBJECT_POOL_BATCH_SIZE * 2)
+	{
+		batch = cache->head;
+		FreeObject* last = batch;
+		for (size_t i = 1; i < OBJECT_POOL_BATCH_SIZE; i++)
+			last = last->next;
+
+		cache->head = last->next;
+		cache->count -= OBJECT_POOL_BATCH_SIZE;
+		last->next = NULL;
+		batch->count = OBJECT_POOL_BATCH_SIZE;
+	}
+	unlockSpinlock(&cache->spinlock);
+
+	if (batch)
+		pushFreeBatch(objectPool, batch);
+}
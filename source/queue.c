@@ -0,0 +1,177 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/queue.h"
+#include "mpmt/atomic.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE_SIZE 64
+
+struct LockFreeQueue_T
+{
+	atomic_int64 enqueuePos;
+	uint8_t _enqueuePadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	atomic_int64 dequeuePos;
+	uint8_t _dequeuePadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	uint8_t* cells;
+	size_t cellSize;
+	size_t itemSize;
+	int64_t mask;
+};
+
+// Note: each cell is a sequence number followed by the item data.
+static atomic_int64* getCellSequence(LockFreeQueue queue, int64_t index)
+{
+	return (atomic_int64*)(queue->cells + (size_t)index * queue->cellSize);
+}
+static uint8_t* getCellItem(LockFreeQueue queue, int64_t index)
+{
+	return queue->cells + (size_t)index * queue->cellSize + sizeof(int64_t);
+}
+
+//**********************************************************************************************************************
+LockFreeQueue createLockFreeQueue(size_t capacity, size_t itemSize)
+{
+	assert(capacity > 0);
+	assert(itemSize > 0);
+
+	LockFreeQueue queue = calloc(1, sizeof(LockFreeQueue_T));
+	if (!queue)
+		return NULL;
+
+	size_t cellCapacity = 2;
+	while (cellCapacity < capacity)
+		cellCapacity <<= 1;
+
+	size_t cellSize = sizeof(int64_t) + itemSize;
+	cellSize = (cellSize + sizeof(int64_t) - 1) & ~(sizeof(int64_t) - 1);
+
+	uint8_t* cells = malloc(cellCapacity * cellSize);
+	if (!cells)
+	{
+		free(queue);
+		return NULL;
+	}
+
+	queue->cells = cells;
+	queue->cellSize = cellSize;
+	queue->itemSize = itemSize;
+	queue->mask = (int64_t)cellCapacity - 1;
+
+	for (size_t i = 0; i < cellCapacity; i++)
+		atomicStore64(getCellSequence(queue, (int64_t)i), (int64_t)i);
+	atomicStore64(&queue->enqueuePos, 0);
+	atomicStore64(&queue->dequeuePos, 0);
+	return queue;
+}
+void destroyLockFreeQueue(LockFreeQueue queue)
+{
+	if (!queue)
+		return;
+
+	free(queue->cells);
+	free(queue);
+}
+
+//**********************************************************************************************************************
+size_t getLockFreeQueueCapacity(LockFreeQueue queue)
+{
+	assert(queue);
+	return (size_t)queue->mask + 1;
+}
+size_t getLockFreeQueueItemSize(LockFreeQueue queue)
+{
+	assert(queue);
+	return queue->itemSize;
+}
+/*
+ * Note: position loads and swaps are sequentially consistent, thread pool checks the queue size after
+ * announcing a sleeping or space waiting thread, and the other side checks that count after the swap.
+ */
+size_t getLockFreeQueueSize(LockFreeQueue queue)
+{
+	assert(queue);
+	int64_t dequeuePos = atomicLoad64(&queue->dequeuePos);
+	int64_t enqueuePos = atomicLoad64(&queue->enqueuePos);
+	return enqueuePos > dequeuePos ? (size_t)(enqueuePos - dequeuePos) : 0;
+}
+
+//**********************************************************************************************************************
+bool tryPushLockFreeQueue(LockFreeQueue queue, const void* item)
+{
+	assert(queue);
+	assert(item);
+
+	int64_t mask = queue->mask;
+	int64_t position = atomicLoadExplicit64(&queue->enqueuePos, ATOMIC_RELAXED);
+
+	while (true)
+	{
+		int64_t sequence = atomicLoadExplicit64(getCellSequence(queue, position & mask), ATOMIC_ACQUIRE);
+		int64_t difference = sequence - position;
+
+		if (difference == 0)
+		{
+			if (atomicCompareExchangeWeakExplicit64(&queue->enqueuePos, &position, position + 1, ATOMIC_SEQ_CST))
+				break;
+		}
+		else if (difference < 0)
+		{
+			return false; // Note: cell is still filled from the previous lap.
+		}
+		else
+		{
+			position = atomicLoadExplicit64(&queue->enqueuePos, ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(getCellItem(queue, position & mask), item, queue->itemSize);
+	atomicStoreExplicit64(getCellSequence(queue, position & mask), position + 1, ATOMIC_RELEASE);
+	return true;
+}
+bool tryPopLockFreeQueue(LockFreeQueue queue, void* item)
+{
+	assert(queue);
+	assert(item);
+
+	int64_t mask = queue->mask;
+	int64_t position = atomicLoadExplicit64(&queue->dequeuePos, ATOMIC_RELAXED);
+
+	while (true)
+	{
+		int64_t sequence = atomicLoadExplicit64(getCellSequence(queue, position & mask), ATOMIC_ACQUIRE);
+		int64_t difference = sequence - (position + 1);
+
+		if (difference == 0)
+		{
+			if (atomicCompareExchangeWeakExplicit64(&queue->dequeuePos, &position, position + 1, ATOMIC_SEQ_CST))
+				break;
+		}
+		else if (difference < 0)
+		{
+			return false; // Note: cell is not yet filled for the current lap.
+		}
+		else
+		{
+			position = atomicLoadExplicit64(&queue->dequeuePos, ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(item, getCellItem(queue, position & mask), queue->itemSize);
+	atomicStoreExplicit64(getCellSequence(queue, position & mask), position + mask + 1, ATOMIC_RELEASE);
+	return true;
+}
@@ -13,69 +13,295 @@
 // limitations under the License.
 
 #include "mpmt/sync.h"
+#include "mpmt/atomic.h"
+#include "mpmt/defines.h"
+#include "mpmt/spinlock.h"
+#include "mpmt/topology.h"
 #include <assert.h>
 #include <stdlib.h>
 
 #if __linux__ || __APPLE__
+#include <errno.h>
 #include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#define THREAD_LOCAL __thread
 #define MUTEX pthread_mutex_t
 #define COND pthread_cond_t
+#define RW_LOCK pthread_rwlock_t
 #elif _WIN32
 #include <windows.h>
 #define MUTEX CRITICAL_SECTION
 #define COND CONDITION_VARIABLE
+#define RW_LOCK SRWLOCK
+#define THREAD_LOCAL __declspec(thread)
 #else
 #error Unknown operating system
 #endif
 
-struct Mutex_T
+#if __linux__ && defined(MPMT_USE_FUTEX)
+#define USE_FUTEX 1
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#define USE_FUTEX 0
+#endif
+
+#if USE_FUTEX
+#define MUTEX_UNLOCKED 0
+#define MUTEX_LOCKED 1
+#define MUTEX_CONTENDED 2
+#define MAX_SPIN_COUNT 100
+
+typedef struct MutexData
+{
+	atomic_int32 state;
+	atomic_int32 spinCount;
+	#ifndef NDEBUG
+	volatile bool isLocked;
+	#endif
+} MutexData;
+
+typedef struct CondData
+{
+	atomic_int32 sequence;
+	atomic_int32 waiterCount;
+} CondData;
+
+#define RW_LOCK_WRITER 0x40000000
+
+// Note: state is the reader count or the writer flag, writer count includes waiting and owning writers.
+typedef struct RwLockData
+{
+	atomic_int32 state;
+	atomic_int32 writerCount;
+	atomic_int32 readSequence;
+	atomic_int32 readerWaitCount;
+} RwLockData;
+#else
+typedef struct MutexData
 {
 	MUTEX handle;
 	#ifndef NDEBUG
 	volatile bool isLocked;
 	#endif
-};
+} MutexData;
 
-struct Cond_T
+typedef struct CondData
 {
 	COND handle;
+} CondData;
+
+typedef struct RwLockData
+{
+	RW_LOCK handle;
+} RwLockData;
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+typedef struct DistRwLockSlot
+{
+	atomic_int32 readerCount;
+	uint8_t _padding[CACHE_LINE_SIZE - sizeof(int32_t)];
+} DistRwLockSlot;
+
+struct DistRwLock_T
+{
+	Mutex_T writeMutex;
+	Mutex_T waitMutex;
+	Cond_T readCond;
+	Cond_T drainCond;
+	atomic_int32 isWriting;
+	uint32_t slotMask;
+	DistRwLockSlot* slots;
+	void* slotMemory;
 };
 
-Mutex createMutex()
+static atomic_int32 threadSlotCounter = 0;
+static THREAD_LOCAL uint32_t threadSlot = 0;
+
+// Note: internal data should fit into the public storage on all platforms and configurations.
+typedef char MutexSizeCheck[sizeof(MutexData) <= sizeof(Mutex_T) ? 1 : -1];
+typedef char CondSizeCheck[sizeof(CondData) <= sizeof(Cond_T) ? 1 : -1];
+typedef char RwLockSizeCheck[sizeof(RwLockData) <= sizeof(RwLock_T) ? 1 : -1];
+
+#if USE_FUTEX
+//**********************************************************************************************************************
+static void waitFutex(atomic_int32* address, int32_t value, const struct timespec* timeout)
 {
-	Mutex mutex = malloc(sizeof(Mutex_T));
-	if (!mutex)
-		return NULL;
+	if (syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, value, timeout, NULL, 0) == 0)
+		return;
+	if (errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+		abort();
+}
+static void wakeFutex(atomic_int32* address, int32_t count)
+{
+	if (syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0) == -1)
+		abort();
+}
 
-	#if __linux__ || __APPLE__
-	if (pthread_mutex_init(&mutex->handle, NULL) != 0)
+static atomic_int32 maxSpinLimit = -1;
+
+// Note: spinning is useless on a single CPU, lock owner can't release the mutex meanwhile.
+static int32_t getMaxSpinLimit()
+{
+	int32_t spinLimit = atomicLoadExplicit32(&maxSpinLimit, ATOMIC_RELAXED);
+	if (spinLimit >= 0)
+		return spinLimit;
+
+	spinLimit = getLogicalCpuCount() > 1 ? MAX_SPIN_COUNT : 0;
+	atomicStoreExplicit32(&maxSpinLimit, spinLimit, ATOMIC_RELAXED);
+	return spinLimit;
+}
+
+// Note: sets contended state, so that the unlocking thread will wake up the next waiter.
+static void lockContendedMutex(MutexData* mutex)
+{
+	while (atomicExchangeExplicit32(&mutex->state, MUTEX_CONTENDED, ATOMIC_ACQUIRE) != MUTEX_UNLOCKED)
+		waitFutex(&mutex->state, MUTEX_CONTENDED, NULL);
+}
+static void lockFutexMutex(MutexData* mutex)
+{
+	int32_t state = MUTEX_UNLOCKED;
+	if (atomicCompareExchangeExplicit32(&mutex->state, &state, MUTEX_LOCKED, ATOMIC_ACQUIRE))
+		return;
+
+	// Note: adaptive spinning, the spin limit follows the average spin count of the previous locks.
+	int32_t spinCount = atomicLoadExplicit32(&mutex->spinCount, ATOMIC_RELAXED);
+	int32_t maxSpinCount = spinCount * 2 + 10, spinLimit = getMaxSpinLimit();
+	if (maxSpinCount > spinLimit)
+		maxSpinCount = spinLimit;
+
+	int32_t spin = 0;
+	bool isLocked = false;
+
+	while (spin < maxSpinCount)
 	{
-		free(mutex);
-		return NULL;
+		spin++;
+		spinPause();
+
+		state = atomicLoadExplicit32(&mutex->state, ATOMIC_RELAXED);
+		if (state == MUTEX_UNLOCKED &&
+			atomicCompareExchangeExplicit32(&mutex->state, &state, MUTEX_LOCKED, ATOMIC_ACQUIRE))
+		{
+			isLocked = true;
+			break;
+		}
+	}
+
+	if (!isLocked)
+		lockContendedMutex(mutex);
+
+	// Note: updating the estimate while holding the lock.
+	atomicStoreExplicit32(&mutex->spinCount, spinCount + (spin - spinCount) / 8, ATOMIC_RELAXED);
+}
+static void unlockFutexMutex(MutexData* mutex)
+{
+	if (atomicExchangeExplicit32(&mutex->state, MUTEX_UNLOCKED, ATOMIC_RELEASE) == MUTEX_CONTENDED)
+		wakeFutex(&mutex->state, 1);
+}
+
+static void waitFutexCond(CondData* cond, MutexData* mutex, const struct timespec* timeout)
+{
+	// Note: sequence is read under the mutex, so that signals after the unlock are not lost.
+	int32_t sequence = atomicLoad32(&cond->sequence);
+	atomicFetchAdd32(&cond->waiterCount, 1);
+
+	// Note: waiter count is consumed by the notifying threads, so that woken waiters are not notified twice.
+	unlockFutexMutex(mutex);
+	waitFutex(&cond->sequence, sequence, timeout);
+
+	// Note: unchanged sequence means timeout or interrupt, releasing own count if no notifier has taken it.
+	if (atomicLoad32(&cond->sequence) == sequence)
+	{
+		int32_t waiterCount = atomicLoad32(&cond->waiterCount);
+		while (waiterCount > 0)
+		{
+			if (atomicCompareExchange32(&cond->waiterCount, &waiterCount, waiterCount - 1))
+				break;
+		}
+	}
+	lockFutexMutex(mutex);
+}
+
+// Note: readers are sleeping while there are writers, the last writer wakes them up.
+static void releaseRwLockWriter(RwLockData* rwLock)
+{
+	if (atomicFetchAdd32(&rwLock->writerCount, -1) != 1)
+	{
+		wakeFutex(&rwLock->state, 1);
+		return;
+	}
+
+	if (atomicLoad32(&rwLock->readerWaitCount) > 0)
+	{
+		atomicFetchAdd32(&rwLock->readSequence, 1);
+		wakeFutex(&rwLock->readSequence, INT32_MAX);
 	}
+}
+#endif
+
+
+//**********************************************************************************************************************
+bool initMutex(Mutex mutex)
+{
+	assert(mutex);
+	MutexData* mutexData = (MutexData*)mutex;
+
+	#if USE_FUTEX
+	mutexData->state = MUTEX_UNLOCKED;
+	mutexData->spinCount = 0;
+	#elif __linux__ || __APPLE__
+	if (pthread_mutex_init(&mutexData->handle, NULL) != 0)
+		return false;
 	#elif _WIN32
-	InitializeCriticalSection(&mutex->handle);
+	InitializeCriticalSection(&mutexData->handle);
 	#endif
 
 	#ifndef NDEBUG
-	mutex->isLocked = false;
+	mutexData->isLocked = false;
 	#endif
-	return mutex;
+	return true;
 }
-void destroyMutex(Mutex mutex)
+void deinitMutex(Mutex mutex)
 {
-	if (!mutex)
-		return;
+	assert(mutex);
+	MutexData* mutexData = (MutexData*)mutex;
 
 	#ifndef NDEBUG
-	assert(!mutex->isLocked);
+	assert(!mutexData->isLocked);
 	#endif
 
-	#if __linux__ || __APPLE__
-	if (pthread_mutex_destroy(&mutex->handle) != 0) abort();
+	#if USE_FUTEX
+	assert(mutexData->state == MUTEX_UNLOCKED);
+	#elif __linux__ || __APPLE__
+	if (pthread_mutex_destroy(&mutexData->handle) != 0) abort();
 	#elif _WIN32
-	DeleteCriticalSection(&mutex->handle);
+	DeleteCriticalSection(&mutexData->handle);
 	#endif
+}
+
+Mutex createMutex()
+{
+	Mutex mutex = malloc(sizeof(Mutex_T));
+	if (!mutex)
+		return NULL;
+
+	if (!initMutex(mutex))
+	{
+		free(mutex);
+		return NULL;
+	}
+	return mutex;
+}
+void destroyMutex(Mutex mutex)
+{
+	if (!mutex)
+		return;
+
+	deinitMutex(mutex);
 	free(mutex);
 }
 
@@ -83,69 +309,104 @@ void destroyMutex(Mutex mutex)
 void lockMutex(Mutex mutex)
 {
 	assert(mutex);
+	MutexData* mutexData = (MutexData*)mutex;
 
-	#if __linux__ || __APPLE__
-	if (pthread_mutex_lock(&mutex->handle) != 0) abort();
+	#if USE_FUTEX
+	lockFutexMutex(mutexData);
+	#elif __linux__ || __APPLE__
+	if (pthread_mutex_lock(&mutexData->handle) != 0) abort();
 	#elif _WIN32
-	EnterCriticalSection(&mutex->handle);
+	EnterCriticalSection(&mutexData->handle);
 	#endif
 
 	#ifndef NDEBUG
-	mutex->isLocked = true;
+	mutexData->isLocked = true;
 	#endif
 }
 void unlockMutex(Mutex mutex)
 {
 	assert(mutex);
+	MutexData* mutexData = (MutexData*)mutex;
 
-	#if __linux__ || __APPLE__
-	if (pthread_mutex_unlock(&mutex->handle) != 0) abort();
-	#elif _WIN32
-	LeaveCriticalSection(&mutex->handle);
+	#ifndef NDEBUG
+	mutexData->isLocked = false;
 	#endif
 
-	#ifndef NDEBUG
-	mutex->isLocked = false;
+	#if USE_FUTEX
+	unlockFutexMutex(mutexData);
+	#elif __linux__ || __APPLE__
+	if (pthread_mutex_unlock(&mutexData->handle) != 0) abort();
+	#elif _WIN32
+	LeaveCriticalSection(&mutexData->handle);
 	#endif
 }
 bool tryLockMutex(Mutex mutex)
 {
 	assert(mutex);
+	MutexData* mutexData = (MutexData*)mutex;
 
-	#if __linux__ || __APPLE__
-	bool result = pthread_mutex_trylock(&mutex->handle) == 0;
+	#if USE_FUTEX
+	int32_t state = MUTEX_UNLOCKED;
+	bool result = atomicCompareExchange32(&mutexData->state, &state, MUTEX_LOCKED);
+	#elif __linux__ || __APPLE__
+	bool result = pthread_mutex_trylock(&mutexData->handle) == 0;
 	#elif _WIN32
-	bool result = TryEnterCriticalSection(&mutex->handle) == TRUE;
+	bool result = TryEnterCriticalSection(&mutexData->handle) == TRUE;
 	#endif
 
 	#ifndef NDEBUG
 	if (result)
-		mutex->isLocked = true;
+		mutexData->isLocked = true;
 	#endif
 	return result;
 }
 
 const void* getMutexNative(Mutex mutex)
 {
-	return &mutex->handle;
+	#if USE_FUTEX
+	return (const void*)&((MutexData*)mutex)->state;
+	#else
+	return &((MutexData*)mutex)->handle;
+	#endif
 }
 
 //**********************************************************************************************************************
+bool initCond(Cond cond)
+{
+	assert(cond);
+	CondData* condData = (CondData*)cond;
+
+	#if USE_FUTEX
+	condData->sequence = 0;
+	condData->waiterCount = 0;
+	#elif __linux__ || __APPLE__
+	if (pthread_cond_init(&condData->handle, NULL) != 0)
+		return false;
+	#elif _WIN32
+	InitializeConditionVariable(&condData->handle);
+	#endif
+	return true;
+}
+void deinitCond(Cond cond)
+{
+	assert(cond);
+
+	#if !USE_FUTEX && (__linux__ || __APPLE__)
+	if (pthread_cond_destroy(&((CondData*)cond)->handle) != 0) abort();
+	#endif
+}
+
 Cond createCond()
 {
 	Cond cond = malloc(sizeof(Cond_T));
 	if (!cond)
 		return NULL;
 
-	#if __linux__ || __APPLE__
-	if (pthread_cond_init(&cond->handle, NULL) != 0)
+	if (!initCond(cond))
 	{
 		free(cond);
 		return NULL;
 	}
-	#elif _WIN32
-	InitializeConditionVariable(&cond->handle);
-	#endif
 	return cond;
 }
 void destroyCond(Cond cond)
@@ -153,28 +414,46 @@ void destroyCond(Cond cond)
 	if (!cond)
 		return;
 
-	#if __linux__ || __APPLE__
-	if (pthread_cond_destroy(&cond->handle) != 0) abort();
-	#endif
+	deinitCond(cond);
 	free(cond);
 }
 
+//**********************************************************************************************************************
 void signalCond(Cond cond)
 {
 	assert(cond);
-	#if __linux__ || __APPLE__
-	if (pthread_cond_signal(&cond->handle) != 0) abort();
+	CondData* condData = (CondData*)cond;
+
+	#if USE_FUTEX
+	atomicFetchAdd32(&condData->sequence, 1);
+	int32_t waiterCount = atomicLoad32(&condData->waiterCount);
+	while (waiterCount > 0)
+	{
+		if (atomicCompareExchange32(&condData->waiterCount, &waiterCount, waiterCount - 1))
+		{
+			wakeFutex(&condData->sequence, 1);
+			break;
+		}
+	}
+	#elif __linux__ || __APPLE__
+	if (pthread_cond_signal(&condData->handle) != 0) abort();
 	#elif _WIN32
-	WakeConditionVariable(&cond->handle);
+	WakeConditionVariable(&condData->handle);
 	#endif
 }
 void broadcastCond(Cond cond)
 {
 	assert(cond);
-	#if __linux__ || __APPLE__
-	if (pthread_cond_broadcast(&cond->handle) != 0) abort();
+	CondData* condData = (CondData*)cond;
+
+	#if USE_FUTEX
+	atomicFetchAdd32(&condData->sequence, 1);
+	if (atomicLoad32(&condData->waiterCount) > 0 && atomicExchange32(&condData->waiterCount, 0) > 0)
+		wakeFutex(&condData->sequence, INT32_MAX);
+	#elif __linux__ || __APPLE__
+	if (pthread_cond_broadcast(&condData->handle) != 0) abort();
 	#elif _WIN32
-	WakeAllConditionVariable(&cond->handle);
+	WakeAllConditionVariable(&condData->handle);
 	#endif
 }
 
@@ -182,12 +461,26 @@ void waitCond(Cond cond, Mutex mutex)
 {
 	assert(cond);
 	assert(mutex);
+	CondData* condData = (CondData*)cond;
+	MutexData* mutexData = (MutexData*)mutex;
 
-	#if __linux__ || __APPLE__
-	if (pthread_cond_wait(&cond->handle, &mutex->handle) != 0) abort();
+	// Note: mutex is released while waiting, so the other threads can lock and unlock it meanwhile.
+	#ifndef NDEBUG
+	assert(mutexData->isLocked);
+	mutexData->isLocked = false;
+	#endif
+
+	#if USE_FUTEX
+	waitFutexCond(condData, mutexData, NULL);
+	#elif __linux__ || __APPLE__
+	if (pthread_cond_wait(&condData->handle, &mutexData->handle) != 0) abort();
 	#elif _WIN32
-	if (SleepConditionVariableCS(&cond->handle,
-		&mutex->handle, INFINITE) != TRUE) abort();
+	if (SleepConditionVariableCS(&condData->handle,
+		&mutexData->handle, INFINITE) != TRUE) abort();
+	#endif
+
+	#ifndef NDEBUG
+	mutexData->isLocked = true;
 	#endif
 }
 void waitCondFor(Cond cond, Mutex mutex, double timeout)
@@ -195,22 +488,430 @@ void waitCondFor(Cond cond, Mutex mutex, double timeout)
 	assert(cond);
 	assert(mutex);
 	assert(timeout >= 0.0);
-	assert(mutex->isLocked);
+	CondData* condData = (CondData*)cond;
+	MutexData* mutexData = (MutexData*)mutex;
 
-	#if __linux__ || __APPLE__
+	#ifndef NDEBUG
+	assert(mutexData->isLocked);
+	mutexData->isLocked = false;
+	#endif
+
+	#if USE_FUTEX
 	struct timespec delay;
-	delay.tv_sec = time(NULL) + (time_t)timeout;
+	delay.tv_sec = (time_t)timeout;
 	delay.tv_nsec = (long)((timeout - (double)delay.tv_sec) * 1000000000.0);
+	waitFutexCond(condData, mutexData, &delay);
+	#elif __linux__ || __APPLE__
+	// Note: condition variable uses absolute realtime clock deadline.
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += (time_t)timeout;
+	deadline.tv_nsec += (long)((timeout - (double)(time_t)timeout) * 1000000000.0);
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
 
-	if (pthread_cond_timedwait(&cond->handle, &mutex->handle, &delay) != 0)
-		abort();
+	int result = pthread_cond_timedwait(&condData->handle, &mutexData->handle, &deadline);
+	if (result != 0 && result != ETIMEDOUT) abort();
 	#elif _WIN32
-	if (SleepConditionVariableCS(&cond->handle, &mutex->handle,
-		(DWORD)(timeout * 1000.0)) != TRUE) abort();
+	if (SleepConditionVariableCS(&condData->handle, &mutexData->handle,
+		(DWORD)(timeout * 1000.0)) != TRUE && GetLastError() != ERROR_TIMEOUT) abort();
+	#endif
+
+	#ifndef NDEBUG
+	mutexData->isLocked = true;
 	#endif
 }
 
 const void* getCondNative(Cond cond)
 {
-	return &cond->handle;
+	#if USE_FUTEX
+	return (const void*)&((CondData*)cond)->sequence;
+	#else
+	return &((CondData*)cond)->handle;
+	#endif
+}
+
+//**********************************************************************************************************************
+bool initRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	rwLockData->state = 0;
+	rwLockData->writerCount = 0;
+	rwLockData->readSequence = 0;
+	rwLockData->readerWaitCount = 0;
+	#elif __linux__ || __APPLE__
+	pthread_rwlockattr_t attributes;
+	if (pthread_rwlockattr_init(&attributes) != 0)
+		return false;
+	#ifdef __GLIBC__
+	// Note: glibc prefers readers by default, which can starve writers.
+	pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+	#endif
+	bool result = pthread_rwlock_init(&rwLockData->handle, &attributes) == 0;
+	pthread_rwlockattr_destroy(&attributes);
+	if (!result)
+		return false;
+	#elif _WIN32
+	InitializeSRWLock(&rwLockData->handle);
+	#endif
+	return true;
+}
+void deinitRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+
+	#if USE_FUTEX
+	assert(((RwLockData*)rwLock)->state == 0);
+	#elif __linux__ || __APPLE__
+	if (pthread_rwlock_destroy(&((RwLockData*)rwLock)->handle) != 0) abort();
+	#endif
+}
+
+RwLock createRwLock()
+{
+	RwLock rwLock = malloc(sizeof(RwLock_T));
+	if (!rwLock)
+		return NULL;
+
+	if (!initRwLock(rwLock))
+	{
+		free(rwLock);
+		return NULL;
+	}
+	return rwLock;
+}
+void destroyRwLock(RwLock rwLock)
+{
+	if (!rwLock)
+		return;
+
+	deinitRwLock(rwLock);
+	free(rwLock);
+}
+
+//**********************************************************************************************************************
+void readLockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	while (true)
+	{
+		if (atomicLoad32(&rwLockData->writerCount) == 0)
+		{
+			int32_t state = atomicLoad32(&rwLockData->state);
+			if (!(state & RW_LOCK_WRITER) && atomicCompareExchange32(&rwLockData->state, &state, state + 1))
+				return;
+			continue;
+		}
+
+		atomicFetchAdd32(&rwLockData->readerWaitCount, 1);
+		int32_t sequence = atomicLoad32(&rwLockData->readSequence);
+		if (atomicLoad32(&rwLockData->writerCount) != 0)
+			waitFutex(&rwLockData->readSequence, sequence, NULL);
+		atomicFetchAdd32(&rwLockData->readerWaitCount, -1);
+	}
+	#elif __linux__ || __APPLE__
+	if (pthread_rwlock_rdlock(&rwLockData->handle) != 0) abort();
+	#elif _WIN32
+	AcquireSRWLockShared(&rwLockData->handle);
+	#endif
+}
+void readUnlockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	// Note: last reader wakes up one of the waiting writers.
+	if (atomicFetchAdd32(&rwLockData->state, -1) == 1 && atomicLoad32(&rwLockData->writerCount) > 0)
+		wakeFutex(&rwLockData->state, 1);
+	#elif __linux__ || __APPLE__
+	if (pthread_rwlock_unlock(&rwLockData->handle) != 0) abort();
+	#elif _WIN32
+	ReleaseSRWLockShared(&rwLockData->handle);
+	#endif
+}
+bool tryReadLockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	if (atomicLoad32(&rwLockData->writerCount) != 0)
+		return false;
+	int32_t state = atomicLoad32(&rwLockData->state);
+	return !(state & RW_LOCK_WRITER) && atomicCompareExchange32(&rwLockData->state, &state, state + 1);
+	#elif __linux__ || __APPLE__
+	return pthread_rwlock_tryrdlock(&rwLockData->handle) == 0;
+	#elif _WIN32
+	return TryAcquireSRWLockShared(&rwLockData->handle) != FALSE;
+	#endif
+}
+
+void writeLockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	// Note: writer count blocks new readers, so that the state eventually becomes free.
+	atomicFetchAdd32(&rwLockData->writerCount, 1);
+
+	while (true)
+	{
+		int32_t state = 0;
+		if (atomicCompareExchange32(&rwLockData->state, &state, RW_LOCK_WRITER))
+			return;
+		waitFutex(&rwLockData->state, state, NULL);
+	}
+	#elif __linux__ || __APPLE__
+	if (pthread_rwlock_wrlock(&rwLockData->handle) != 0) abort();
+	#elif _WIN32
+	AcquireSRWLockExclusive(&rwLockData->handle);
+	#endif
+}
+void writeUnlockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	atomicStore32(&rwLockData->state, 0);
+	releaseRwLockWriter(rwLockData);
+	#elif __linux__ || __APPLE__
+	if (pthread_rwlock_unlock(&rwLockData->handle) != 0) abort();
+	#elif _WIN32
+	ReleaseSRWLockExclusive(&rwLockData->handle);
+	#endif
+}
+bool tryWriteLockRwLock(RwLock rwLock)
+{
+	assert(rwLock);
+	RwLockData* rwLockData = (RwLockData*)rwLock;
+
+	#if USE_FUTEX
+	atomicFetchAdd32(&rwLockData->writerCount, 1);
+	int32_t state = 0;
+	if (atomicCompareExchange32(&rwLockData->state, &state, RW_LOCK_WRITER))
+		return true;
+	releaseRwLockWriter(rwLockData);
+	return false;
+	#elif __linux__ || __APPLE__
+	return pthread_rwlock_trywrlock(&rwLockData->handle) == 0;
+	#elif _WIN32
+	return TryAcquireSRWLockExclusive(&rwLockData->handle) != FALSE;
+	#endif
+}
+
+//**********************************************************************************************************************
+// Note: each thread gets its own slot once, so that unlock always decrements the same counter as lock.
+static DistRwLockSlot* getThreadSlot(DistRwLock distRwLock)
+{
+	uint32_t slot = threadSlot;
+	if (slot == 0)
+	{
+		slot = (uint32_t)atomicFetchAddExplicit32(&threadSlotCounter, 1, ATOMIC_RELAXED) + 1;
+		threadSlot = slot;
+	}
+	return &distRwLock->slots[(slot - 1) & distRwLock->slotMask];
+}
+static uint32_t getSlotCount()
+{
+	size_t cpuCount = getLogicalCpuCount();
+
+	uint32_t slotCount = 1;
+	while ((size_t)slotCount < cpuCount && slotCount < 1024)
+		slotCount <<= 1;
+	return slotCount;
+}
+
+static bool hasDistRwLockReaders(DistRwLock distRwLock)
+{
+	DistRwLockSlot* slots = distRwLock->slots;
+	uint32_t slotCount = distRwLock->slotMask + 1;
+
+	for (uint32_t i = 0; i < slotCount; i++)
+	{
+		if (atomicLoad32(&slots[i].readerCount) != 0)
+			return true;
+	}
+	return false;
+}
+static void releaseDistRwLockReader(DistRwLock distRwLock, DistRwLockSlot* slot)
+{
+	atomicFetchAdd32(&slot->readerCount, -1);
+	if (atomicLoad32(&distRwLock->isWriting) == 0)
+		return;
+
+	Mutex waitMutex = &distRwLock->waitMutex;
+	lockMutex(waitMutex);
+	broadcastCond(&distRwLock->drainCond);
+	unlockMutex(waitMutex);
+}
+
+DistRwLock createDistRwLock(size_t slotCount)
+{
+	if (slotCount == 0)
+		slotCount = getSlotCount();
+
+	uint32_t slotCapacity = 1;
+	while (slotCapacity < slotCount)
+		slotCapacity <<= 1;
+
+	DistRwLock distRwLock = calloc(1, sizeof(DistRwLock_T));
+	if (!distRwLock)
+		return NULL;
+
+	void* slotMemory = calloc(1, slotCapacity * sizeof(DistRwLockSlot) + CACHE_LINE_SIZE);
+	if (!slotMemory)
+	{
+		free(distRwLock);
+		return NULL;
+	}
+
+	// Note: aligning slots to the cache line, so that each reader counter has its own line.
+	size_t slotAddress = ((size_t)slotMemory + (CACHE_LINE_SIZE - 1)) & ~(size_t)(CACHE_LINE_SIZE - 1);
+	distRwLock->slots = (DistRwLockSlot*)slotAddress;
+	distRwLock->slotMemory = slotMemory;
+	distRwLock->slotMask = slotCapacity - 1;
+
+	if (!initMutex(&distRwLock->writeMutex))
+	{
+		free(slotMemory);
+		free(distRwLock);
+		return NULL;
+	}
+	if (!initMutex(&distRwLock->waitMutex))
+	{
+		deinitMutex(&distRwLock->writeMutex);
+		free(slotMemory);
+		free(distRwLock);
+		return NULL;
+	}
+	if (!initCond(&distRwLock->readCond))
+	{
+		deinitMutex(&distRwLock->waitMutex);
+		deinitMutex(&distRwLock->writeMutex);
+		free(slotMemory);
+		free(distRwLock);
+		return NULL;
+	}
+	if (!initCond(&distRwLock->drainCond))
+	{
+		deinitCond(&distRwLock->readCond);
+		deinitMutex(&distRwLock->waitMutex);
+		deinitMutex(&distRwLock->writeMutex);
+		free(slotMemory);
+		free(distRwLock);
+		return NULL;
+	}
+	return distRwLock;
+}
+void destroyDistRwLock(DistRwLock distRwLock)
+{
+	if (!distRwLock)
+		return;
+
+	assert(!distRwLock->isWriting);
+	assert(!hasDistRwLockReaders(distRwLock));
+
+	deinitCond(&distRwLock->drainCond);
+	deinitCond(&distRwLock->readCond);
+	deinitMutex(&distRwLock->waitMutex);
+	deinitMutex(&distRwLock->writeMutex);
+	free(distRwLock->slotMemory);
+	free(distRwLock);
+}
+
+size_t getDistRwLockSlotCount(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	return (size_t)distRwLock->slotMask + 1;
+}
+
+//**********************************************************************************************************************
+void readLockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	DistRwLockSlot* slot = getThreadSlot(distRwLock);
+
+	while (true)
+	{
+		// Note: writer sets the flag before sweeping slots, so one of us always sees the other.
+		atomicFetchAdd32(&slot->readerCount, 1);
+		if (atomicLoad32(&distRwLock->isWriting) == 0)
+			return;
+		releaseDistRwLockReader(distRwLock, slot);
+
+		Mutex waitMutex = &distRwLock->waitMutex;
+		lockMutex(waitMutex);
+		while (atomicLoad32(&distRwLock->isWriting) != 0)
+			waitCond(&distRwLock->readCond, waitMutex);
+		unlockMutex(waitMutex);
+	}
+}
+void readUnlockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	releaseDistRwLockReader(distRwLock, getThreadSlot(distRwLock));
+}
+bool tryReadLockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	if (atomicLoad32(&distRwLock->isWriting) != 0)
+		return false;
+
+	DistRwLockSlot* slot = getThreadSlot(distRwLock);
+	atomicFetchAdd32(&slot->readerCount, 1);
+	if (atomicLoad32(&distRwLock->isWriting) == 0)
+		return true;
+
+	releaseDistRwLockReader(distRwLock, slot);
+	return false;
+}
+
+void writeLockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	lockMutex(&distRwLock->writeMutex);
+	atomicStore32(&distRwLock->isWriting, 1);
+
+	Mutex waitMutex = &distRwLock->waitMutex;
+	lockMutex(waitMutex);
+	while (hasDistRwLockReaders(distRwLock))
+		waitCond(&distRwLock->drainCond, waitMutex);
+	unlockMutex(waitMutex);
+}
+void writeUnlockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+
+	Mutex waitMutex = &distRwLock->waitMutex;
+	lockMutex(waitMutex);
+	atomicStore32(&distRwLock->isWriting, 0);
+	broadcastCond(&distRwLock->readCond);
+	unlockMutex(waitMutex);
+
+	unlockMutex(&distRwLock->writeMutex);
+}
+bool tryWriteLockDistRwLock(DistRwLock distRwLock)
+{
+	assert(distRwLock);
+	if (!tryLockMutex(&distRwLock->writeMutex))
+		return false;
+
+	atomicStore32(&distRwLock->isWriting, 1);
+	if (!hasDistRwLockReaders(distRwLock))
+		return true;
+
+	writeUnlockDistRwLock(distRwLock);
+	return false;
 }
\ No newline at end of file
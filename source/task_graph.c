@@ -0,0 +1,333 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/task_graph.h"
+#include "mpmt/atomic.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE_SIZE 64
+#define MIN_GRAPH_CAPACITY 16
+
+/*
+ * Note: predecessor counter is on its own cache line, it is decremented by the other threads.
+ * Node size is a multiple of the cache line, and the node array is aligned to it.
+ */
+typedef struct GraphNode
+{
+	atomic_int64 pendingCount;
+	uint8_t _pendingPadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	TaskGraph taskGraph;
+	ThreadPoolTask task;
+	size_t predecessorCount;
+	size_t successorOffset;
+	size_t successorCount;
+	uint8_t _nodePadding[CACHE_LINE_SIZE - sizeof(TaskGraph) - sizeof(ThreadPoolTask) - sizeof(size_t) * 3];
+} GraphNode;
+
+typedef char GraphNodeSizeCheck[sizeof(GraphNode) % CACHE_LINE_SIZE == 0 ? 1 : -1];
+
+typedef struct GraphEdge
+{
+	size_t predecessor;
+	size_t successor;
+} GraphEdge;
+
+struct TaskGraph_T
+{
+	TaskGroup taskGroup;
+	GraphNode* nodes;
+	void* nodeMemory;
+	GraphEdge* edges;
+	GraphNode** successors;
+	ThreadPoolTask* rootTasks;
+	size_t nodeCount;
+	size_t nodeCapacity;
+	size_t edgeCount;
+	size_t edgeCapacity;
+	size_t rootCount;
+	bool isBuilt;
+};
+
+//**********************************************************************************************************************
+static void onGraphNodeTask(void* argument)
+{
+	GraphNode* node = (GraphNode*)argument;
+	TaskGraph taskGraph = node->taskGraph;
+	GraphNode** successors = taskGraph->successors;
+
+	// Note: continuing with one of the released successors on the same thread, skipping the pool queue.
+	while (node)
+	{
+		// Note: restoring the counter for the next run, all of the node predecessors are already completed.
+		atomicStoreExplicit64(&node->pendingCount, (int64_t)node->predecessorCount, ATOMIC_RELAXED);
+		node->task.function(node->task.argument);
+
+		GraphNode** nodeSuccessors = successors + node->successorOffset;
+		size_t successorCount = node->successorCount;
+		GraphNode* nextNode = NULL;
+
+		for (size_t i = 0; i < successorCount; i++)
+		{
+			GraphNode* successor = nodeSuccessors[i];
+			if (atomicFetchAddExplicit64(&successor->pendingCount, -1, ATOMIC_ACQ_REL) != 1)
+				continue;
+
+			if (!nextNode)
+			{
+				nextNode = successor;
+				continue;
+			}
+
+			ThreadPoolTask task = { onGraphNodeTask, successor };
+			addTaskGroupTask(taskGraph->taskGroup, task);
+		}
+
+		node = nextNode;
+	}
+}
+
+//**********************************************************************************************************************
+// Note: building successor lists in the compressed form, and checking for cycles with the topological sort.
+static bool buildTaskGraph(TaskGraph taskGraph)
+{
+	GraphNode* nodes = taskGraph->nodes;
+	const GraphEdge* edges = taskGraph->edges;
+	size_t nodeCount = taskGraph->nodeCount;
+	size_t edgeCount = taskGraph->edgeCount;
+
+	GraphNode** successors = malloc((edgeCount > 0 ? edgeCount : 1) * sizeof(GraphNode*));
+	ThreadPoolTask* rootTasks = malloc((nodeCount > 0 ? nodeCount : 1) * sizeof(ThreadPoolTask));
+	size_t* sortedNodes = malloc((nodeCount > 0 ? nodeCount : 1) * sizeof(size_t));
+
+	if (!successors || !rootTasks || !sortedNodes)
+	{
+		free(sortedNodes);
+		free(rootTasks);
+		free(successors);
+		return false;
+	}
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		nodes[i].predecessorCount = 0;
+		nodes[i].successorCount = 0;
+	}
+	for (size_t i = 0; i < edgeCount; i++)
+	{
+		nodes[edges[i].predecessor].successorCount++;
+		nodes[edges[i].successor].predecessorCount++;
+	}
+
+	size_t successorOffset = 0, rootCount = 0, sortedCount = 0;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		GraphNode* node = &nodes[i];
+		node->successorOffset = successorOffset;
+		successorOffset += node->successorCount;
+		node->successorCount = 0;
+		atomicStore64(&node->pendingCount, (int64_t)node->predecessorCount);
+
+		if (node->predecessorCount > 0)
+			continue;
+
+		rootTasks[rootCount].function = onGraphNodeTask;
+		rootTasks[rootCount].argument = node;
+		sortedNodes[sortedCount++] = i;
+		rootCount++;
+	}
+	for (size_t i = 0; i < edgeCount; i++)
+	{
+		GraphNode* node = &nodes[edges[i].predecessor];
+		successors[node->successorOffset + node->successorCount++] = &nodes[edges[i].successor];
+	}
+
+	for (size_t i = 0; i < sortedCount; i++)
+	{
+		const GraphNode* node = &nodes[sortedNodes[i]];
+		for (size_t j = 0; j < node->successorCount; j++)
+		{
+			GraphNode* successor = successors[node->successorOffset + j];
+			if (atomicFetchAdd64(&successor->pendingCount, -1) == 1)
+				sortedNodes[sortedCount++] = (size_t)(successor - nodes);
+		}
+	}
+	free(sortedNodes);
+
+	if (sortedCount != nodeCount)
+	{
+		free(rootTasks);
+		free(successors);
+		return false;
+	}
+
+	for (size_t i = 0; i < nodeCount; i++)
+		atomicStore64(&nodes[i].pendingCount, (int64_t)nodes[i].predecessorCount);
+
+	free(taskGraph->successors);
+	free(taskGraph->rootTasks);
+	taskGraph->successors = successors;
+	taskGraph->rootTasks = rootTasks;
+	taskGraph->rootCount = rootCount;
+	taskGraph->isBuilt = true;
+	return true;
+}
+
+//**********************************************************************************************************************
+TaskGraph createTaskGraph(ThreadPool threadPool)
+{
+	assert(threadPool);
+
+	TaskGraph taskGraph = calloc(1, sizeof(TaskGraph_T));
+	if (!taskGraph)
+		return NULL;
+
+	TaskGroup taskGroup = createTaskGroup(threadPool);
+	if (!taskGroup)
+	{
+		free(taskGraph);
+		return NULL;
+	}
+	taskGraph->taskGroup = taskGroup;
+	return taskGraph;
+}
+void destroyTaskGraph(TaskGraph taskGraph)
+{
+	if (!taskGraph)
+		return;
+
+	destroyTaskGroup(taskGraph->taskGroup);
+	free(taskGraph->rootTasks);
+	free(taskGraph->successors);
+	free(taskGraph->edges);
+	free(taskGraph->nodeMemory);
+	free(taskGraph);
+}
+
+ThreadPool getTaskGraphThreadPool(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	return getTaskGroupThreadPool(taskGraph->taskGroup);
+}
+size_t getTaskGraphNodeCount(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	return taskGraph->nodeCount;
+}
+
+//**********************************************************************************************************************
+bool addTaskGraphNode(TaskGraph taskGraph, ThreadPoolTask task, size_t* node)
+{
+	assert(taskGraph);
+	assert(task.function);
+	assert(!isTaskGroupRunning(taskGraph->taskGroup));
+
+	size_t nodeCount = taskGraph->nodeCount;
+	if (nodeCount == taskGraph->nodeCapacity)
+	{
+		size_t nodeCapacity = nodeCount > 0 ? nodeCount * 2 : MIN_GRAPH_CAPACITY;
+		void* nodeMemory = malloc(nodeCapacity * sizeof(GraphNode) + CACHE_LINE_SIZE);
+		if (!nodeMemory)
+			return false;
+
+		// Note: successor pointers are rebuilt on the next start, as the graph is changed.
+		size_t nodeAddress = ((size_t)nodeMemory + (CACHE_LINE_SIZE - 1)) & ~(size_t)(CACHE_LINE_SIZE - 1);
+		GraphNode* nodes = (GraphNode*)nodeAddress;
+		if (nodeCount > 0)
+			memcpy(nodes, taskGraph->nodes, nodeCount * sizeof(GraphNode));
+		free(taskGraph->nodeMemory);
+
+		taskGraph->nodes = nodes;
+		taskGraph->nodeMemory = nodeMemory;
+		taskGraph->nodeCapacity = nodeCapacity;
+	}
+
+	GraphNode* graphNode = &taskGraph->nodes[nodeCount];
+	graphNode->taskGraph = taskGraph;
+	graphNode->task = task;
+
+	if (node)
+		*node = nodeCount;
+	taskGraph->nodeCount = nodeCount + 1;
+	taskGraph->isBuilt = false;
+	return true;
+}
+bool addTaskGraphEdge(TaskGraph taskGraph, size_t predecessor, size_t successor)
+{
+	assert(taskGraph);
+	assert(predecessor < taskGraph->nodeCount);
+	assert(successor < taskGraph->nodeCount);
+	assert(!isTaskGroupRunning(taskGraph->taskGroup));
+
+	size_t edgeCount = taskGraph->edgeCount;
+	if (edgeCount == taskGraph->edgeCapacity)
+	{
+		size_t edgeCapacity = edgeCount > 0 ? edgeCount * 2 : MIN_GRAPH_CAPACITY;
+		GraphEdge* edges = realloc(taskGraph->edges, edgeCapacity * sizeof(GraphEdge));
+		if (!edges)
+			return false;
+
+		taskGraph->edges = edges;
+		taskGraph->edgeCapacity = edgeCapacity;
+	}
+
+	taskGraph->edges[edgeCount].predecessor = predecessor;
+	taskGraph->edges[edgeCount].successor = successor;
+	taskGraph->edgeCount = edgeCount + 1;
+	taskGraph->isBuilt = false;
+	return true;
+}
+void clearTaskGraph(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	assert(!isTaskGroupRunning(taskGraph->taskGroup));
+	taskGraph->nodeCount = 0;
+	taskGraph->edgeCount = 0;
+	taskGraph->isBuilt = false;
+}
+
+//**********************************************************************************************************************
+bool startTaskGraph(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	assert(!isTaskGroupRunning(taskGraph->taskGroup));
+
+	if (!taskGraph->isBuilt && !buildTaskGraph(taskGraph))
+		return false;
+
+	if (taskGraph->rootCount > 0)
+		addTaskGroupTasks(taskGraph->taskGroup, taskGraph->rootTasks, taskGraph->rootCount);
+	return true;
+}
+void waitTaskGraph(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	waitTaskGroup(taskGraph->taskGroup);
+}
+bool runTaskGraph(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	if (!startTaskGraph(taskGraph))
+		return false;
+
+	waitTaskGroup(taskGraph->taskGroup);
+	return true;
+}
+bool isTaskGraphRunning(TaskGraph taskGraph)
+{
+	assert(taskGraph);
+	return isTaskGroupRunning(taskGraph->taskGroup);
+}
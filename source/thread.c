@@ -12,22 +12,30 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define _GNU_SOURCE // Note: should be defined before any system header.
 #include "mpmt/thread.h"
+#include "mpmt/atomic.h"
 
 #if __linux__ || __APPLE__
-#define _GNU_SOURCE
 #include <errno.h>
+#include <limits.h>
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #elif _WIN32
 #include <windows.h>
 #else
 #error Unknown operating system
 #endif
 
+#include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#define MAX_AFFINITY_CPU_COUNT 65536
+
 #if __linux__ || __APPLE__
 #define THREAD pthread_t
 #elif _WIN32
@@ -36,56 +44,282 @@
 #error Unknown operating system
 #endif
 
+#define MAX_THREAD_NAME_LENGTH 16
+
 struct Thread_T
 {
 	void (*function)(void*);
 	void* argument;
 	THREAD handle;
+	char name[MAX_THREAD_NAME_LENGTH];
+	atomic_int32 refCount;
+	ThreadPriority priority;
 	bool joined;
+	bool isDetached;
 };
 
+// Note: name and priority can be set only by the thread itself on some platforms.
+static void runThread(Thread thread)
+{
+	if (thread->name[0] != '\0')
+		setThreadName(thread->name);
+	if (thread->priority == BACKGROUND_THREAD_PRIORITY)
+		setThreadBackgroundPriority();
+	else if (thread->priority == FOREGROUND_THREAD_PRIORITY)
+		setThreadForegroundPriority();
+
+	thread->function(thread->argument);
+
+	// Note: detached thread instance is shared with the creator, last one of them frees it.
+	if (thread->isDetached && atomicFetchAdd32(&thread->refCount, -1) == 1)
+		free(thread);
+}
+
 #if __linux__ || __APPLE__
 static void* threadFunction(void* argument)
 {
-	Thread thread = (Thread)argument;
-	thread->function(thread->argument);
+	runThread((Thread)argument);
 	return NULL;
 }
 #elif _WIN32
 DWORD threadFunction(LPVOID argument)
 {
-	Thread thread = (Thread)argument;
-	thread->function(thread->argument);
+	runThread((Thread)argument);
 	return 0;
 }
 #endif
 
+#if __linux__
+static cpu_set_t* createCpuSet(const size_t* cpus, size_t cpuCount, size_t* setSize)
+{
+	size_t setCpuCount = 0;
+	for (size_t i = 0; i < cpuCount; i++)
+	{
+		if (cpus[i] >= setCpuCount)
+			setCpuCount = cpus[i] + 1;
+	}
+
+	cpu_set_t* cpuSet = CPU_ALLOC(setCpuCount);
+	if (!cpuSet)
+		return NULL;
+
+	size_t size = CPU_ALLOC_SIZE(setCpuCount);
+	CPU_ZERO_S(size, cpuSet);
+	for (size_t i = 0; i < cpuCount; i++)
+		CPU_SET_S(cpus[i], size, cpuSet);
+
+	*setSize = size;
+	return cpuSet;
+}
+static bool setNativeAffinity(THREAD handle, const size_t* cpus, size_t cpuCount)
+{
+	size_t setSize = 0;
+	cpu_set_t* cpuSet = createCpuSet(cpus, cpuCount, &setSize);
+	if (!cpuSet)
+		return false;
+
+	int result = pthread_setaffinity_np(handle, setSize, cpuSet);
+	CPU_FREE(cpuSet);
+	return result == 0;
+}
+static size_t getNativeAffinity(THREAD handle, size_t* cpus, size_t capacity)
+{
+	size_t setCpuCount = CPU_SETSIZE;
+	while (true)
+	{
+		cpu_set_t* cpuSet = CPU_ALLOC(setCpuCount);
+		if (!cpuSet)
+			return 0;
+
+		size_t setSize = CPU_ALLOC_SIZE(setCpuCount);
+		int result = pthread_getaffinity_np(handle, setSize, cpuSet);
+		if (result != 0)
+		{
+			CPU_FREE(cpuSet);
+			if (result != EINVAL || setCpuCount >= MAX_AFFINITY_CPU_COUNT)
+				return 0;
+			setCpuCount <<= 1; // Note: kernel CPU mask is bigger than the set.
+			continue;
+		}
+
+		size_t count = 0;
+		for (size_t i = 0; i < setCpuCount; i++)
+		{
+			if (!CPU_ISSET_S(i, setSize, cpuSet))
+				continue;
+			if (count < capacity)
+				cpus[count] = i;
+			count++;
+		}
+
+		CPU_FREE(cpuSet);
+		return count;
+	}
+}
+#elif __APPLE__
+static bool setNativeAffinity(THREAD handle, const size_t* cpus, size_t cpuCount)
+{
+	return false; // Note: macOS has only affinity tag hints.
+}
+static size_t getNativeAffinity(THREAD handle, size_t* cpus, size_t capacity)
+{
+	return 0;
+}
+#elif _WIN32
+static bool setNativeAffinity(THREAD handle, const size_t* cpus, size_t cpuCount)
+{
+	DWORD_PTR mask = 0;
+	for (size_t i = 0; i < cpuCount; i++)
+	{
+		if (cpus[i] >= sizeof(DWORD_PTR) * 8)
+			return false;
+		mask |= (DWORD_PTR)1 << cpus[i];
+	}
+	return SetThreadAffinityMask(handle, mask) != 0;
+}
+static size_t getNativeAffinity(THREAD handle, size_t* cpus, size_t capacity)
+{
+	GROUP_AFFINITY affinity;
+	if (!GetThreadGroupAffinity(handle, &affinity))
+		return 0;
+
+	size_t count = 0, groupOffset = (size_t)affinity.Group * sizeof(KAFFINITY) * 8;
+	for (size_t i = 0; i < sizeof(KAFFINITY) * 8; i++)
+	{
+		if (!(affinity.Mask & ((KAFFINITY)1 << i)))
+			continue;
+		if (count < capacity)
+			cpus[count] = groupOffset + i;
+		count++;
+	}
+	return count;
+}
+#endif
+
 //**********************************************************************************************************************
+#if __linux__ || __APPLE__
+static bool initThreadAttributes(pthread_attr_t* attributes, const ThreadOptions* options)
+{
+	if (options->isDetached && pthread_attr_setdetachstate(attributes, PTHREAD_CREATE_DETACHED) != 0)
+		return false;
+
+	if (options->stack)
+	{
+		if (pthread_attr_setstack(attributes, options->stack, options->stackSize) != 0)
+			return false;
+	}
+	else if (options->stackSize > 0)
+	{
+		// Note: rounding up to the whole pages, some systems reject other sizes.
+		size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		size_t stackSize = (options->stackSize + pageSize - 1) / pageSize * pageSize;
+		size_t minStackSize = (size_t)PTHREAD_STACK_MIN; // Note: can be a signed sysconf() call.
+		if (stackSize < minStackSize)
+			stackSize = minStackSize;
+		if (pthread_attr_setstacksize(attributes, stackSize) != 0)
+			return false;
+	}
+
+	if (options->isGuardless && !options->stack && pthread_attr_setguardsize(attributes, 0) != 0)
+		return false;
+
+	if (options->cpus)
+	{
+		#if __linux__
+		size_t setSize = 0;
+		cpu_set_t* cpuSet = createCpuSet(options->cpus, options->cpuCount, &setSize);
+		if (!cpuSet)
+			return false;
+		int result = pthread_attr_setaffinity_np(attributes, setSize, cpuSet);
+		CPU_FREE(cpuSet);
+		if (result != 0)
+			return false;
+		#else
+		return false; // Note: macOS has only affinity tag hints.
+		#endif
+	}
+	return true;
+}
+#endif
+
 Thread createThread(void(*function)(void*), void* argument)
+{
+	return createThreadWithOptions(function, argument, NULL);
+}
+Thread createThreadWithOptions(void (*function)(void*), void* argument, const ThreadOptions* options)
 {
 	assert(function);
+	assert(!options || options->priority < THREAD_PRIORITY_COUNT);
+	assert(!options || !options->stack || options->stackSize > 0);
+	assert(!options || !options->cpus || options->cpuCount > 0);
+
+	ThreadOptions defaultOptions;
+	if (!options)
+	{
+		memset(&defaultOptions, 0, sizeof(ThreadOptions));
+		options = &defaultOptions;
+	}
 
 	Thread thread = malloc(sizeof(Thread_T));
 	if(!thread) return NULL;
 
 	thread->function = function;
 	thread->argument = argument;
+	thread->refCount = options->isDetached ? 2 : 1;
+	thread->priority = options->priority;
 	thread->joined = false;
+	thread->isDetached = options->isDetached;
+	thread->name[0] = '\0';
+	if (options->name) // Note: truncating longer names, the OS limit is 15 characters.
+		snprintf(thread->name, MAX_THREAD_NAME_LENGTH, "%s", options->name);
 
 	#if __linux__ || __APPLE__
-	int result = pthread_create(&thread->handle, NULL, threadFunction, thread);
+	pthread_attr_t attributes;
+	if (pthread_attr_init(&attributes) != 0)
+	{
+		free(thread);
+		return NULL;
+	}
+	if (!initThreadAttributes(&attributes, options))
+	{
+		pthread_attr_destroy(&attributes);
+		free(thread);
+		return NULL;
+	}
+
+	int result = pthread_create(&thread->handle, &attributes, threadFunction, thread);
+	pthread_attr_destroy(&attributes);
+
 	if (result != 0)
 	{
 		free(thread);
 		return NULL;
 	}
 	#elif _WIN32
-	thread->handle = CreateThread(NULL, 0, threadFunction, thread, 0, NULL);
+	if (options->stack)
+	{
+		free(thread);
+		return NULL;
+	}
+
+	// Note: starting suspended to set the affinity. Guard page can't be disabled on Windows.
+	// Note: detached thread handle is closed by the destroy call, as the instance is kept until then.
+	thread->handle = CreateThread(NULL, options->stackSize, threadFunction, thread, 
+		CREATE_SUSPENDED | (options->stackSize > 0 ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0), NULL);
 	if (thread->handle == NULL)
 	{
 		free(thread);
 		return NULL;
 	}
+	if (options->cpus && !setNativeAffinity(thread->handle, options->cpus, options->cpuCount))
+	{
+		TerminateThread(thread->handle, 0);
+		CloseHandle(thread->handle);
+		free(thread);
+		return NULL;
+	}
+
+	if (ResumeThread(thread->handle) == (DWORD)-1) abort();
 	#endif
 	return thread;
 }
@@ -97,18 +331,20 @@ void destroyThread(Thread thread)
 	if (!thread->joined)
 	{
 		#if __linux__ || __APPLE__
-		if (pthread_detach(thread->handle) != 0) abort();
+		if (!thread->isDetached && pthread_detach(thread->handle) != 0) abort();
 		#elif _WIN32
 		if (CloseHandle(thread->handle) != TRUE) abort();
 		#endif
 	}
 
-	free(thread);
+	if (!thread->isDetached || atomicFetchAdd32(&thread->refCount, -1) == 1)
+		free(thread);
 }
 
 void joinThread(Thread thread)
 {
 	assert(thread);
+	assert(!thread->isDetached);
 	if (thread->joined) abort();
 	thread->joined = true;
 
@@ -175,6 +411,20 @@ const void* getThreadNative(Thread thread)
 	return &thread->handle;
 }
 
+bool setThreadAffinity(Thread thread, const size_t* cpus, size_t cpuCount)
+{
+	assert(thread);
+	assert(cpus);
+	assert(cpuCount > 0);
+	return setNativeAffinity(thread->handle, cpus, cpuCount);
+}
+size_t getThreadAffinity(Thread thread, size_t* cpus, size_t capacity)
+{
+	assert(thread);
+	assert(cpus || capacity == 0);
+	return getNativeAffinity(thread->handle, cpus, capacity);
+}
+
 static bool isMainThreadSet = false;
 
 #if __linux__ || __APPLE__
@@ -282,3 +532,39 @@ void setThreadBackgroundPriority()
 	if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL)) abort();
 	#endif
 }
+
+
+bool setCurrentThreadAffinity(const size_t* cpus, size_t cpuCount)
+{
+	assert(cpus);
+	assert(cpuCount > 0);
+
+	#if __linux__ || __APPLE__
+	return setNativeAffinity(pthread_self(), cpus, cpuCount);
+	#elif _WIN32
+	return setNativeAffinity(GetCurrentThread(), cpus, cpuCount);
+	#endif
+}
+size_t getCurrentThreadAffinity(size_t* cpus, size_t capacity)
+{
+	assert(cpus || capacity == 0);
+
+	#if __linux__ || __APPLE__
+	return getNativeAffinity(pthread_self(), cpus, capacity);
+	#elif _WIN32
+	return getNativeAffinity(GetCurrentThread(), cpus, capacity);
+	#endif
+}
+size_t getCurrentThreadCpu()
+{
+	#if __linux__
+	int cpu = sched_getcpu();
+	return cpu >= 0 ? (size_t)cpu : SIZE_MAX;
+	#elif __APPLE__
+	return SIZE_MAX;
+	#elif _WIN32
+	PROCESSOR_NUMBER number;
+	GetCurrentProcessorNumberEx(&number);
+	return (size_t)number.Group * sizeof(KAFFINITY) * 8 + number.Number;
+	#endif
+}
\ No newline at end of file
@@ -13,355 +13,2734 @@
 // limitations under the License.
 
 #include "mpmt/thread_pool.h"
+#include "mpmt/atomic.h"
+#include "mpmt/queue.h"
+#include "mpmt/spinlock.h"
 #include "mpmt/sync.h"
 #include "mpmt/thread.h"
+#include "mpmt/topology.h"
 
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#if __linux__ || __APPLE__
+#include <time.h>
+#define THREAD_LOCAL __thread
+#elif _WIN32
+#include <windows.h>
+#define THREAD_LOCAL __declspec(thread)
+#else
+#error Unknown operating system
+#endif
+
+#define CACHE_LINE_SIZE 64
+#define MIN_DEQUE_CAPACITY 16
+#define TASK_BUFFER_SIZE 64
+#define TASK_SEGMENT_SIZE 64
+#define MAX_FREE_SEGMENT_COUNT 16
+#define SEGMENT_RETRY_DELAY 0.001
+#define INLINE_TASK_FLAG ((uintptr_t)1)
+
+// Note: internal task representation, stored inside all task containers. (One cache line)
+typedef struct PoolTask
+{
+	void (*function)(void*);
+	uintptr_t taskGroup; // Note: lowest bit marks inline payload tasks.
+	union
+	{
+		void* argument;
+		uint8_t payload[THREAD_POOL_TASK_PAYLOAD_SIZE];
+	};
+} PoolTask;
+
+// Note: segmented order and priority queue task chunk, segments are linked from the queue head to the tail.
+typedef struct TaskSegment
+{
+	PoolTask tasks[TASK_SEGMENT_SIZE];
+	struct TaskSegment* next;
+} TaskSegment;
+
+typedef struct SegmentQueue
+{
+	TaskSegment* headSegment;
+	TaskSegment* tailSegment;
+	size_t head;
+	size_t tail;
+	size_t taskCount;
+} SegmentQueue;
+
+// Note: Chase-Lev work stealing deque, only owner thread pushes and pops from the bottom.
+typedef struct TaskDeque
+{
+	atomic_int64 top;
+	uint8_t _topPadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	atomic_int64 bottom;
+	uint8_t _bottomPadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	PoolTask* tasks;
+	int64_t mask;
+} TaskDeque;
+
+typedef struct ThreadPoolWorker
+{
+	ThreadPool threadPool;
+	TaskDeque deque;
+	size_t cpu;
+	size_t node;
+	uint32_t seed;
+	bool isActive;
+} ThreadPoolWorker;
+
+// Note: NUMA order task queue, allocated on its own memory node.
+typedef struct TaskNode
+{
+	Mutex_T mutex;
+	atomic_int64 taskCount;
+	PoolTask* tasks;
+	size_t taskCapacity;
+	size_t taskHead;
+	size_t* cpus;
+	size_t cpuCount;
+} TaskNode;
+
+typedef struct CpuLocation
+{
+	size_t cpu;
+	size_t package;
+	size_t coreRank;
+	size_t siblingRank;
+} CpuLocation;
+
+typedef struct ParallelFor
+{
+	atomic_int64 next;
+	uint8_t _nextPadding[CACHE_LINE_SIZE - sizeof(int64_t)];
+	atomic_int64 doneCount;
+	atomic_int64 refCount;
+	ThreadPool threadPool;
+	ParallelForFunction function;
+	void* context;
+	size_t offset;
+	int64_t end;
+	int64_t grain;
+	int64_t divisor;
+} ParallelFor;
 
 struct ThreadPool_T
 {
-	Mutex mutex;
-	Cond workCond;
-	Cond workingCond;
-	ThreadPoolTask* tasks;
-	size_t taskCapacity;
-	size_t taskCount;
-	Thread* threads;
-	size_t threadCount;
-	size_t workingCount;
-	TaskOrder taskOrder;
-	bool isRunning;
-};
+	Mutex_T mutex;
+	Cond_T workCond;
+	Cond_T spaceCond;
+	Cond_T doneCond;
+	PoolTask* tasks;
+	LockFreeQueue taskQueue;
+	SegmentQueue segmentQueues[TASK_PRIORITY_COUNT];
+	TaskSegment* freeSegments;
+	size_t freeSegmentCount;
+	size_t taskCapacity;
+	size_t taskHead;
+	size_t taskCount;
+	Thread* threads;
+	ThreadPoolWorker* workers;
+	TaskNode** nodes;
+	size_t* cpuNodes;
+	size_t nodeCount;
+	size_t cpuNodeCount;
+	atomic_int64 nextNode;
+	ThreadOptions workerOptions;
+	char workerName[16];
+	size_t* workerCpus;
+	size_t threadCapacity;
+	atomic_int64 threadCount;
+	atomic_int64 minThreadCount;
+	atomic_int64 maxThreadCount;
+	size_t spawnDepth;
+	double keepAlive;
+	size_t workingCount;
+	atomic_int64 pendingCount;
+	atomic_int64 sleepingCount;
+	atomic_int64 spaceWaitingCount;
+	atomic_int64 doneWaitingCount;
+	atomic_int32 idlePolicy;
+	atomic_int32 spinCount;
+	atomic_int32 yieldCount;
+	uint32_t priorityWeights[TASK_PRIORITY_COUNT - 1];
+	uint32_t priorityStreaks[TASK_PRIORITY_COUNT - 1];
+	TaskOrder taskOrder;
+	ThreadPinning pinning;
+	bool isRunning;
+};
+
+struct TaskGroup_T
+{
+	ThreadPool threadPool;
+	atomic_int64 pendingCount;
+};
+
+// Note: not ready future links its continuations, ready future has the completed marker instead.
+struct Future_T
+{
+	ThreadPool threadPool;
+	atomic_ptr continuations;
+	atomic_int64 refCount;
+	void* result;
+	Future nextContinuation;
+	FutureFunction function;
+	void* argument;
+	void* antecedentResult;
+};
+
+static THREAD_LOCAL ThreadPoolWorker* currentWorker = NULL;
+
+// Note: stealing, lock-free and NUMA orders track tasks with the atomic pending counter instead of the mutex.
+static bool isPendingCounted(TaskOrder taskOrder)
+{
+	return taskOrder == STEALING_TASK_ORDER || taskOrder == LOCK_FREE_TASK_ORDER || taskOrder == NUMA_TASK_ORDER;
+}
+
+// Note: wakes at most one sleeping worker per added task. Mutex should be locked.
+static void signalSleepingThreads(ThreadPool threadPool, size_t taskCount)
+{
+	int64_t sleepingCount = atomicLoad64(&threadPool->sleepingCount);
+	if (taskCount == 0 || sleepingCount <= 0)
+		return;
+
+	if ((int64_t)taskCount >= sleepingCount)
+	{
+		broadcastCond(&threadPool->workCond);
+		return;
+	}
+
+	for (size_t i = 0; i < taskCount; i++)
+		signalCond(&threadPool->workCond);
+}
+static void wakeSleepingThreads(ThreadPool threadPool, size_t taskCount)
+{
+	if (taskCount == 0 || atomicLoad64(&threadPool->sleepingCount) == 0)
+		return;
+
+	lockMutex(&threadPool->mutex);
+	signalSleepingThreads(threadPool, taskCount);
+	unlockMutex(&threadPool->mutex);
+}
+
+/*
+ * Note: space and done waiters increment their counters under the mutex before checking the condition, 
+ * and the notifying threads check counters after changing it, so that no wakeup can be lost.
+ */
+static void signalTaskSpace(ThreadPool threadPool, bool isLocked)
+{
+	if (atomicLoad64(&threadPool->spaceWaitingCount) == 0)
+		return;
+
+	if (!isLocked)
+		lockMutex(&threadPool->mutex);
+	signalCond(&threadPool->spaceCond);
+	if (!isLocked)
+		unlockMutex(&threadPool->mutex);
+}
+static void broadcastTasksDone(ThreadPool threadPool, bool isLocked)
+{
+	if (atomicLoad64(&threadPool->doneWaitingCount) == 0)
+		return;
+
+	if (!isLocked)
+		lockMutex(&threadPool->mutex);
+	broadcastCond(&threadPool->doneCond);
+	if (!isLocked)
+		unlockMutex(&threadPool->mutex);
+}
+
+// Note: returns false if the worker has used all of its idle spins and yields.
+static bool canIdleWorkerSpin(ThreadPool threadPool, IdlePolicy idlePolicy, uint32_t idleCount)
+{
+	uint32_t spinCount = (uint32_t)atomicLoad32(&threadPool->spinCount);
+	return idleCount < spinCount || idlePolicy != ADAPTIVE_IDLE_POLICY || 
+		idleCount - spinCount < (uint32_t)atomicLoad32(&threadPool->yieldCount);
+}
+static void pauseIdleWorker(ThreadPool threadPool, IdlePolicy idlePolicy, uint32_t* idleCount)
+{
+	if ((*idleCount)++ < (uint32_t)atomicLoad32(&threadPool->spinCount))
+	{
+		spinPause();
+		return;
+	}
+
+	yieldThread();
+	if (idlePolicy == BUSY_POLL_IDLE_POLICY)
+		*idleCount = 0;
+}
+
+/*
+ * Note: called by the worker after a failed task pop, returns false if the worker should go to sleep.
+ * Locked mutex is released while spinning on the atomic task count, and locked again only when tasks show up,
+ * or after the spin and yield round, so that spinning workers don't block the pushing threads.
+ */
+static bool spinIdleWorker(ThreadPool threadPool, uint32_t* idleCount, Mutex lockedMutex)
+{
+	IdlePolicy idlePolicy = (IdlePolicy)atomicLoad32(&threadPool->idlePolicy);
+	if (idlePolicy == PARK_IDLE_POLICY || !canIdleWorkerSpin(threadPool, idlePolicy, *idleCount))
+		return false;
+
+	if (!lockedMutex)
+	{
+		pauseIdleWorker(threadPool, idlePolicy, idleCount);
+		return true;
+	}
+
+	unlockMutex(lockedMutex);
+	do
+	{
+		pauseIdleWorker(threadPool, idlePolicy, idleCount);
+	}
+	while (atomicLoadExplicitSize(&threadPool->taskCount, ATOMIC_RELAXED) == 0 && *idleCount != 0 && 
+		canIdleWorkerSpin(threadPool, idlePolicy, *idleCount));
+	lockMutex(lockedMutex);
+	return true;
+}
+static void completePendingTask(ThreadPool threadPool)
+{
+	if (atomicFetchAdd64(&threadPool->pendingCount, -1) == 1)
+		broadcastTasksDone(threadPool, false);
+}
+static void completeGroupTasks(TaskGroup taskGroup, size_t taskCount)
+{
+	// Note: group can be destroyed right after the counter reaches zero.
+	ThreadPool threadPool = taskGroup->threadPool;
+	if (atomicFetchAdd64(&taskGroup->pendingCount, -(int64_t)taskCount) == (int64_t)taskCount)
+		broadcastTasksDone(threadPool, false);
+}
+
+// Note: payload is copied only for the inline tasks, regular tasks don't touch the rest of the cache line.
+static void copyPoolTask(PoolTask* destination, const PoolTask* source)
+{
+	if (source->taskGroup & INLINE_TASK_FLAG)
+	{
+		*destination = *source;
+		return;
+	}
+
+	destination->function = source->function;
+	destination->taskGroup = source->taskGroup;
+	destination->argument = source->argument;
+}
+static void runPoolTask(PoolTask* task)
+{
+	task->function(task->taskGroup & INLINE_TASK_FLAG ? (void*)task->payload : task->argument);
+
+	TaskGroup taskGroup = (TaskGroup)(task->taskGroup & ~INLINE_TASK_FLAG);
+	if (taskGroup)
+		completeGroupTasks(taskGroup, 1);
+}
+
+//**********************************************************************************************************************
+static void onThreadUpdate(void* argument);
+
+// Note: shared ring tasks are counted only with the locked mutex.
+static size_t getQueuedTaskCount(ThreadPool threadPool, bool isLocked)
+{
+	TaskOrder taskOrder = threadPool->taskOrder;
+	if (taskOrder == LOCK_FREE_TASK_ORDER)
+		return getLockFreeQueueSize(threadPool->taskQueue);
+
+	size_t taskCount = 0;
+	if (taskOrder == NUMA_TASK_ORDER)
+	{
+		for (size_t i = 0; i < threadPool->nodeCount; i++)
+			taskCount += (size_t)atomicLoad64(&threadPool->nodes[i]->taskCount);
+		return taskCount;
+	}
+	if (taskOrder == STEALING_TASK_ORDER)
+	{
+		ThreadPoolWorker* workers = threadPool->workers;
+		for (size_t i = 0; i < threadPool->threadCapacity; i++)
+		{
+			int64_t count = atomicLoad64(&workers[i].deque.bottom) - atomicLoad64(&workers[i].deque.top);
+			if (count > 0)
+				taskCount += (size_t)count;
+		}
+	}
+
+	if (isLocked)
+		taskCount += threadPool->taskCount;
+	return taskCount;
+}
+
+// Note: starts worker in the first free slot, so that lower slots get the first CPUs. Mutex should be locked.
+static bool startWorker(ThreadPool threadPool)
+{
+	ThreadPoolWorker* workers = threadPool->workers;
+	size_t threadCapacity = threadPool->threadCapacity, index = 0;
+	while (index < threadCapacity && workers[index].isActive)
+		index++;
+	if (index == threadCapacity)
+		return false;
+
+	Thread* thread = &threadPool->threads[index];
+	if (*thread)
+	{
+		// Note: retired worker has already released the mutex, it is only returning from the thread function.
+		joinThread(*thread);
+		destroyThread(*thread);
+		*thread = NULL;
+	}
+
+	ThreadPoolWorker* worker = &workers[index];
+	ThreadOptions options = threadPool->workerOptions;
+	bool isBound = false;
+	char workerName[40]; // Note: fits 15 name characters and any index, so that the format can't truncate.
+
+	if (options.name)
+	{
+		// Note: shortening the name, so that worker index fits into the 15 characters.
+		int indexLength = snprintf(NULL, 0, "%zu", index);
+		int nameLength = indexLength < 15 ? 15 - indexLength : 0;
+		snprintf(workerName, sizeof(workerName), "%.*s%zu", nameLength, options.name, index);
+		options.name = workerName;
+	}
+
+	if (threadPool->pinning != NO_THREAD_PINNING)
+	{
+		options.cpus = &worker->cpu;
+		options.cpuCount = 1;
+	}
+	else if (threadPool->nodeCount > 1 && !options.cpus)
+	{
+		TaskNode* taskNode = threadPool->nodes[worker->node];
+		options.cpus = taskNode->cpus;
+		options.cpuCount = taskNode->cpuCount;
+		isBound = true;
+	}
+
+	worker->isActive = true;
+	atomicFetchAdd64(&threadPool->threadCount, 1);
+
+	*thread = createThreadWithOptions(onThreadUpdate, worker, &options);
+	if (!*thread && isBound)
+	{
+		// Note: binding is only an optimization, worker still runs if it fails.
+		options.cpus = NULL;
+		options.cpuCount = 0;
+		*thread = createThreadWithOptions(onThreadUpdate, worker, &options);
+	}
+	if (!*thread)
+	{
+		worker->isActive = false;
+		atomicFetchAdd64(&threadPool->threadCount, -1);
+		return false;
+	}
+	return true;
+}
+
+// Note: starts one more worker, if none of them is sleeping and queued tasks reached the spawn depth.
+static void growThreadPool(ThreadPool threadPool, bool isLocked)
+{
+	if (atomicLoad64(&threadPool->threadCount) >= atomicLoad64(&threadPool->maxThreadCount) || 
+		atomicLoad64(&threadPool->sleepingCount) > 0)
+	{
+		return;
+	}
+	if (!isLocked && getQueuedTaskCount(threadPool, false) < threadPool->spawnDepth)
+		return;
+
+	Mutex mutex = &threadPool->mutex;
+	if (!isLocked)
+		lockMutex(mutex);
+
+	// Note: failing to start the worker is not an error, current workers will finish the tasks.
+	if (threadPool->isRunning && atomicLoad64(&threadPool->sleepingCount) == 0 &&
+		atomicLoad64(&threadPool->threadCount) < atomicLoad64(&threadPool->maxThreadCount) && 
+		getQueuedTaskCount(threadPool, true) >= threadPool->spawnDepth)
+	{
+		startWorker(threadPool);
+	}
+
+	if (!isLocked)
+		unlockMutex(mutex);
+}
+
+// Note: monotonic time in seconds, used for the worker keep-alive deadline.
+static double getMonotonicTime()
+{
+	#if __linux__ || __APPLE__
+	struct timespec spec;
+	if (clock_gettime(CLOCK_MONOTONIC, &spec) != 0) abort();
+	return (double)spec.tv_sec + (double)spec.tv_nsec / 1000000000.0;
+	#elif _WIN32
+	return (double)GetTickCount64() / 1000.0;
+	#endif
+}
+
+/*
+ * Note: puts the idle worker to sleep until new tasks are added, returns false if the worker has retired.
+ * Workers above the maximal count retire right away, and above the minimal count after the keep-alive timeout.
+ * Mutex should be locked.
+ */
+static bool parkWorker(ThreadPoolWorker* worker)
+{
+	ThreadPool threadPool = worker->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	int64_t threadCount = atomicLoad64(&threadPool->threadCount);
+
+	if (threadCount <= atomicLoad64(&threadPool->minThreadCount))
+	{
+		waitCond(&threadPool->workCond, mutex);
+		return true;
+	}
+	if (threadCount <= atomicLoad64(&threadPool->maxThreadCount))
+	{
+		// Note: waking up without tasks can be spurious or after the other worker took the task, waiting again.
+		double deadline = getMonotonicTime() + threadPool->keepAlive, timeout = threadPool->keepAlive;
+		while (true)
+		{
+			waitCondFor(&threadPool->workCond, mutex, timeout);
+
+			if (!threadPool->isRunning || getQueuedTaskCount(threadPool, true) > 0 || 
+				atomicLoad64(&threadPool->threadCount) <= atomicLoad64(&threadPool->minThreadCount))
+			{
+				return true;
+			}
+			if (atomicLoad64(&threadPool->threadCount) > atomicLoad64(&threadPool->maxThreadCount))
+				break; // Note: maximal count is lowered while waiting, retiring right away.
+
+			timeout = deadline - getMonotonicTime();
+			if (timeout <= 0.0)
+				break;
+		}
+	}
+
+	worker->isActive = false;
+	atomicFetchAdd64(&threadPool->threadCount, -1);
+	return false;
+}
+
+//**********************************************************************************************************************
+// Note: segmented order normal tasks and high or low priority tasks are stored in the segment queues.
+
+// Note: returns false on segment allocation failure, the queue is not changed then.
+static bool pushSegmentTask(ThreadPool threadPool, SegmentQueue* queue, const PoolTask* task)
+{
+	TaskSegment* segment = queue->tailSegment;
+	if (!segment || queue->tail == TASK_SEGMENT_SIZE)
+	{
+		TaskSegment* newSegment = threadPool->freeSegments;
+		if (newSegment)
+		{
+			threadPool->freeSegments = newSegment->next;
+			threadPool->freeSegmentCount--;
+		}
+		else
+		{
+			newSegment = malloc(sizeof(TaskSegment));
+			if (!newSegment)
+				return false;
+		}
+
+		newSegment->next = NULL;
+		if (segment)
+			segment->next = newSegment;
+		else
+			queue->headSegment = newSegment;
+
+		queue->tailSegment = segment = newSegment;
+		queue->tail = 0;
+	}
+
+	copyPoolTask(&segment->tasks[queue->tail++], task);
+	queue->taskCount++;
+	return true;
+}
+static void popSegmentTask(ThreadPool threadPool, SegmentQueue* queue, PoolTask* task)
+{
+	TaskSegment* segment = queue->headSegment;
+	copyPoolTask(task, &segment->tasks[queue->head++]);
+
+	if (--queue->taskCount == 0)
+	{
+		// Note: queue is empty, head and tail are in the same segment, reusing it from the start.
+		queue->head = queue->tail = 0;
+		return;
+	}
+	if (queue->head < TASK_SEGMENT_SIZE)
+		return;
+
+	queue->headSegment = segment->next;
+	queue->head = 0;
+
+	// Note: keeping a few spare segments for the next burst, the rest is returned to the system.
+	if (threadPool->freeSegmentCount < MAX_FREE_SEGMENT_COUNT)
+	{
+		segment->next = threadPool->freeSegments;
+		threadPool->freeSegments = segment;
+		threadPool->freeSegmentCount++;
+	}
+	else
+	{
+		free(segment);
+	}
+}
+static void destroyTaskSegments(TaskSegment* segment)
+{
+	while (segment)
+	{
+		TaskSegment* next = segment->next;
+		free(segment);
+		segment = next;
+	}
+}
+
+//**********************************************************************************************************************
+// Note: each weight is a count of the higher priority tasks in a row, before the lower priority queue turn.
+static TaskPriority selectTaskPriority(ThreadPool threadPool)
+{
+	SegmentQueue* queues = threadPool->segmentQueues;
+	uint32_t* weights = threadPool->priorityWeights;
+	uint32_t* streaks = threadPool->priorityStreaks;
+	size_t highCount = queues[HIGH_TASK_PRIORITY].taskCount;
+	size_t lowCount = queues[LOW_TASK_PRIORITY].taskCount;
+	size_t normalCount = threadPool->taskCount - highCount - lowCount;
+
+	if (highCount > 0 && (normalCount + lowCount == 0 || weights[HIGH_TASK_PRIORITY] == 0 || 
+		streaks[HIGH_TASK_PRIORITY] < weights[HIGH_TASK_PRIORITY]))
+	{
+		streaks[HIGH_TASK_PRIORITY]++;
+		return HIGH_TASK_PRIORITY;
+	}
+	streaks[HIGH_TASK_PRIORITY] = 0;
+
+	if (normalCount > 0 && (lowCount == 0 || weights[NORMAL_TASK_PRIORITY] == 0 || 
+		streaks[NORMAL_TASK_PRIORITY] < weights[NORMAL_TASK_PRIORITY]))
+	{
+		streaks[NORMAL_TASK_PRIORITY]++;
+		return NORMAL_TASK_PRIORITY;
+	}
+	streaks[NORMAL_TASK_PRIORITY] = 0;
+	return LOW_TASK_PRIORITY;
+}
+
+//**********************************************************************************************************************
+/*
+ * Note: shared tasks are stored in the ring buffer, so that both orders are O(1). Mutex should be locked.
+ * Task count is changed with the atomic stores, so that idle workers can spin on it without the mutex.
+ */
+
+inline static size_t getRingTaskCount(ThreadPool threadPool)
+{
+	SegmentQueue* queues = threadPool->segmentQueues;
+	return threadPool->taskCount - queues[HIGH_TASK_PRIORITY].taskCount - 
+		queues[NORMAL_TASK_PRIORITY].taskCount - queues[LOW_TASK_PRIORITY].taskCount;
+}
+
+/*
+ * Note: ring has a slot for each task within the capacity, so if there is no memory for a new priority segment,
+ * the task is added to the ring with the normal priority instead. Only segmented order add can fail.
+ */
+static bool pushRingTask(ThreadPool threadPool, const PoolTask* task, TaskPriority priority)
+{
+	bool isSegmented = threadPool->taskOrder == SEGMENTED_TASK_ORDER;
+	if (priority != NORMAL_TASK_PRIORITY || isSegmented)
+	{
+		if (pushSegmentTask(threadPool, &threadPool->segmentQueues[priority], task))
+		{
+			atomicStoreExplicitSize(&threadPool->taskCount, threadPool->taskCount + 1, ATOMIC_RELAXED);
+			return true;
+		}
+		if (isSegmented)
+			return false;
+	}
+
+	size_t index = threadPool->taskHead + getRingTaskCount(threadPool);
+	size_t taskCapacity = threadPool->taskCapacity;
+	copyPoolTask(&threadPool->tasks[index < taskCapacity ? index : index - taskCapacity], task);
+	atomicStoreExplicitSize(&threadPool->taskCount, threadPool->taskCount + 1, ATOMIC_RELAXED);
+	return true;
+}
+static void popRingTask(ThreadPool threadPool, TaskOrder taskOrder, PoolTask* task)
+{
+	SegmentQueue* queues = threadPool->segmentQueues;
+	TaskPriority priority = NORMAL_TASK_PRIORITY;
+	if (queues[HIGH_TASK_PRIORITY].taskCount > 0 || queues[LOW_TASK_PRIORITY].taskCount > 0)
+		priority = selectTaskPriority(threadPool);
+
+	if (priority != NORMAL_TASK_PRIORITY || taskOrder == SEGMENTED_TASK_ORDER)
+	{
+		popSegmentTask(threadPool, &queues[priority], task);
+		atomicStoreExplicitSize(&threadPool->taskCount, threadPool->taskCount - 1, ATOMIC_RELAXED);
+		return;
+	}
+
+	PoolTask* tasks = threadPool->tasks;
+	size_t taskHead = threadPool->taskHead;
+	size_t taskCapacity = threadPool->taskCapacity;
+	size_t ringCount = getRingTaskCount(threadPool);
+	atomicStoreExplicitSize(&threadPool->taskCount, threadPool->taskCount - 1, ATOMIC_RELAXED);
+
+	if (taskOrder == QUEUE_TASK_ORDER)
+	{
+		threadPool->taskHead = taskHead + 1 < taskCapacity ? taskHead + 1 : 0;
+		copyPoolTask(task, &tasks[taskHead]);
+		return;
+	}
+
+	size_t index = taskHead + ringCount - 1;
+	copyPoolTask(task, &tasks[index < taskCapacity ? index : index - taskCapacity]);
+}
+
+static size_t pushRingTasks(ThreadPool threadPool, const PoolTask* tasks, 
+	size_t taskCount, TaskPriority priority, bool isBlocking)
+{
+	Mutex mutex = &threadPool->mutex;
+	Cond spaceCond = &threadPool->spaceCond;
+	bool isPending = isPendingCounted(threadPool->taskOrder);
+	bool isWaited = false;
+	size_t pushCount = 0;
+
+	lockMutex(mutex);
+	while (pushCount < taskCount)
+	{
+		// Note: segmented order capacity can be resized below the queued task count.
+		size_t taskCapacity = threadPool->taskCapacity;
+		size_t freeCount = taskCapacity > threadPool->taskCount ? taskCapacity - threadPool->taskCount : 0;
+		if (freeCount == 0)
+		{
+			if (!isBlocking)
+				break;
+
+			growThreadPool(threadPool, true);
+			atomicFetchAdd64(&threadPool->spaceWaitingCount, 1);
+			waitCond(spaceCond, mutex);
+			atomicFetchAdd64(&threadPool->spaceWaitingCount, -1);
+			isWaited = true;
+			continue;
+		}
+
+		size_t count = taskCount - pushCount;
+		if (count > freeCount)
+			count = freeCount;
+
+		size_t addedCount = 0;
+		while (addedCount < count && pushRingTask(threadPool, &tasks[pushCount], priority))
+		{
+			pushCount++;
+			addedCount++;
+		}
+
+		if (addedCount > 0)
+		{
+			if (isPending)
+				atomicFetchAdd64(&threadPool->pendingCount, (int64_t)addedCount);
+			signalSleepingThreads(threadPool, addedCount);
+		}
+		if (addedCount == count)
+			continue;
+
+		// Note: out of memory for a new segment, waiting for the workers to free some, like for the capacity.
+		if (!isBlocking)
+			break;
+
+		growThreadPool(threadPool, true);
+		atomicFetchAdd64(&threadPool->spaceWaitingCount, 1);
+		if (threadPool->taskCount > 0)
+			waitCond(spaceCond, mutex);
+		else
+			waitCondFor(spaceCond, mutex, SEGMENT_RETRY_DELAY); // Note: nothing to free, retrying later.
+		atomicFetchAdd64(&threadPool->spaceWaitingCount, -1);
+		isWaited = true;
+	}
+
+	// Note: passing the space wakeup to the next waiter, if this thread didn't use all of the freed slots.
+	if (isWaited && threadPool->taskCount < threadPool->taskCapacity)
+		signalTaskSpace(threadPool, true);
+	growThreadPool(threadPool, true);
+
+	unlockMutex(mutex);
+	return pushCount;
+}
+
+//**********************************************************************************************************************
+static bool pushDequeTask(TaskDeque* deque, const PoolTask* task)
+{
+	int64_t bottom = atomicLoad64(&deque->bottom);
+	int64_t top = atomicLoad64(&deque->top);
+	if (bottom - top > deque->mask)
+		return false;
+
+	copyPoolTask(&deque->tasks[bottom & deque->mask], task);
+	atomicStore64(&deque->bottom, bottom + 1);
+	return true;
+}
+static bool popDequeTask(TaskDeque* deque, PoolTask* task)
+{
+	int64_t bottom = atomicLoad64(&deque->bottom) - 1;
+	atomicStore64(&deque->bottom, bottom);
+	int64_t top = atomicLoad64(&deque->top);
+
+	if (top > bottom)
+	{
+		atomicStore64(&deque->bottom, bottom + 1);
+		return false;
+	}
+
+	copyPoolTask(task, &deque->tasks[bottom & deque->mask]);
+	if (top != bottom)
+		return true;
+
+	// Note: racing with the thieves for the last task.
+	bool result = atomicCompareExchange64(&deque->top, &top, top + 1);
+	atomicStore64(&deque->bottom, bottom + 1);
+	return result;
+}
+static bool stealDequeTask(TaskDeque* deque, PoolTask* task)
+{
+	int64_t top = atomicLoad64(&deque->top);
+	int64_t bottom = atomicLoad64(&deque->bottom);
+	if (top >= bottom)
+		return false;
+
+	copyPoolTask(task, &deque->tasks[top & deque->mask]);
+	return atomicCompareExchange64(&deque->top, &top, top + 1);
+}
+
+static bool stealTask(ThreadPool threadPool, ThreadPoolWorker* worker, PoolTask* task)
+{
+	ThreadPoolWorker* workers = threadPool->workers;
+	size_t threadCapacity = threadPool->threadCapacity;
+	size_t offset = 0;
+
+	if (worker)
+	{
+		uint32_t seed = worker->seed;
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		worker->seed = seed;
+		offset = seed % threadCapacity;
+	}
+
+	// Note: retired worker deques are always empty, so all of the worker slots are checked.
+	for (size_t i = 0; i < threadCapacity; i++)
+	{
+		ThreadPoolWorker* victim = &workers[(offset + i) % threadCapacity];
+		if (victim != worker && stealDequeTask(&victim->deque, task))
+			return true;
+	}
+	return false;
+}
+static bool hasDequeTasks(ThreadPool threadPool)
+{
+	ThreadPoolWorker* workers = threadPool->workers;
+	size_t threadCapacity = threadPool->threadCapacity;
+
+	for (size_t i = 0; i < threadCapacity; i++)
+	{
+		TaskDeque* deque = &workers[i].deque;
+		if (atomicLoad64(&deque->top) < atomicLoad64(&deque->bottom))
+			return true;
+	}
+	return false;
+}
+static bool tryPopSharedTask(ThreadPool threadPool, PoolTask* task)
+{
+	if (atomicLoadExplicitSize(&threadPool->taskCount, ATOMIC_RELAXED) == 0)
+		return false; // Note: not locking the mutex on each idle worker spin.
+
+	Mutex mutex = &threadPool->mutex;
+	lockMutex(mutex);
+
+	size_t taskCount = threadPool->taskCount;
+	if (taskCount == 0)
+	{
+		unlockMutex(mutex);
+		return false;
+	}
+
+	popRingTask(threadPool, STACK_TASK_ORDER, task);
+	signalTaskSpace(threadPool, true);
+
+	unlockMutex(mutex);
+	return true;
+}
+
+static size_t pushWorkerTasks(ThreadPool threadPool, const PoolTask* tasks, size_t taskCount)
+{
+	ThreadPoolWorker* worker = currentWorker;
+	if (!worker || worker->threadPool != threadPool)
+		return 0;
+
+	// Note: pending count can't reach zero here, current worker task is still running.
+	atomicFetchAdd64(&threadPool->pendingCount, (int64_t)taskCount);
+
+	size_t pushCount = 0;
+	while (pushCount < taskCount && pushDequeTask(&worker->deque, &tasks[pushCount]))
+		pushCount++;
+
+	if (pushCount < taskCount)
+		atomicFetchAdd64(&threadPool->pendingCount, -(int64_t)(taskCount - pushCount));
+	wakeSleepingThreads(threadPool, pushCount);
+	growThreadPool(threadPool, false);
+	return pushCount;
+}
+static void onStealingThreadUpdate(ThreadPoolWorker* worker)
+{
+	ThreadPool threadPool = worker->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	uint32_t idleCount = 0;
+
+	while (true)
+	{
+		PoolTask task;
+		if (popDequeTask(&worker->deque, &task) || stealTask(threadPool, worker, &task) || 
+			tryPopSharedTask(threadPool, &task))
+		{
+			runPoolTask(&task);
+			completePendingTask(threadPool);
+			idleCount = 0;
+			continue;
+		}
+		if (spinIdleWorker(threadPool, &idleCount, NULL))
+			continue;
+
+		lockMutex(mutex);
+
+		// Note: pushing threads check sleeping count after the push, so no wakeup can be lost.
+		atomicFetchAdd64(&threadPool->sleepingCount, 1);
+		if (threadPool->taskCount == 0 && !hasDequeTasks(threadPool))
+		{
+			if (!threadPool->isRunning || !parkWorker(worker))
+			{
+				atomicFetchAdd64(&threadPool->sleepingCount, -1);
+				unlockMutex(mutex);
+				return;
+			}
+			idleCount = 0;
+		}
+		atomicFetchAdd64(&threadPool->sleepingCount, -1);
+
+		unlockMutex(mutex);
+	}
+}
+
+//**********************************************************************************************************************
+static bool tryPushQueueTask(ThreadPool threadPool, const PoolTask* task, bool isLocked)
+{
+	atomicFetchAdd64(&threadPool->pendingCount, 1);
+	if (tryPushLockFreeQueue(threadPool->taskQueue, task))
+		return true;
+
+	if (atomicFetchAdd64(&threadPool->pendingCount, -1) == 1)
+		broadcastTasksDone(threadPool, isLocked);
+	return false;
+}
+static void waitPushQueueTask(ThreadPool threadPool, const PoolTask* task)
+{
+	Mutex mutex = &threadPool->mutex;
+	Cond spaceCond = &threadPool->spaceCond;
+
+	// Note: popping threads check waiting count after the pop, so no wakeup can be lost.
+	lockMutex(mutex);
+	growThreadPool(threadPool, true);
+	atomicFetchAdd64(&threadPool->spaceWaitingCount, 1);
+	while (!tryPushQueueTask(threadPool, task, true))
+		waitCond(spaceCond, mutex);
+	atomicFetchAdd64(&threadPool->spaceWaitingCount, -1);
+
+	if (getLockFreeQueueSize(threadPool->taskQueue) < threadPool->taskCapacity)
+		signalTaskSpace(threadPool, true);
+	unlockMutex(mutex);
+}
+static size_t pushQueueTasks(ThreadPool threadPool, const PoolTask* tasks, size_t taskCount, bool isBlocking)
+{
+	size_t wakeCount = 0, pushCount = 0;
+	for (; pushCount < taskCount; pushCount++)
+	{
+		if (tryPushQueueTask(threadPool, &tasks[pushCount], false))
+		{
+			wakeCount++;
+			continue;
+		}
+
+		// Note: waking threads before blocking, otherwise nobody will free the space.
+		wakeSleepingThreads(threadPool, wakeCount);
+		wakeCount = 0;
+
+		if (!isBlocking)
+			break;
+
+		waitPushQueueTask(threadPool, &tasks[pushCount]);
+		wakeCount++;
+	}
+
+	wakeSleepingThreads(threadPool, wakeCount);
+	growThreadPool(threadPool, false);
+	return pushCount;
+}
+static bool tryPopQueueTask(ThreadPool threadPool, PoolTask* task)
+{
+	if (!tryPopLockFreeQueue(threadPool->taskQueue, task))
+		return false;
+
+	signalTaskSpace(threadPool, false);
+	return true;
+}
+
+static void onLockFreeThreadUpdate(ThreadPoolWorker* worker)
+{
+	ThreadPool threadPool = worker->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	uint32_t idleCount = 0;
+
+	while (true)
+	{
+		PoolTask task;
+		if (tryPopQueueTask(threadPool, &task))
+		{
+			runPoolTask(&task);
+			completePendingTask(threadPool);
+			idleCount = 0;
+			continue;
+		}
+		if (spinIdleWorker(threadPool, &idleCount, NULL))
+			continue;
+
+		lockMutex(mutex);
+
+		// Note: pushing threads check sleeping count after the push, so no wakeup can be lost.
+		atomicFetchAdd64(&threadPool->sleepingCount, 1);
+		if (getLockFreeQueueSize(threadPool->taskQueue) == 0)
+		{
+			if (!threadPool->isRunning || !parkWorker(worker))
+			{
+				atomicFetchAdd64(&threadPool->sleepingCount, -1);
+				unlockMutex(mutex);
+				return;
+			}
+			idleCount = 0;
+		}
+		atomicFetchAdd64(&threadPool->sleepingCount, -1);
+
+		unlockMutex(mutex);
+	}
+}
+
+//**********************************************************************************************************************
+static size_t getCpuNode(ThreadPool threadPool, size_t cpu)
+{
+	return cpu < threadPool->cpuNodeCount ? threadPool->cpuNodes[cpu] : SIZE_MAX;
+}
+static size_t getCurrentNode(ThreadPool threadPool)
+{
+	if (threadPool->nodeCount == 1)
+		return 0;
+
+	ThreadPoolWorker* worker = currentWorker;
+	if (worker && worker->threadPool == threadPool)
+		return worker->node;
+
+	size_t node = getCpuNode(threadPool, getCurrentThreadCpu());
+	if (node != SIZE_MAX)
+		return node;
+	return (size_t)atomicFetchAdd64(&threadPool->nextNode, 1) % threadPool->nodeCount;
+}
+
+// Note: fills the preferred node queue first, then the other nodes. Returns pushed task count.
+static size_t tryPushNodeTasks(ThreadPool threadPool, const PoolTask* tasks, size_t taskCount, size_t node)
+{
+	TaskNode** nodes = threadPool->nodes;
+	size_t nodeCount = threadPool->nodeCount, pushCount = 0;
+
+	for (size_t i = 0; i < nodeCount && pushCount < taskCount; i++)
+	{
+		TaskNode* taskNode = nodes[node + i < nodeCount ? node + i : node + i - nodeCount];
+		lockMutex(&taskNode->mutex);
+
+		size_t nodeTaskCount = (size_t)atomicLoad64(&taskNode->taskCount);
+		size_t taskCapacity = taskNode->taskCapacity;
+		size_t count = taskCapacity - nodeTaskCount;
+		if (count > taskCount - pushCount)
+			count = taskCount - pushCount;
+
+		if (count > 0)
+		{
+			atomicFetchAdd64(&threadPool->pendingCount, (int64_t)count);
+			for (size_t j = 0; j < count; j++)
+			{
+				size_t index = taskNode->taskHead + nodeTaskCount + j;
+				copyPoolTask(&taskNode->tasks[index < taskCapacity ? 
+					index : index - taskCapacity], &tasks[pushCount + j]);
+			}
+			atomicStore64(&taskNode->taskCount, (int64_t)(nodeTaskCount + count));
+			pushCount += count;
+		}
+
+		unlockMutex(&taskNode->mutex);
+	}
+	return pushCount;
+}
+static size_t pushNodeTasks(ThreadPool threadPool, const PoolTask* tasks, 
+	size_t taskCount, size_t node, bool isBlocking)
+{
+	if (node == THREAD_POOL_ANY_NODE)
+		node = getCurrentNode(threadPool);
+	else if (node >= threadPool->nodeCount)
+		node %= threadPool->nodeCount;
+
+	size_t pushCount = tryPushNodeTasks(threadPool, tasks, taskCount, node);
+	wakeSleepingThreads(threadPool, pushCount);
+	growThreadPool(threadPool, false);
+	if (pushCount == taskCount || !isBlocking)
+		return pushCount;
+
+	Mutex mutex = &threadPool->mutex;
+	Cond spaceCond = &threadPool->spaceCond;
+
+	// Note: popping threads check waiting count after the pop, so no wakeup can be lost.
+	lockMutex(mutex);
+	atomicFetchAdd64(&threadPool->spaceWaitingCount, 1);
+	while (pushCount < taskCount)
+	{
+		size_t count = tryPushNodeTasks(threadPool, tasks + pushCount, taskCount - pushCount, node);
+		if (count == 0)
+		{
+			growThreadPool(threadPool, true);
+			waitCond(spaceCond, mutex);
+			continue;
+		}
+
+		pushCount += count;
+		signalSleepingThreads(threadPool, count);
+	}
+	atomicFetchAdd64(&threadPool->spaceWaitingCount, -1);
+
+	// Note: passing the space wakeup to the next waiter, the last push could leave some free slots.
+	signalTaskSpace(threadPool, true);
+	unlockMutex(mutex);
+	return pushCount;
+}
+
+static bool tryPopNodeTask(ThreadPool threadPool, TaskNode* taskNode, PoolTask* task)
+{
+	if (atomicLoad64(&taskNode->taskCount) == 0)
+		return false;
+
+	lockMutex(&taskNode->mutex);
+	int64_t nodeTaskCount = atomicLoad64(&taskNode->taskCount);
+	if (nodeTaskCount == 0)
+	{
+		unlockMutex(&taskNode->mutex);
+		return false;
+	}
+
+	size_t taskHead = taskNode->taskHead;
+	copyPoolTask(task, &taskNode->tasks[taskHead]);
+	taskNode->taskHead = taskHead + 1 < taskNode->taskCapacity ? taskHead + 1 : 0;
+	atomicStore64(&taskNode->taskCount, nodeTaskCount - 1);
+	unlockMutex(&taskNode->mutex);
+
+	signalTaskSpace(threadPool, false);
+	return true;
+}
+// Note: other nodes are checked only when the own node queue is empty.
+static bool tryPopAnyNodeTask(ThreadPool threadPool, size_t node, PoolTask* task)
+{
+	TaskNode** nodes = threadPool->nodes;
+	size_t nodeCount = threadPool->nodeCount;
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (tryPopNodeTask(threadPool, nodes[node + i < nodeCount ? node + i : node + i - nodeCount], task))
+			return true;
+	}
+	return false;
+}
+static bool hasNodeTasks(ThreadPool threadPool)
+{
+	TaskNode** nodes = threadPool->nodes;
+	size_t nodeCount = threadPool->nodeCount;
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (atomicLoad64(&nodes[i]->taskCount) != 0)
+			return true;
+	}
+	return false;
+}
+
+static void onNumaThreadUpdate(ThreadPoolWorker* worker)
+{
+	ThreadPool threadPool = worker->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	uint32_t idleCount = 0;
+
+	while (true)
+	{
+		PoolTask task;
+		if (tryPopAnyNodeTask(threadPool, worker->node, &task))
+		{
+			runPoolTask(&task);
+			completePendingTask(threadPool);
+			idleCount = 0;
+			continue;
+		}
+		if (spinIdleWorker(threadPool, &idleCount, NULL))
+			continue;
+
+		lockMutex(mutex);
+
+		// Note: pushing threads check sleeping count after the push, so no wakeup can be lost.
+		atomicFetchAdd64(&threadPool->sleepingCount, 1);
+		if (!hasNodeTasks(threadPool))
+		{
+			if (!threadPool->isRunning || !parkWorker(worker))
+			{
+				atomicFetchAdd64(&threadPool->sleepingCount, -1);
+				unlockMutex(mutex);
+				return;
+			}
+			idleCount = 0;
+		}
+		atomicFetchAdd64(&threadPool->sleepingCount, -1);
+
+		unlockMutex(mutex);
+	}
+}
+
+//**********************************************************************************************************************
+static void onThreadUpdate(void* argument)
+{
+	ThreadPoolWorker* worker = argument;
+	ThreadPool threadPool = worker->threadPool;
+	currentWorker = worker;
+
+	if (threadPool->taskOrder == STEALING_TASK_ORDER)
+	{
+		onStealingThreadUpdate(worker);
+		return;
+	}
+	if (threadPool->taskOrder == LOCK_FREE_TASK_ORDER)
+	{
+		onLockFreeThreadUpdate(worker);
+		return;
+	}
+	if (threadPool->taskOrder == NUMA_TASK_ORDER)
+	{
+		onNumaThreadUpdate(worker);
+		return;
+	}
+
+	Mutex mutex = &threadPool->mutex;
+	uint32_t idleCount = 0;
+
+	lockMutex(mutex);
+
+	while (true)
+	{
+		while (threadPool->taskCount == 0)
+		{
+			if (!threadPool->isRunning)
+			{
+				unlockMutex(mutex);
+				return;
+			}
+			if (spinIdleWorker(threadPool, &idleCount, mutex))
+				continue;
+
+			atomicFetchAdd64(&threadPool->sleepingCount, 1);
+			bool isParked = parkWorker(worker);
+			atomicFetchAdd64(&threadPool->sleepingCount, -1);
+
+			if (!isParked)
+			{
+				unlockMutex(mutex);
+				return;
+			}
+			idleCount = 0;
+		}
+		idleCount = 0;
+
+		threadPool->workingCount++;
+		PoolTask task;
+		popRingTask(threadPool, threadPool->taskOrder, &task);
+		signalTaskSpace(threadPool, true);
+
+		unlockMutex(mutex);
+		runPoolTask(&task);
+		lockMutex(mutex);
+
+		if (--threadPool->workingCount == 0 && threadPool->taskCount == 0)
+			broadcastTasksDone(threadPool, true);
+	}
+}
+
+// Note: takes one task from the pool and runs it on the current thread, used to help while waiting.
+static bool tryRunThreadPoolTask(ThreadPool threadPool)
+{
+	TaskOrder taskOrder = threadPool->taskOrder;
+	PoolTask task;
+
+	if (taskOrder == LOCK_FREE_TASK_ORDER)
+	{
+		if (!tryPopQueueTask(threadPool, &task))
+			return false;
+
+		runPoolTask(&task);
+		completePendingTask(threadPool);
+		return true;
+	}
+	if (taskOrder == NUMA_TASK_ORDER)
+	{
+		if (!tryPopAnyNodeTask(threadPool, getCurrentNode(threadPool), &task))
+			return false;
+
+		runPoolTask(&task);
+		completePendingTask(threadPool);
+		return true;
+	}
+	if (taskOrder == STEALING_TASK_ORDER)
+	{
+		ThreadPoolWorker* worker = currentWorker;
+		if (worker && worker->threadPool != threadPool)
+			worker = NULL;
+
+		if ((!worker || !popDequeTask(&worker->deque, &task)) && 
+			!stealTask(threadPool, worker, &task) && !tryPopSharedTask(threadPool, &task))
+		{
+			return false;
+		}
+
+		runPoolTask(&task);
+		completePendingTask(threadPool);
+		return true;
+	}
+
+	Mutex mutex = &threadPool->mutex;
+	lockMutex(mutex);
+
+	if (threadPool->taskCount == 0)
+	{
+		unlockMutex(mutex);
+		return false;
+	}
+
+	threadPool->workingCount++;
+	popRingTask(threadPool, taskOrder, &task);
+	signalTaskSpace(threadPool, true);
+
+	unlockMutex(mutex);
+	runPoolTask(&task);
+	lockMutex(mutex);
+
+	if (--threadPool->workingCount == 0 && threadPool->taskCount == 0)
+		broadcastTasksDone(threadPool, true);
+	unlockMutex(mutex);
+	return true;
+}
+
+static size_t pushTasks(ThreadPool threadPool, const PoolTask* tasks, 
+	size_t taskCount, size_t node, TaskPriority priority, bool isBlocking)
+{
+	TaskOrder taskOrder = threadPool->taskOrder;
+	if (taskOrder == LOCK_FREE_TASK_ORDER)
+		return pushQueueTasks(threadPool, tasks, taskCount, isBlocking);
+	if (taskOrder == NUMA_TASK_ORDER)
+		return pushNodeTasks(threadPool, tasks, taskCount, node, isBlocking);
+
+	size_t pushCount = 0;
+	if (taskOrder == STEALING_TASK_ORDER)
+	{
+		pushCount = pushWorkerTasks(threadPool, tasks, taskCount);
+		if (pushCount == taskCount)
+			return pushCount;
+		priority = NORMAL_TASK_PRIORITY; // Note: shared ring tasks are popped only in the stack order.
+	}
+
+	return pushCount + pushRingTasks(threadPool, tasks + pushCount, taskCount - pushCount, priority, isBlocking);
+}
+static size_t addPriorityTasks(ThreadPool threadPool, TaskGroup taskGroup, const void* tasks, size_t taskCount, 
+	size_t node, TaskPriority priority, bool isInline, bool isSame, bool isBlocking)
+{
+	if (taskGroup)
+		atomicFetchAdd64(&taskGroup->pendingCount, (int64_t)taskCount);
+
+	// Note: pool threads can't sleep on a full buffer, all of them may be blocked adding tasks.
+	ThreadPoolWorker* worker = currentWorker;
+	bool isHelping = isBlocking && worker && worker->threadPool == threadPool;
+
+	PoolTask buffer[TASK_BUFFER_SIZE];
+	size_t addCount = 0;
+
+	while (addCount < taskCount)
+	{
+		size_t count = taskCount - addCount;
+		if (count > TASK_BUFFER_SIZE)
+			count = TASK_BUFFER_SIZE;
+
+		if (isInline)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const ThreadPoolInlineTask* task = (const ThreadPoolInlineTask*)tasks + (isSame ? 0 : addCount + i);
+				buffer[i].function = task->function;
+				buffer[i].taskGroup = (uintptr_t)taskGroup | INLINE_TASK_FLAG;
+				memcpy(buffer[i].payload, task->payload, THREAD_POOL_TASK_PAYLOAD_SIZE);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const ThreadPoolTask* task = (const ThreadPoolTask*)tasks + (isSame ? 0 : addCount + i);
+				buffer[i].function = task->function;
+				buffer[i].taskGroup = (uintptr_t)taskGroup;
+				buffer[i].argument = task->argument;
+			}
+		}
+
+		size_t pushCount = 0;
+		while (true)
+		{
+			pushCount += pushTasks(threadPool, buffer + pushCount, 
+				count - pushCount, node, priority, isBlocking && !isHelping);
+			if (pushCount == count || !isHelping)
+				break;
+			if (!tryRunThreadPoolTask(threadPool))
+				yieldThread();
+		}
+
+		addCount += pushCount;
+		if (pushCount < count)
+			break;
+	}
+
+	if (taskGroup && addCount < taskCount)
+		completeGroupTasks(taskGroup, taskCount - addCount);
+	return addCount;
+}
+static size_t addTasks(ThreadPool threadPool, TaskGroup taskGroup, const void* tasks, 
+	size_t taskCount, size_t node, bool isInline, bool isSame, bool isBlocking)
+{
+	return addPriorityTasks(threadPool, taskGroup, tasks, taskCount, 
+		node, NORMAL_TASK_PRIORITY, isInline, isSame, isBlocking);
+}
+
+//**********************************************************************************************************************
+static TaskNode* createTaskNode(size_t taskCapacity, size_t* cpus, size_t cpuCount)
+{
+	TaskNode* taskNode = calloc(1, sizeof(TaskNode));
+	if (!taskNode)
+		return NULL;
+
+	PoolTask* tasks = malloc(taskCapacity * sizeof(PoolTask));
+	if (!tasks || !initMutex(&taskNode->mutex))
+	{
+		free(tasks);
+		free(taskNode);
+		return NULL;
+	}
+
+	memset(tasks, 0, taskCapacity * sizeof(PoolTask)); // Note: touching pages on the current node.
+	atomicStore64(&taskNode->taskCount, 0);
+	taskNode->tasks = tasks;
+	taskNode->taskCapacity = taskCapacity;
+	taskNode->taskHead = 0;
+	taskNode->cpus = cpus;
+	taskNode->cpuCount = cpuCount;
+	return taskNode;
+}
+static void destroyTaskNode(TaskNode* taskNode)
+{
+	if (!taskNode)
+		return;
+
+	deinitMutex(&taskNode->mutex);
+	free(taskNode->cpus);
+	free(taskNode->tasks);
+	free(taskNode);
+}
+
+// Note: node memory is allocated while the creating thread is bound to the node CPUs (first-touch policy).
+static bool createTaskNodes(ThreadPool threadPool, size_t taskCapacity)
+{
+	size_t allowedCount = getCurrentThreadAffinity(NULL, 0);
+	size_t* allowedCpus = allowedCount > 0 ? malloc(allowedCount * sizeof(size_t)) : NULL;
+	allowedCount = allowedCpus ? getCurrentThreadAffinity(allowedCpus, allowedCount) : 0;
+
+	size_t systemNodeCount = getNumaNodeCount();
+	size_t** nodeCpus = calloc(systemNodeCount, sizeof(size_t*));
+	size_t* nodeCpuCounts = calloc(systemNodeCount, sizeof(size_t));
+	TaskNode** nodes = calloc(systemNodeCount, sizeof(TaskNode*));
+	threadPool->nodes = nodes;
+
+	if (!nodeCpus || !nodeCpuCounts || !nodes)
+	{
+		free(nodeCpuCounts); free(nodeCpus); free(allowedCpus);
+		return false;
+	}
+
+	size_t nodeCount = 0, maxCpu = 0;
+	for (size_t i = 0; i < systemNodeCount; i++)
+	{
+		size_t cpuCount = getNumaNodeCpus(i, NULL, 0);
+		size_t* cpus = cpuCount > 0 ? malloc(cpuCount * sizeof(size_t)) : NULL;
+		if (!cpus)
+			continue;
+		cpuCount = getNumaNodeCpus(i, cpus, cpuCount);
+
+		// Note: leaving only CPUs the pool is allowed to run on, memory-only nodes are skipped.
+		size_t count = 0;
+		for (size_t j = 0; j < cpuCount; j++)
+		{
+			bool isAllowed = allowedCount == 0;
+			for (size_t k = 0; k < allowedCount && !isAllowed; k++)
+				isAllowed = allowedCpus[k] == cpus[j];
+			if (!isAllowed)
+				continue;
+
+			cpus[count++] = cpus[j];
+			if (cpus[j] > maxCpu)
+				maxCpu = cpus[j];
+		}
+
+		if (count == 0)
+		{
+			free(cpus);
+			continue;
+		}
+
+		nodeCpus[nodeCount] = cpus;
+		nodeCpuCounts[nodeCount++] = count;
+	}
+
+	if (nodeCount == 0)
+		nodeCount = 1; // Note: unknown topology, single node without CPU binding.
+	threadPool->nodeCount = nodeCount;
+
+	size_t nodeCapacity = (taskCapacity + nodeCount - 1) / nodeCount;
+	bool result = true;
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (nodeCount > 1)
+			setCurrentThreadAffinity(nodeCpus[i], nodeCpuCounts[i]);
+
+		TaskNode* taskNode = createTaskNode(nodeCapacity, nodeCpus[i], nodeCpuCounts[i]);
+		if (!taskNode)
+		{
+			for (size_t j = i; j < nodeCount; j++)
+				free(nodeCpus[j]);
+			result = false;
+			break;
+		}
+		nodes[i] = taskNode;
+	}
+
+	if (nodeCount > 1 && allowedCount > 0)
+		setCurrentThreadAffinity(allowedCpus, allowedCount);
+	free(nodeCpuCounts); free(nodeCpus); free(allowedCpus);
+
+	if (!result)
+		return false;
+	threadPool->taskCapacity = nodeCapacity * nodeCount;
+
+	if (nodeCount == 1)
+		return true;
+
+	size_t* cpuNodes = malloc((maxCpu + 1) * sizeof(size_t));
+	if (!cpuNodes)
+		return false;
+
+	for (size_t i = 0; i <= maxCpu; i++)
+		cpuNodes[i] = SIZE_MAX;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		TaskNode* taskNode = nodes[i];
+		for (size_t j = 0; j < taskNode->cpuCount; j++)
+			cpuNodes[taskNode->cpus[j]] = i;
+	}
+
+	threadPool->cpuNodes = cpuNodes;
+	threadPool->cpuNodeCount = maxCpu + 1;
+	return true;
+}
+
+static int compareCompactCpus(const void* a, const void* b)
+{
+	const CpuLocation* l = a; const CpuLocation* r = b;
+	if (l->package != r->package)
+		return l->package < r->package ? -1 : 1;
+	if (l->coreRank != r->coreRank)
+		return l->coreRank < r->coreRank ? -1 : 1;
+	return l->siblingRank < r->siblingRank ? -1 : (l->siblingRank > r->siblingRank ? 1 : 0);
+}
+static int compareScatterCpus(const void* a, const void* b)
+{
+	const CpuLocation* l = a; const CpuLocation* r = b;
+	if (l->siblingRank != r->siblingRank)
+		return l->siblingRank < r->siblingRank ? -1 : 1;
+	if (l->coreRank != r->coreRank)
+		return l->coreRank < r->coreRank ? -1 : 1;
+	return l->package < r->package ? -1 : (l->package > r->package ? 1 : 0);
+}
+
+// Note: orders allowed logical CPUs by the package, physical core and SMT sibling.
+static size_t* getPinningCpus(ThreadPinning pinning, size_t* cpuCount)
+{
+	size_t allowedCount = getCurrentThreadAffinity(NULL, 0);
+	if (allowedCount == 0)
+		return NULL;
+
+	size_t* cpus = malloc(allowedCount * sizeof(size_t));
+	if (!cpus)
+		return NULL;
+	allowedCount = getCurrentThreadAffinity(cpus, allowedCount);
+
+	CpuLocation* locations = malloc(allowedCount * sizeof(CpuLocation));
+	size_t* cores = malloc(allowedCount * sizeof(size_t));
+	if (!locations || !cores)
+	{
+		free(cores);
+		free(locations);
+		free(cpus);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < allowedCount; i++)
+	{
+		CpuLocation* location = &locations[i];
+		size_t package = getCpuPackage(cpus[i]);
+		size_t core = getCpuCore(cpus[i]);
+		if (package == SIZE_MAX || core == SIZE_MAX)
+		{
+			package = 0; core = cpus[i]; // Note: unknown topology, each CPU is a separate core.
+		}
+
+		location->cpu = cpus[i];
+		location->package = package;
+		location->coreRank = 0;
+		location->siblingRank = 0;
+		cores[i] = core;
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (locations[j].package != package)
+				continue;
+			if (cores[j] == core)
+			{
+				location->coreRank = locations[j].coreRank;
+				location->siblingRank++;
+			}
+			else if (locations[j].siblingRank == 0 && location->siblingRank == 0)
+			{
+				location->coreRank++; // Note: counts distinct cores of the package before this one.
+			}
+		}
+	}
+
+	qsort(locations, allowedCount, sizeof(CpuLocation), 
+		pinning == SCATTER_THREAD_PINNING ? compareScatterCpus : compareCompactCpus);
+	for (size_t i = 0; i < allowedCount; i++)
+		cpus[i] = locations[i].cpu;
+
+	free(cores);
+	free(locations);
+	*cpuCount = allowedCount;
+	return cpus;
+}
+
+//**********************************************************************************************************************
+// Note: worker slots are allocated for the maximal thread count, only minimal count of them is started.
+static ThreadPool createWorkerPool(size_t minThreadCount, size_t maxThreadCount, size_t taskCapacity, 
+	TaskOrder taskOrder, ThreadPinning pinning, const size_t* cpus, size_t cpuCount, 
+	const ThreadOptions* workerOptions, size_t spawnDepth, double keepAlive)
+{
+	assert(taskOrder < TASK_ORDER_COUNT);
+	assert(taskCapacity > 0);
+	assert(taskCapacity >= maxThreadCount);
+	assert(maxThreadCount == 0 || minThreadCount <= maxThreadCount);
+	assert(pinning < THREAD_PINNING_COUNT);
+	assert(!workerOptions || (!workerOptions->stack && !workerOptions->isDetached));
+	assert(keepAlive >= 0.0);
+
+	if (maxThreadCount == 0)
+	{
+		maxThreadCount = getAvailableCpuCount();
+		if (maxThreadCount > taskCapacity)
+			maxThreadCount = taskCapacity;
+		if (minThreadCount == 0 || minThreadCount > maxThreadCount)
+			minThreadCount = maxThreadCount;
+	}
+	if (minThreadCount == 0)
+		minThreadCount = 1;
+	assert(pinning != EXPLICIT_THREAD_PINNING || (cpus && cpuCount > 0));
+
+	ThreadPool threadPool = calloc(1, sizeof(ThreadPool_T));
+	if (!threadPool)
+		return NULL;
+
+	threadPool->minThreadCount = (int64_t)minThreadCount;
+	threadPool->maxThreadCount = (int64_t)maxThreadCount;
+	threadPool->spawnDepth = spawnDepth > 0 ? spawnDepth : 1;
+	threadPool->keepAlive = keepAlive;
+	threadPool->workingCount = 0;
+	threadPool->taskOrder = taskOrder;
+	threadPool->pinning = pinning;
+	threadPool->isRunning = true;
+	threadPool->idlePolicy = PARK_IDLE_POLICY;
+	threadPool->spinCount = THREAD_POOL_DEFAULT_SPIN_COUNT;
+	threadPool->yieldCount = THREAD_POOL_DEFAULT_YIELD_COUNT;
+	threadPool->priorityWeights[HIGH_TASK_PRIORITY] = THREAD_POOL_DEFAULT_PRIORITY_WEIGHT;
+	threadPool->priorityWeights[NORMAL_TASK_PRIORITY] = THREAD_POOL_DEFAULT_PRIORITY_WEIGHT;
+
+	if (!initMutex(&threadPool->mutex))
+	{
+		free(threadPool);
+		return NULL;
+	}
+	if (!initCond(&threadPool->workCond))
+	{
+		deinitMutex(&threadPool->mutex);
+		free(threadPool);
+		return NULL;
+	}
+	if (!initCond(&threadPool->spaceCond))
+	{
+		deinitCond(&threadPool->workCond);
+		deinitMutex(&threadPool->mutex);
+		free(threadPool);
+		return NULL;
+	}
+	if (!initCond(&threadPool->doneCond))
+	{
+		deinitCond(&threadPool->spaceCond);
+		deinitCond(&threadPool->workCond);
+		deinitMutex(&threadPool->mutex);
+		free(threadPool);
+		return NULL;
+	}
+
+	if (taskOrder == LOCK_FREE_TASK_ORDER)
+	{
+		LockFreeQueue taskQueue = createLockFreeQueue(taskCapacity, sizeof(PoolTask));
+		if (!taskQueue)
+		{
+			destroyThreadPool(threadPool);
+			return NULL;
+		}
+		threadPool->taskQueue = taskQueue;
+		threadPool->taskCapacity = getLockFreeQueueCapacity(taskQueue);
+	}
+	else if (taskOrder == NUMA_TASK_ORDER)
+	{
+		if (!createTaskNodes(threadPool, taskCapacity))
+		{
+			destroyThreadPool(threadPool);
+			return NULL;
+		}
+	}
+	else if (taskOrder == SEGMENTED_TASK_ORDER)
+	{
+		threadPool->taskCapacity = taskCapacity; // Note: segments are allocated by the adding threads.
+	}
+	else
+	{
+		PoolTask* tasks = malloc(taskCapacity * sizeof(PoolTask));
+		if (!tasks)
+		{
+			destroyThreadPool(threadPool);
+			return NULL;
+		}
+		threadPool->tasks = tasks;
+		threadPool->taskCapacity = taskCapacity;
+	}
+
+	threadPool->taskHead = 0;
+	threadPool->taskCount = 0;
+	if (threadPool->nodeCount == 0)
+		threadPool->nodeCount = 1;
+
+	Thread* threads = calloc(maxThreadCount, sizeof(Thread));
+	if (!threads)
+	{
+		destroyThreadPool(threadPool);
+		return NULL;
+	}
+	threadPool->threads = threads;
+	threadPool->threadCapacity = maxThreadCount;
+
+	ThreadPoolWorker* workers = calloc(maxThreadCount, sizeof(ThreadPoolWorker));
+	if (!workers)
+	{
+		destroyThreadPool(threadPool);
+		return NULL;
+	}
+	threadPool->workers = workers;
+
+	size_t dequeCapacity = MIN_DEQUE_CAPACITY;
+	if (taskOrder == STEALING_TASK_ORDER)
+	{
+		while (dequeCapacity < taskCapacity / maxThreadCount)
+			dequeCapacity <<= 1;
+	}
+
+	for (size_t i = 0; i < maxThreadCount; i++)
+	{
+		ThreadPoolWorker* worker = &workers[i];
+		worker->threadPool = threadPool;
+		worker->cpu = SIZE_MAX;
+		worker->node = i * threadPool->nodeCount / maxThreadCount; // Note: contiguous per-node worker groups.
+		worker->seed = (uint32_t)i * 2654435761u + 1u;
+
+		if (taskOrder != STEALING_TASK_ORDER)
+			continue;
+
+		PoolTask* dequeTasks = malloc(dequeCapacity * sizeof(PoolTask));
+		if (!dequeTasks)
+		{
+			destroyThreadPool(threadPool);
+			return NULL;
+		}
+		worker->deque.tasks = dequeTasks;
+		worker->deque.mask = (int64_t)dequeCapacity - 1;
+	}
+
+	if (pinning != NO_THREAD_PINNING)
+	{
+		size_t* pinningCpus = NULL;
+		if (pinning != EXPLICIT_THREAD_PINNING)
+		{
+			pinningCpus = getPinningCpus(pinning, &cpuCount);
+			if (!pinningCpus)
+			{
+				destroyThreadPool(threadPool);
+				return NULL;
+			}
+			cpus = pinningCpus;
+		}
+
+		for (size_t i = 0; i < maxThreadCount; i++)
+		{
+			ThreadPoolWorker* worker = &workers[i];
+			if (threadPool->nodeCount == 1)
+			{
+				worker->cpu = cpus[i % cpuCount];
+			}
+			else if (pinning == EXPLICIT_THREAD_PINNING)
+			{
+				worker->cpu = cpus[i % cpuCount];
+				size_t node = getCpuNode(threadPool, worker->cpu);
+				if (node != SIZE_MAX)
+					worker->node = node;
+			}
+			else
+			{
+				// Note: taking compact or scatter ordered CPUs of the worker node.
+				size_t nodeIndex = 0, nodeCpuCount = threadPool->nodes[worker->node]->cpuCount;
+				for (size_t j = 0; j < i; j++)
+					nodeIndex += workers[j].node == worker->node;
+				nodeIndex %= nodeCpuCount;
+
+				worker->cpu = cpus[i % cpuCount];
+				for (size_t j = 0; j < cpuCount; j++)
+				{
+					if (getCpuNode(threadPool, cpus[j]) != worker->node)
+						continue;
+					if (nodeIndex-- == 0)
+					{
+						worker->cpu = cpus[j];
+						break;
+					}
+				}
+			}
+		}
+		free(pinningCpus);
+	}
+
+	if (workerOptions)
+	{
+		ThreadOptions* options = &threadPool->workerOptions;
+		*options = *workerOptions;
+
+		// Note: copying name and CPUs, workers can be started after the creation.
+		if (options->name)
+		{
+			snprintf(threadPool->workerName, sizeof(threadPool->workerName), "%s", options->name);
+			options->name = threadPool->workerName;
+		}
+		if (options->cpus)
+		{
+			size_t* workerCpus = malloc(options->cpuCount * sizeof(size_t));
+			if (!workerCpus)
+			{
+				destroyThreadPool(threadPool);
+				return NULL;
+			}
+			memcpy(workerCpus, options->cpus, options->cpuCount * sizeof(size_t));
+			threadPool->workerCpus = workerCpus;
+			options->cpus = workerCpus;
+		}
+	}
+
+	lockMutex(&threadPool->mutex);
+	for (size_t i = 0; i < minThreadCount; i++)
+	{
+		if (startWorker(threadPool))
+			continue;
+
+		unlockMutex(&threadPool->mutex);
+		destroyThreadPool(threadPool);
+		return NULL;
+	}
+	unlockMutex(&threadPool->mutex);
+
+	return threadPool;
+}
+
+ThreadPool createThreadPool(size_t threadCount, size_t taskCapacity, TaskOrder taskOrder)
+{
+	return createPinnedThreadPool(threadCount, taskCapacity, taskOrder, NO_THREAD_PINNING, NULL, 0);
+}
+ThreadPool createPinnedThreadPool(size_t threadCount, size_t taskCapacity, 
+	TaskOrder taskOrder, ThreadPinning pinning, const size_t* cpus, size_t cpuCount)
+{
+	return createThreadPoolWithOptions(threadCount, taskCapacity, taskOrder, pinning, cpus, cpuCount, NULL);
+}
+ThreadPool createThreadPoolWithOptions(size_t threadCount, size_t taskCapacity, TaskOrder taskOrder, 
+	ThreadPinning pinning, const size_t* cpus, size_t cpuCount, const ThreadOptions* workerOptions)
+{
+	return createWorkerPool(threadCount, threadCount, taskCapacity, 
+		taskOrder, pinning, cpus, cpuCount, workerOptions, 1, THREAD_POOL_DEFAULT_KEEP_ALIVE);
+}
+ThreadPool createElasticThreadPool(size_t minThreadCount, size_t maxThreadCount, 
+	size_t taskCapacity, TaskOrder taskOrder, size_t spawnDepth, double keepAlive)
+{
+	assert(minThreadCount > 0);
+	return createWorkerPool(minThreadCount, maxThreadCount, taskCapacity, 
+		taskOrder, NO_THREAD_PINNING, NULL, 0, NULL, spawnDepth, keepAlive);
+}
+void destroyThreadPool(ThreadPool threadPool)
+{
+	if (!threadPool)
+		return;
+
+	Thread* threads = threadPool->threads;
+	size_t threadCapacity = threadPool->threadCapacity;
+
+	if (threads)
+	{
+		// Note: busy-polling workers check the running state only on the sleeping path.
+		atomicStore32(&threadPool->idlePolicy, PARK_IDLE_POLICY);
+
+		Mutex mutex = &threadPool->mutex;
+		lockMutex(mutex);
+		threadPool->isRunning = false;
+		broadcastCond(&threadPool->workCond);
+		unlockMutex(mutex);
+
+		for (size_t i = 0; i < threadCapacity; i++)
+		{
+			Thread thread = threads[i];
+			if (!thread)
+				continue;
+			joinThread(thread);
+			destroyThread(thread);
+		}
+
+		free(threads);
+	}
+
+	ThreadPoolWorker* workers = threadPool->workers;
+	if (workers)
+	{
+		for (size_t i = 0; i < threadCapacity; i++)
+			free(workers[i].deque.tasks);
+		free(workers);
+	}
+
+	TaskNode** nodes = threadPool->nodes;
+	if (nodes)
+	{
+		for (size_t i = 0; i < threadPool->nodeCount; i++)
+			destroyTaskNode(nodes[i]);
+		free(nodes);
+	}
+
+	destroyLockFreeQueue(threadPool->taskQueue);
+	for (TaskPriority i = 0; i < TASK_PRIORITY_COUNT; i++)
+		destroyTaskSegments(threadPool->segmentQueues[i].headSegment);
+	destroyTaskSegments(threadPool->freeSegments);
+	free(threadPool->workerCpus);
+	free(threadPool->cpuNodes);
+	free(threadPool->tasks);
+	deinitCond(&threadPool->doneCond);
+	deinitCond(&threadPool->spaceCond);
+	deinitCond(&threadPool->workCond);
+	deinitMutex(&threadPool->mutex);
+	free(threadPool);
+}
+
+//**********************************************************************************************************************
+size_t getThreadPoolThreadCount(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return (size_t)atomicLoad64(&threadPool->threadCount);
+}
+size_t getThreadPoolThreadCapacity(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return threadPool->threadCapacity;
+}
+size_t getThreadPoolMinThreadCount(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return (size_t)atomicLoad64(&threadPool->minThreadCount);
+}
+size_t getThreadPoolMaxThreadCount(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return (size_t)atomicLoad64(&threadPool->maxThreadCount);
+}
+size_t getThreadPoolTaskCapacity(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return threadPool->taskCapacity;
+}
+bool isThreadPoolRunning(ThreadPool threadPool)
+{
+	if (isPendingCounted(threadPool->taskOrder))
+		return atomicLoad64(&threadPool->pendingCount) != 0;
+
+	Mutex mutex = &threadPool->mutex;
+	lockMutex(mutex);
+	bool isRunning = threadPool->taskCount || threadPool->workingCount;
+	unlockMutex(mutex);
+	return isRunning;
+}
+
+TaskOrder getThreadPoolTaskOrder(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return threadPool->taskOrder;
+}
+ThreadPinning getThreadPoolPinning(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return threadPool->pinning;
+}
+size_t getThreadPoolThreadCpu(ThreadPool threadPool, size_t threadIndex)
+{
+	assert(threadPool);
+	assert(threadIndex < threadPool->threadCapacity);
+	return threadPool->workers[threadIndex].cpu;
+}
+bool setThreadPoolThreadLimits(ThreadPool threadPool, size_t minThreadCount, size_t maxThreadCount)
+{
+	assert(threadPool);
+	assert(minThreadCount > 0);
+	assert(minThreadCount <= maxThreadCount);
+	assert(maxThreadCount <= threadPool->threadCapacity);
+
+	Mutex mutex = &threadPool->mutex;
+	lockMutex(mutex);
+	atomicStore64(&threadPool->minThreadCount, (int64_t)minThreadCount);
+	atomicStore64(&threadPool->maxThreadCount, (int64_t)maxThreadCount);
+
+	bool result = true;
+	while (atomicLoad64(&threadPool->threadCount) < (int64_t)minThreadCount)
+	{
+		if (!startWorker(threadPool))
+		{
+			result = false;
+			break;
+		}
+	}
+
+	// Note: waking sleeping workers, so that the extra ones retire without draining the pool.
+	broadcastCond(&threadPool->workCond);
+	unlockMutex(mutex);
+	return result;
+}
+bool setThreadPoolThreadCount(ThreadPool threadPool, size_t threadCount)
+{
+	return setThreadPoolThreadLimits(threadPool, threadCount, threadCount);
+}
+
+IdlePolicy getThreadPoolIdlePolicy(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return (IdlePolicy)atomicLoad32(&threadPool->idlePolicy);
+}
+void setThreadPoolIdlePolicy(ThreadPool threadPool, IdlePolicy idlePolicy, uint32_t spinCount, uint32_t yieldCount)
+{
+	assert(threadPool);
+	assert(idlePolicy < IDLE_POLICY_COUNT);
+	assert(spinCount <= INT32_MAX);
+	assert(yieldCount <= INT32_MAX);
+
+	atomicStore32(&threadPool->spinCount, (int32_t)spinCount);
+	atomicStore32(&threadPool->yieldCount, (int32_t)yieldCount);
+	atomicStore32(&threadPool->idlePolicy, idlePolicy);
+
+	// Note: sleeping workers pick up the new policy after the next task.
+}
+void setThreadPoolPriorityWeights(ThreadPool threadPool, uint32_t highWeight, uint32_t normalWeight)
+{
+	assert(threadPool);
+	Mutex mutex = &threadPool->mutex;
+	lockMutex(mutex);
+	threadPool->priorityWeights[HIGH_TASK_PRIORITY] = highWeight;
+	threadPool->priorityWeights[NORMAL_TASK_PRIORITY] = normalWeight;
+	unlockMutex(mutex);
+}
+
+void setThreadPoolTaskOrder(ThreadPool threadPool, TaskOrder taskOrder)
+{
+	assert(threadPool);
+	assert(taskOrder < TASK_ORDER_COUNT);
+	assert(taskOrder <= QUEUE_TASK_ORDER || taskOrder == threadPool->taskOrder);
+	assert(threadPool->taskOrder <= QUEUE_TASK_ORDER || taskOrder == threadPool->taskOrder);
+	waitThreadPool(threadPool);
+	threadPool->taskOrder = taskOrder;
+}
+
+bool resizeThreadPoolTasks(ThreadPool threadPool, size_t taskCapacity)
+{
+	assert(threadPool);
+	assert(taskCapacity > 0);
+
+	if (threadPool->taskOrder == LOCK_FREE_TASK_ORDER)
+		return false; // Note: threads are accessing the queue without the mutex.
+	if (threadPool->taskOrder == NUMA_TASK_ORDER)
+		return false; // Note: node queues are allocated on their nodes at the creation time.
+
+	Mutex mutex = &threadPool->mutex;
+	if (threadPool->taskOrder == SEGMENTED_TASK_ORDER)
+	{
+		lockMutex(mutex);
+		threadPool->taskCapacity = taskCapacity;
+		broadcastCond(&threadPool->spaceCond);
+		unlockMutex(mutex);
+		return true;
+	}
+
+	PoolTask* tasks = malloc(taskCapacity * sizeof(PoolTask));
+	if (!tasks)
+		return false;
+
+	lockMutex(mutex);
+
+	size_t taskCount = getRingTaskCount(threadPool);
+	if (threadPool->taskCount > taskCapacity)
+	{
+		unlockMutex(mutex);
+		free(tasks);
+		return false;
+	}
+
+	// Note: linearizing the ring, workers keep running and adding tasks, they are blocked only during the copy.
+	PoolTask* oldTasks = threadPool->tasks;
+	size_t oldCapacity = threadPool->taskCapacity;
+	size_t taskHead = threadPool->taskHead;
+
+	for (size_t i = 0; i < taskCount; i++)
+	{
+		size_t index = taskHead + i;
+		copyPoolTask(&tasks[i], &oldTasks[index < oldCapacity ? index : index - oldCapacity]);
+	}
+
+	threadPool->tasks = tasks;
+	threadPool->taskCapacity = taskCapacity;
+	threadPool->taskHead = 0;
+	broadcastCond(&threadPool->spaceCond);
+
+	unlockMutex(mutex);
+	free(oldTasks);
+	return true;
+}
+
+//**********************************************************************************************************************
+bool tryAddThreadPoolTask(ThreadPool threadPool, ThreadPoolTask task)
+{
+	assert(threadPool);
+	assert(task.function);
+	return addTasks(threadPool, NULL, &task, 1, THREAD_POOL_ANY_NODE, false, true, false) == 1;
+}
+void addThreadPoolTask(ThreadPool threadPool, ThreadPoolTask task)
+{
+	assert(threadPool);
+	assert(task.function);
+	addTasks(threadPool, NULL, &task, 1, THREAD_POOL_ANY_NODE, false, true, true);
+}
+
+void addThreadPoolTasks(ThreadPool threadPool,
+	ThreadPoolTask* tasks, size_t taskCount)
+{
+	assert(threadPool);
+	assert(tasks);
+	assert(taskCount > 0);
+
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
+
+	addTasks(threadPool, NULL, tasks, taskCount, THREAD_POOL_ANY_NODE, false, false, true);
+}
+void addThreadPoolTaskNumber(ThreadPool threadPool,
+	ThreadPoolTask task, size_t taskCount)
+{
+	assert(threadPool);
+	assert(task.function);
+	assert(taskCount > 0);
+	addTasks(threadPool, NULL, &task, taskCount, THREAD_POOL_ANY_NODE, false, true, true);
+}
+
+bool tryAddThreadPoolPriorityTask(ThreadPool threadPool, ThreadPoolTask task, TaskPriority priority)
+{
+	assert(threadPool);
+	assert(task.function);
+	assert(priority < TASK_PRIORITY_COUNT);
+	return addPriorityTasks(threadPool, NULL, &task, 1, THREAD_POOL_ANY_NODE, priority, false, true, false) == 1;
+}
+void addThreadPoolPriorityTask(ThreadPool threadPool, ThreadPoolTask task, TaskPriority priority)
+{
+	assert(threadPool);
+	assert(task.function);
+	assert(priority < TASK_PRIORITY_COUNT);
+	addPriorityTasks(threadPool, NULL, &task, 1, THREAD_POOL_ANY_NODE, priority, false, true, true);
+}
+
+void addThreadPoolPriorityTasks(ThreadPool threadPool, const ThreadPoolTask* tasks, 
+	size_t taskCount, TaskPriority priority)
+{
+	assert(threadPool);
+	assert(tasks);
+	assert(taskCount > 0);
+	assert(priority < TASK_PRIORITY_COUNT);
+
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
+
+	addPriorityTasks(threadPool, NULL, tasks, taskCount, THREAD_POOL_ANY_NODE, priority, false, false, true);
+}
+void addThreadPoolPriorityTaskNumber(ThreadPool threadPool, ThreadPoolTask task, 
+	size_t taskCount, TaskPriority priority)
+{
+	assert(threadPool);
+	assert(task.function);
+	assert(taskCount > 0);
+	assert(priority < TASK_PRIORITY_COUNT);
+	addPriorityTasks(threadPool, NULL, &task, taskCount, THREAD_POOL_ANY_NODE, priority, false, true, true);
+}
+
+bool tryAddThreadPoolInlineTask(ThreadPool threadPool, const ThreadPoolInlineTask* task)
+{
+	assert(threadPool);
+	assert(task);
+	assert(task->function);
+	return addTasks(threadPool, NULL, task, 1, THREAD_POOL_ANY_NODE, true, true, false) == 1;
+}
+void addThreadPoolInlineTask(ThreadPool threadPool, const ThreadPoolInlineTask* task)
+{
+	assert(threadPool);
+	assert(task);
+	assert(task->function);
+	addTasks(threadPool, NULL, task, 1, THREAD_POOL_ANY_NODE, true, true, true);
+}
+
+void addThreadPoolInlineTasks(ThreadPool threadPool, const ThreadPoolInlineTask* tasks, size_t taskCount)
+{
+	assert(threadPool);
+	assert(tasks);
+	assert(taskCount > 0);
+
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
+
+	addTasks(threadPool, NULL, tasks, taskCount, THREAD_POOL_ANY_NODE, true, false, true);
+}
+void addThreadPoolInlineTaskNumber(ThreadPool threadPool, const ThreadPoolInlineTask* task, size_t taskCount)
+{
+	assert(threadPool);
+	assert(task);
+	assert(task->function);
+	assert(taskCount > 0);
+	addTasks(threadPool, NULL, task, taskCount, THREAD_POOL_ANY_NODE, true, true, true);
+}
+
+bool tryAddThreadPoolNodeTask(ThreadPool threadPool, ThreadPoolTask task, size_t node)
+{
+	assert(threadPool);
+	assert(task.function);
+	return addTasks(threadPool, NULL, &task, 1, node, false, true, false) == 1;
+}
+void addThreadPoolNodeTask(ThreadPool threadPool, ThreadPoolTask task, size_t node)
+{
+	assert(threadPool);
+	assert(task.function);
+	addTasks(threadPool, NULL, &task, 1, node, false, true, true);
+}
+void addThreadPoolNodeTasks(ThreadPool threadPool, const ThreadPoolTask* tasks, size_t taskCount, size_t node)
+{
+	assert(threadPool);
+	assert(tasks);
+	assert(taskCount > 0);
+
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
+
+	addTasks(threadPool, NULL, tasks, taskCount, node, false, false, true);
+}
+
+size_t getThreadPoolNodeCount(ThreadPool threadPool)
+{
+	assert(threadPool);
+	return threadPool->nodeCount;
+}
+size_t getThreadPoolThreadNode(ThreadPool threadPool, size_t threadIndex)
+{
+	assert(threadPool);
+	assert(threadIndex < threadPool->threadCapacity);
+	return threadPool->workers[threadIndex].node;
+}
 
-static void onThreadUpdate(void* argument)
+void waitThreadPool(ThreadPool threadPool)
 {
-	ThreadPool threadPool = argument;
-	Mutex mutex = threadPool->mutex;
-	Cond workCond = threadPool->workCond;
-	Cond workingCond = threadPool->workingCond;
+	assert(threadPool);
+
+	Mutex mutex = &threadPool->mutex;
+	Cond doneCond = &threadPool->doneCond;
 
 	lockMutex(mutex);
+	atomicFetchAdd64(&threadPool->doneWaitingCount, 1);
+	if (isPendingCounted(threadPool->taskOrder))
+	{
+		while (atomicLoad64(&threadPool->pendingCount))
+			waitCond(doneCond, mutex);
+	}
+	else
+	{
+		while (threadPool->taskCount || threadPool->workingCount)
+			waitCond(doneCond, mutex);
+	}
+	atomicFetchAdd64(&threadPool->doneWaitingCount, -1);
+	unlockMutex(mutex);
+}
+
+//**********************************************************************************************************************
+static void runParallelFor(ParallelFor* parallelFor)
+{
+	int64_t end = parallelFor->end;
+	int64_t grain = parallelFor->grain;
+	int64_t divisor = parallelFor->divisor;
+	int64_t rangeBegin = atomicLoad64(&parallelFor->next);
 
 	while (true)
 	{
-		size_t taskCount = threadPool->taskCount;
-		while (taskCount == 0)
-		{
-			if (!threadPool->isRunning)
-			{
-				unlockMutex(mutex);
-				return;
-			}
-
-			waitCond(workCond, mutex);
-			taskCount = threadPool->taskCount;
-		}
+		int64_t remaining = end - rangeBegin;
+		if (remaining <= 0)
+			return;
 
-		threadPool->workingCount++;
-		threadPool->taskCount--;
+		// Note: guided scheduling, chunks are getting smaller as the range runs out.
+		int64_t chunkSize = remaining / divisor;
+		if (chunkSize < grain)
+			chunkSize = grain < remaining ? grain : remaining;
 
-		ThreadPoolTask* tasks = threadPool->tasks;
-		TaskOrder taskOrder = threadPool->taskOrder;
+		if (!atomicCompareExchange64(&parallelFor->next, &rangeBegin, rangeBegin + chunkSize))
+			continue;
 
-		ThreadPoolTask task;
-		if (taskOrder == STACK_TASK_ORDER)
-		{
-			task = tasks[taskCount - 1];
-		}
-		else if (taskOrder == QUEUE_TASK_ORDER)
-		{
-			task = tasks[0];
+		size_t offset = parallelFor->offset;
+		parallelFor->function(parallelFor->context, offset + (size_t)rangeBegin, 
+			offset + (size_t)(rangeBegin + chunkSize));
 
-			for (size_t i = 1; i < taskCount; i++)
-				tasks[i - 1] = tasks[i];
-		}
-		else
+		if (atomicFetchAdd64(&parallelFor->doneCount, chunkSize) + chunkSize == end)
 		{
-			abort();
+			broadcastTasksDone(parallelFor->threadPool, false);
+			return;
 		}
 
-		unlockMutex(mutex);
-		task.function(task.argument);
-		lockMutex(mutex);
-
-		threadPool->workingCount--;
-		broadcastCond(workingCond);
+		rangeBegin = atomicLoad64(&parallelFor->next);
 	}
 }
-
-//**********************************************************************************************************************
-ThreadPool createThreadPool(size_t threadCount, size_t taskCapacity, TaskOrder taskOrder)
+static void releaseParallelFor(ParallelFor* parallelFor)
 {
-	assert(threadCount);
-	assert(taskOrder < TASK_ORDER_COUNT);
-	assert(taskCapacity >= threadCount);
-
-	ThreadPool threadPool = calloc(1, sizeof(ThreadPool_T));
-	if (!threadPool)
-		return NULL;
+	if (atomicFetchAdd64(&parallelFor->refCount, -1) == 1)
+		free(parallelFor);
+}
+static void onParallelForTask(void* argument)
+{
+	ParallelFor* parallelFor = argument;
+	runParallelFor(parallelFor);
+	releaseParallelFor(parallelFor);
+}
 
-	threadPool->workingCount = 0;
-	threadPool->taskOrder = taskOrder;
-	threadPool->isRunning = true;
+void parallelForThreadPool(ThreadPool threadPool, size_t begin, size_t end, 
+	size_t grain, ParallelForFunction function, void* context)
+{
+	assert(threadPool);
+	assert(begin <= end);
+	assert(function);
 
-	Mutex mutex = createMutex();
-	if (!mutex)
-	{
-		destroyThreadPool(threadPool);
-		return NULL;
-	}
-	threadPool->mutex = mutex;
+	size_t rangeSize = end - begin;
+	if (rangeSize == 0)
+		return;
 
-	Cond workCond = createCond();
-	if (!workCond)
+	size_t threadCount = (size_t)atomicLoad64(&threadPool->threadCount);
+	if (grain == 0)
 	{
-		destroyThreadPool(threadPool);
-		return NULL;
+		grain = rangeSize / (threadCount * 8);
+		if (grain == 0)
+			grain = 1;
 	}
-	threadPool->workCond = workCond;
 
-	Cond workingCond = createCond();
-	if (!workingCond)
-	{
-		destroyThreadPool(threadPool);
-		return NULL;
-	}
-	threadPool->workingCond = workingCond;
+	size_t helperCount = (rangeSize - 1) / grain;
+	if (helperCount > threadCount)
+		helperCount = threadCount;
 
-	ThreadPoolTask* tasks = malloc(taskCapacity * sizeof(ThreadPoolTask));
-	if (!tasks)
+	// Note: running the whole range on the calling thread, if it is too small or out of memory.
+	ParallelFor* parallelFor = helperCount > 0 ? malloc(sizeof(ParallelFor)) : NULL;
+	if (!parallelFor)
 	{
-		destroyThreadPool(threadPool);
-		return NULL;
+		function(context, begin, end);
+		return;
 	}
-	threadPool->tasks = tasks;
-	threadPool->taskCapacity = taskCapacity;
-	threadPool->taskCount = 0;
 
-	Thread* threads = calloc(threadCount, sizeof(Thread));
-	if (!threads)
-	{
-		destroyThreadPool(threadPool);
-		return NULL;
-	}
-	threadPool->threads = threads;
-	threadPool->threadCount = threadCount;
+	// Note: indices are shifted to start from zero, so done count can be compared with the end.
+	atomicStore64(&parallelFor->next, 0);
+	atomicStore64(&parallelFor->doneCount, 0);
+	atomicStore64(&parallelFor->refCount, (int64_t)helperCount + 1);
+	parallelFor->threadPool = threadPool;
+	parallelFor->function = function;
+	parallelFor->context = context;
+	parallelFor->offset = begin;
+	parallelFor->end = (int64_t)rangeSize;
+	parallelFor->grain = (int64_t)grain;
+	parallelFor->divisor = (int64_t)(threadCount + 1) * 2;
 
-	for (size_t i = 0; i < threadCount; i++)
+	// Note: not blocking on a full pool, calling thread will finish the rest of the range.
+	ThreadPoolTask task = { onParallelForTask, parallelFor };
+	for (size_t i = 0; i < helperCount; i++)
 	{
-		Thread thread = createThread(onThreadUpdate, threadPool);
-		if (!thread)
-		{
-			destroyThreadPool(threadPool);
-			return NULL;
-		}
-		threads[i] = thread;
+		if (tryAddThreadPoolTask(threadPool, task))
+			continue;
+		atomicFetchAdd64(&parallelFor->refCount, -(int64_t)(helperCount - i));
+		break;
 	}
 
-	return threadPool;
-}
-void destroyThreadPool(ThreadPool threadPool)
-{
-	if (!threadPool)
-		return;
-
-	Thread* threads = threadPool->threads;
-	size_t threadCount = threadPool->threadCount;
+	runParallelFor(parallelFor);
 
-	if (threads)
+	if (atomicLoad64(&parallelFor->doneCount) != (int64_t)rangeSize)
 	{
-		Mutex mutex = threadPool->mutex;
+		Mutex mutex = &threadPool->mutex;
+		Cond doneCond = &threadPool->doneCond;
+
 		lockMutex(mutex);
-		threadPool->isRunning = false;
-		broadcastCond(threadPool->workCond);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, 1);
+		while (atomicLoad64(&parallelFor->doneCount) != (int64_t)rangeSize)
+			waitCond(doneCond, mutex);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, -1);
 		unlockMutex(mutex);
-
-		for (size_t i = 0; i < threadCount; i++)
-		{
-			Thread thread = threads[i];
-			if (!thread)
-				continue;
-			joinThread(thread);
-			destroyThread(thread);
-		}
-
-		free(threads);
 	}
 
-	free(threadPool->tasks);
-	destroyCond(threadPool->workingCond);
-	destroyCond(threadPool->workCond);
-	destroyMutex(threadPool->mutex);
-	free(threadPool);
+	releaseParallelFor(parallelFor);
 }
 
 //**********************************************************************************************************************
-size_t getThreadPoolThreadCount(ThreadPool threadPool)
+TaskGroup createTaskGroup(ThreadPool threadPool)
 {
 	assert(threadPool);
-	return threadPool->threadCount;
+
+	TaskGroup taskGroup = malloc(sizeof(TaskGroup_T));
+	if (!taskGroup)
+		return NULL;
+
+	taskGroup->threadPool = threadPool;
+	atomicStore64(&taskGroup->pendingCount, 0);
+	return taskGroup;
 }
-size_t getThreadPoolTaskCapacity(ThreadPool threadPool)
+void destroyTaskGroup(TaskGroup taskGroup)
 {
-	assert(threadPool);
-	return threadPool->taskCapacity;
+	if (!taskGroup)
+		return;
+
+	waitTaskGroup(taskGroup);
+	free(taskGroup);
 }
-bool isThreadPoolRunning(ThreadPool threadPool)
+
+ThreadPool getTaskGroupThreadPool(TaskGroup taskGroup)
 {
-	Mutex mutex = threadPool->mutex;
-	lockMutex(mutex);
-	bool isRunning = threadPool->taskCount || threadPool->workingCount;
-	unlockMutex(mutex);
-	return isRunning;
+	assert(taskGroup);
+	return taskGroup->threadPool;
+}
+bool isTaskGroupRunning(TaskGroup taskGroup)
+{
+	assert(taskGroup);
+	return atomicLoad64(&taskGroup->pendingCount) != 0;
 }
 
-TaskOrder getThreadPoolTaskOrder(ThreadPool threadPool)
+bool tryAddTaskGroupTask(TaskGroup taskGroup, ThreadPoolTask task)
 {
-	assert(threadPool);
-	return threadPool->taskOrder;
+	assert(taskGroup);
+	assert(task.function);
+	return addTasks(taskGroup->threadPool, taskGroup, &task, 1, THREAD_POOL_ANY_NODE, false, true, false) == 1;
 }
-void setThreadPoolTaskOrder(ThreadPool threadPool, TaskOrder taskOrder)
+void addTaskGroupTask(TaskGroup taskGroup, ThreadPoolTask task)
 {
-	assert(threadPool);
-	waitThreadPool(threadPool);
-	threadPool->taskOrder = taskOrder;
+	assert(taskGroup);
+	assert(task.function);
+	addTasks(taskGroup->threadPool, taskGroup, &task, 1, THREAD_POOL_ANY_NODE, false, true, true);
 }
+void addTaskGroupTasks(TaskGroup taskGroup, ThreadPoolTask* tasks, size_t taskCount)
+{
+	assert(taskGroup);
+	assert(tasks);
+	assert(taskCount > 0);
 
-bool resizeThreadPoolTasks(ThreadPool threadPool, size_t taskCapacity)
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
+
+	addTasks(taskGroup->threadPool, taskGroup, tasks, taskCount, THREAD_POOL_ANY_NODE, false, false, true);
+}
+void addTaskGroupTaskNumber(TaskGroup taskGroup, ThreadPoolTask task, size_t taskCount)
 {
-	assert(threadPool);
-	assert(taskCapacity > 0);
+	assert(taskGroup);
+	assert(task.function);
+	assert(taskCount > 0);
+	addTasks(taskGroup->threadPool, taskGroup, &task, taskCount, THREAD_POOL_ANY_NODE, false, true, true);
+}
 
-	waitThreadPool(threadPool);
+bool tryAddTaskGroupInlineTask(TaskGroup taskGroup, const ThreadPoolInlineTask* task)
+{
+	assert(taskGroup);
+	assert(task);
+	assert(task->function);
+	return addTasks(taskGroup->threadPool, taskGroup, task, 1, THREAD_POOL_ANY_NODE, true, true, false) == 1;
+}
+void addTaskGroupInlineTask(TaskGroup taskGroup, const ThreadPoolInlineTask* task)
+{
+	assert(taskGroup);
+	assert(task);
+	assert(task->function);
+	addTasks(taskGroup->threadPool, taskGroup, task, 1, THREAD_POOL_ANY_NODE, true, true, true);
+}
+void addTaskGroupInlineTasks(TaskGroup taskGroup, const ThreadPoolInlineTask* tasks, size_t taskCount)
+{
+	assert(taskGroup);
+	assert(tasks);
+	assert(taskCount > 0);
 
-	ThreadPoolTask* tasks = realloc(threadPool->tasks,
-		taskCapacity * sizeof(ThreadPoolTask));
-	if (!tasks)
-		return false;
+	#ifndef NDEBUG
+	for (size_t i = 0; i < taskCount; i++)
+		assert(tasks[i].function);
+	#endif
 
-	threadPool->tasks = tasks;
-	threadPool->taskCapacity = taskCapacity;
-	return true;
+	addTasks(taskGroup->threadPool, taskGroup, tasks, taskCount, THREAD_POOL_ANY_NODE, true, false, true);
+}
+void addTaskGroupInlineTaskNumber(TaskGroup taskGroup, const ThreadPoolInlineTask* task, size_t taskCount)
+{
+	assert(taskGroup);
+	assert(task);
+	assert(task->function);
+	assert(taskCount > 0);
+	addTasks(taskGroup->threadPool, taskGroup, task, taskCount, THREAD_POOL_ANY_NODE, true, true, true);
 }
 
-bool tryAddThreadPoolTask(ThreadPool threadPool, ThreadPoolTask task)
+void waitTaskGroup(TaskGroup taskGroup)
 {
-	assert(threadPool);
-	assert(task.function);
+	assert(taskGroup);
 
-	Mutex mutex = threadPool->mutex;
-	lockMutex(mutex);
+	ThreadPool threadPool = taskGroup->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	Cond doneCond = &threadPool->doneCond;
 
-	size_t taskCount = threadPool->taskCount;
-	if (taskCount == threadPool->taskCapacity)
+	while (atomicLoad64(&taskGroup->pendingCount) != 0)
 	{
+		// Note: helping to execute pool tasks instead of sleeping, they can belong to this group.
+		if (tryRunThreadPoolTask(threadPool))
+			continue;
+
+		lockMutex(mutex);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, 1);
+		if (atomicLoad64(&taskGroup->pendingCount) != 0)
+			waitCond(doneCond, mutex);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, -1);
 		unlockMutex(mutex);
-		return false;
 	}
+}
 
-	threadPool->tasks[taskCount] = task;
-	threadPool->taskCount++;
-	signalCond(threadPool->workCond);
+//**********************************************************************************************************************
+#define COMPLETED_FUTURE ((void*)(uintptr_t)1)
 
-	unlockMutex(mutex);
-	return true;
+static Future allocateFuture(ThreadPool threadPool, int64_t refCount)
+{
+	Future future = malloc(sizeof(Future_T));
+	if (!future)
+		return NULL;
+
+	future->threadPool = threadPool;
+	future->result = NULL;
+	future->nextContinuation = NULL;
+	future->function = NULL;
+	future->argument = NULL;
+	future->antecedentResult = NULL;
+	atomicStorePtr(&future->continuations, NULL);
+	atomicStore64(&future->refCount, refCount);
+	return future;
 }
-void addThreadPoolTask(ThreadPool threadPool, ThreadPoolTask task)
+static void releaseFuture(Future future)
 {
-	assert(threadPool);
-	assert(task.function);
+	if (atomicFetchAdd64(&future->refCount, -1) == 1)
+		free(future);
+}
 
-	Mutex mutex = threadPool->mutex;
-	Cond workingCond = threadPool->workingCond;
-	size_t taskCapacity = threadPool->taskCapacity;
+static void onFutureTask(void* argument);
 
-	lockMutex(mutex);
+static void scheduleContinuation(Future continuation, void* result)
+{
+	continuation->antecedentResult = result;
+	ThreadPoolTask task = { onFutureTask, continuation };
+	addThreadPoolTask(continuation->threadPool, task);
+}
 
-	while (threadPool->taskCount == taskCapacity)
-		waitCond(workingCond, mutex);
+static void completeFuture(Future future, void* result)
+{
+	ThreadPool threadPool = future->threadPool;
+	future->result = result;
 
-	threadPool->tasks[threadPool->taskCount++] = task;
-	signalCond(threadPool->workCond);
+	Future continuation = atomicExchangePtr(&future->continuations, COMPLETED_FUTURE);
+	assert(continuation != COMPLETED_FUTURE);
+	broadcastTasksDone(threadPool, false);
 
-	unlockMutex(mutex);
+	// Note: continuations are linked in the reverse order, scheduling them in the order they were added.
+	Future previous = NULL;
+	while (continuation)
+	{
+		Future next = continuation->nextContinuation;
+		continuation->nextContinuation = previous;
+		previous = continuation;
+		continuation = next;
+	}
+	while (previous)
+	{
+		Future next = previous->nextContinuation;
+		scheduleContinuation(previous, result);
+		previous = next;
+	}
+}
+static void onFutureTask(void* argument)
+{
+	Future future = (Future)argument;
+	void* result = future->function(future->argument, future->antecedentResult);
+	completeFuture(future, result);
+	releaseFuture(future); // Note: reference of the future task or the antecedent future.
 }
 
 //**********************************************************************************************************************
-void addThreadPoolTasks(ThreadPool threadPool,
-	ThreadPoolTask* tasks, size_t taskCount)
+Future createFuture(ThreadPool threadPool)
 {
 	assert(threadPool);
-	assert(tasks);
-	assert(taskCount > 0);
-
-	#ifndef NDEBUG
-	for (size_t i = 0; i < taskCount; i++)
-		assert(tasks[i].function);
-	#endif
+	return allocateFuture(threadPool, 1);
+}
+void destroyFuture(Future future)
+{
+	if (!future)
+		return;
+	releaseFuture(future);
+}
 
-	Mutex mutex = threadPool->mutex;
-	Cond workingCond = threadPool->workingCond;
-	ThreadPoolTask* taskArray = threadPool->tasks;
-	size_t taskCapacity = threadPool->taskCapacity;
+ThreadPool getFutureThreadPool(Future future)
+{
+	assert(future);
+	return future->threadPool;
+}
+bool isFutureReady(Future future)
+{
+	assert(future);
+	return atomicLoadPtr(&future->continuations) == COMPLETED_FUTURE;
+}
+void* getFutureResult(Future future)
+{
+	assert(future);
+	assert(isFutureReady(future));
+	return future->result;
+}
 
-	lockMutex(mutex);
-	for (size_t i = 0; i < taskCount; i++)
-	{
-		while (threadPool->taskCount == taskCapacity)
-			waitCond(workingCond, mutex);
+void setFutureResult(Future future, void* result)
+{
+	assert(future);
+	assert(!future->function);
+	completeFuture(future, result);
+}
+void* waitFuture(Future future)
+{
+	assert(future);
 
-		size_t taskArrayCount = threadPool->taskCount;
+	ThreadPool threadPool = future->threadPool;
+	Mutex mutex = &threadPool->mutex;
+	Cond doneCond = &threadPool->doneCond;
 
-		while(taskArrayCount < taskCapacity && i < taskCount)
-			taskArray[taskArrayCount++] = tasks[i++];
+	while (!isFutureReady(future))
+	{
+		// Note: helping to execute pool tasks instead of sleeping, one of them can complete the future.
+		if (tryRunThreadPoolTask(threadPool))
+			continue;
 
-		threadPool->taskCount = taskArrayCount;
-		broadcastCond(threadPool->workCond);
+		lockMutex(mutex);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, 1);
+		if (!isFutureReady(future))
+			waitCond(doneCond, mutex);
+		atomicFetchAdd64(&threadPool->doneWaitingCount, -1);
+		unlockMutex(mutex);
 	}
-	unlockMutex(mutex);
+	return future->result;
 }
-void addThreadPoolTaskNumber(ThreadPool threadPool,
-	ThreadPoolTask task, size_t taskCount)
+
+//**********************************************************************************************************************
+Future addThreadPoolFutureTask(ThreadPool threadPool, FutureFunction function, void* argument)
 {
 	assert(threadPool);
-	assert(task.function);
-	assert(taskCount > 0);
+	assert(function);
 
-	Mutex mutex = threadPool->mutex;
-	Cond workingCond = threadPool->workingCond;
-	ThreadPoolTask* taskArray = threadPool->tasks;
-	size_t taskCapacity = threadPool->taskCapacity;
+	Future future = allocateFuture(threadPool, 2);
+	if (!future)
+		return NULL;
 
-	lockMutex(mutex);
-	for (size_t i = 0; i < taskCount; i++)
-	{
-		while (threadPool->taskCount == taskCapacity)
-			waitCond(workingCond, mutex);
+	future->function = function;
+	future->argument = argument;
 
-		size_t taskArrayCount = threadPool->taskCount;
+	ThreadPoolTask task = { onFutureTask, future };
+	addThreadPoolTask(threadPool, task);
+	return future;
+}
+Future addFutureContinuation(Future future, FutureFunction function, void* argument)
+{
+	assert(future);
+	assert(function);
+
+	Future continuation = allocateFuture(future->threadPool, 2);
+	if (!continuation)
+		return NULL;
 
-		while (taskArrayCount < taskCapacity && i < taskCount)
+	continuation->function = function;
+	continuation->argument = argument;
+
+	void* head = atomicLoadPtr(&future->continuations);
+	while (true)
+	{
+		if (head == COMPLETED_FUTURE)
 		{
-			taskArray[taskArrayCount++] = task;
-			i++;
+			scheduleContinuation(continuation, future->result);
+			break;
 		}
 
-		threadPool->taskCount = taskArrayCount;
-		broadcastCond(threadPool->workCond);
+		continuation->nextContinuation = (Future)head;
+		if (atomicCompareExchangePtr(&future->continuations, &head, continuation))
+			break;
 	}
-	unlockMutex(mutex);
+	return continuation;
 }
-
-void waitThreadPool(ThreadPool threadPool)
-{
-	assert(threadPool);
-
-	Mutex mutex = threadPool->mutex;
-	Cond workingCond = threadPool->workingCond;
-
-	lockMutex(mutex);
-	while (threadPool->taskCount || threadPool->workingCount)
-		waitCond(workingCond, mutex);
-	unlockMutex(mutex);
-}
\ No newline at end of file
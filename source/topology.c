@@ -0,0 +1,626 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/topology.h"
+#include "mpmt/thread.h"
+
+#if __linux__
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#elif __APPLE__
+#include <unistd.h>
+#include <sys/sysctl.h>
+#elif _WIN32
+#include <windows.h>
+#else
+#error Unknown operating system
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if __linux__
+#define MAX_CACHE_INDEX_COUNT 16
+
+// Note: parses sysfs index list, for example "0-3,8-11". Returns NULL if it's missing or empty.
+static size_t* readIndexList(const char* path, size_t* count)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return NULL;
+
+	size_t* indices = NULL;
+	size_t indexCount = 0, indexCapacity = 0;
+
+	while (true)
+	{
+		unsigned long long first = 0, last = 0;
+		if (fscanf(file, "%llu", &first) != 1)
+			break;
+
+		last = first;
+		int separator = fgetc(file);
+		if (separator == '-')
+		{
+			if (fscanf(file, "%llu", &last) != 1 || last < first)
+				break;
+			separator = fgetc(file);
+		}
+
+		for (unsigned long long i = first; i <= last; i++)
+		{
+			if (indexCount == indexCapacity)
+			{
+				indexCapacity = indexCapacity ? indexCapacity * 2 : 16;
+				size_t* newIndices = realloc(indices, indexCapacity * sizeof(size_t));
+				if (!newIndices)
+				{
+					fclose(file);
+					free(indices);
+					return NULL;
+				}
+				indices = newIndices;
+			}
+			indices[indexCount++] = (size_t)i;
+		}
+
+		if (separator != ',')
+			break;
+	}
+
+	fclose(file);
+	if (indexCount == 0)
+	{
+		free(indices);
+		return NULL;
+	}
+
+	*count = indexCount;
+	return indices;
+}
+// Note: reads sysfs number with the optional K/M/G suffix. Returns SIZE_MAX on failure.
+static size_t readSizeValue(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return SIZE_MAX;
+
+	long long value = -1; char suffix = '\0';
+	int result = fscanf(file, "%lld%c", &value, &suffix);
+	fclose(file);
+
+	if (result < 1 || value < 0)
+		return SIZE_MAX;
+	if (suffix == 'K')
+		value *= 1024;
+	else if (suffix == 'M')
+		value *= 1024 * 1024;
+	else if (suffix == 'G')
+		value *= 1024 * 1024 * 1024;
+	return (size_t)value;
+}
+static size_t readCpuValue(size_t cpu, const char* name)
+{
+	char path[256];
+	int length = snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/%s", cpu, name);
+	if (length < 0 || length >= (int)sizeof(path))
+		return SIZE_MAX;
+	return readSizeValue(path);
+}
+
+static size_t* getOnlineCpus(size_t* count)
+{
+	size_t* cpus = readIndexList("/sys/devices/system/cpu/online", count);
+	if (cpus)
+		return cpus;
+
+	long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpuCount < 1)
+		cpuCount = 1;
+
+	cpus = malloc((size_t)cpuCount * sizeof(size_t));
+	if (!cpus)
+		return NULL;
+	for (long i = 0; i < cpuCount; i++)
+		cpus[i] = (size_t)i;
+	*count = (size_t)cpuCount;
+	return cpus;
+}
+// Note: counts distinct packages or package cores of the online CPUs, 0 if topology is unknown.
+static size_t countCpuGroups(bool isCore)
+{
+	size_t cpuCount = 0;
+	size_t* cpus = getOnlineCpus(&cpuCount);
+	size_t* groups = malloc(cpuCount * 2 * sizeof(size_t));
+	if (!cpus || !groups)
+	{
+		free(groups);
+		free(cpus);
+		return 0;
+	}
+
+	size_t groupCount = 0;
+	for (size_t i = 0; i < cpuCount; i++)
+	{
+		size_t package = getCpuPackage(cpus[i]);
+		size_t core = isCore ? getCpuCore(cpus[i]) : 0;
+		if (package == SIZE_MAX || core == SIZE_MAX)
+		{
+			groupCount = 0;
+			break;
+		}
+
+		bool isFound = false;
+		for (size_t j = 0; j < groupCount && !isFound; j++)
+			isFound = groups[j * 2] == package && groups[j * 2 + 1] == core;
+		if (isFound)
+			continue;
+
+		groups[groupCount * 2] = package;
+		groups[groupCount * 2 + 1] = core;
+		groupCount++;
+	}
+
+	free(groups);
+	free(cpus);
+	return groupCount;
+}
+static bool findCpuCache(uint8_t level, size_t* size, size_t* lineSize)
+{
+	for (size_t i = 0; i < MAX_CACHE_INDEX_COUNT; i++)
+	{
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%zu/type", i);
+		FILE* file = fopen(path, "r");
+		if (!file)
+			return false;
+
+		char type[32] = { 0 };
+		int result = fscanf(file, "%31s", type);
+		fclose(file);
+
+		if (result != 1 || strcmp(type, "Instruction") == 0)
+			continue;
+		snprintf(path, sizeof(path), "cache/index%zu/level", i);
+		if (readCpuValue(0, path) != level)
+			continue;
+
+		snprintf(path, sizeof(path), "cache/index%zu/size", i);
+		*size = readCpuValue(0, path);
+		snprintf(path, sizeof(path), "cache/index%zu/coherency_line_size", i);
+		*lineSize = readCpuValue(0, path);
+		return *size != SIZE_MAX;
+	}
+	return false;
+}
+
+static size_t* getNumaNodeIds(size_t* count)
+{
+	return readIndexList("/sys/devices/system/node/online", count);
+}
+
+// Note: returns minimal CPU quota of the cgroup and its parents, 0.0 if there is no limit.
+static double readCgroupQuota(const char* root, const char* cgroup, bool isV2)
+{
+	char path[512];
+	size_t length = strlen(cgroup);
+	if (length >= 256)
+		return 0.0;
+
+	char group[256];
+	memcpy(group, cgroup, length + 1);
+	double quota = 0.0;
+
+	while (true)
+	{
+		double groupQuota = 0.0;
+		if (isV2)
+		{
+			snprintf(path, sizeof(path), "%s%s/cpu.max", root, group);
+			FILE* file = fopen(path, "r");
+			if (file)
+			{
+				char max[32] = { 0 }; long long period = 0;
+				if (fscanf(file, "%31s %lld", max, &period) == 2 && strcmp(max, "max") != 0 && period > 0)
+					groupQuota = (double)atoll(max) / (double)period;
+				fclose(file);
+			}
+		}
+		else
+		{
+			snprintf(path, sizeof(path), "%s%s/cpu.cfs_quota_us", root, group);
+			size_t limit = readSizeValue(path);
+			snprintf(path, sizeof(path), "%s%s/cpu.cfs_period_us", root, group);
+			size_t period = readSizeValue(path);
+			if (limit != SIZE_MAX && period != SIZE_MAX && period > 0)
+				groupQuota = (double)limit / (double)period;
+		}
+
+		if (groupQuota > 0.0 && (quota == 0.0 || groupQuota < quota))
+			quota = groupQuota;
+
+		char* separator = strrchr(group, '/');
+		if (!separator || separator == group)
+		{
+			if (group[0] == '\0')
+				return quota;
+			group[0] = '\0'; // Note: checking the mount root last.
+			continue;
+		}
+		*separator = '\0';
+	}
+}
+#elif __APPLE__
+static size_t getSysctlValue(const char* name)
+{
+	int64_t value = 0;
+	size_t size = sizeof(value);
+	if (sysctlbyname(name, &value, &size, NULL, 0) != 0)
+		return 0;
+	if (size == sizeof(int32_t))
+		return (size_t)*(int32_t*)&value;
+	return (size_t)value;
+}
+#elif _WIN32
+static SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* getProcessorInfos(LOGICAL_PROCESSOR_RELATIONSHIP relation, DWORD* size)
+{
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx(relation, NULL, &length);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+		return NULL;
+
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* infos = malloc(length);
+	if (!infos)
+		return NULL;
+
+	if (!GetLogicalProcessorInformationEx(relation, infos, &length))
+	{
+		free(infos);
+		return NULL;
+	}
+
+	*size = length;
+	return infos;
+}
+static SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* getNextProcessorInfo(SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info)
+{
+	return (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((BYTE*)info + info->Size);
+}
+static size_t countProcessorInfos(LOGICAL_PROCESSOR_RELATIONSHIP relation)
+{
+	DWORD size = 0;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* infos = getProcessorInfos(relation, &size);
+	if (!infos)
+		return 0;
+
+	size_t count = 0;
+	BYTE* end = (BYTE*)infos + size;
+	for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = infos; (BYTE*)info < end; info = getNextProcessorInfo(info))
+		count++;
+
+	free(infos);
+	return count;
+}
+// Note: returns ordinal of the package or core, which contains the logical CPU.
+static size_t findProcessorInfo(LOGICAL_PROCESSOR_RELATIONSHIP relation, size_t cpu)
+{
+	DWORD size = 0;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* infos = getProcessorInfos(relation, &size);
+	if (!infos)
+		return SIZE_MAX;
+
+	WORD group = (WORD)(cpu / (sizeof(KAFFINITY) * 8));
+	KAFFINITY mask = (KAFFINITY)1 << (cpu % (sizeof(KAFFINITY) * 8));
+	size_t index = 0, result = SIZE_MAX;
+	BYTE* end = (BYTE*)infos + size;
+
+	for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = infos; 
+		(BYTE*)info < end && result == SIZE_MAX; info = getNextProcessorInfo(info), index++)
+	{
+		for (WORD i = 0; i < info->Processor.GroupCount; i++)
+		{
+			GROUP_AFFINITY* affinity = &info->Processor.GroupMask[i];
+			if (affinity->Group == group && (affinity->Mask & mask))
+				result = index;
+		}
+	}
+
+	free(infos);
+	return result;
+}
+static bool findCpuCache(uint8_t level, size_t* size, size_t* lineSize)
+{
+	DWORD infoSize = 0;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* infos = getProcessorInfos(RelationCache, &infoSize);
+	if (!infos)
+		return false;
+
+	bool result = false;
+	BYTE* end = (BYTE*)infos + infoSize;
+	for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = infos; (BYTE*)info < end; info = getNextProcessorInfo(info))
+	{
+		CACHE_RELATIONSHIP* cache = &info->Cache;
+		if (cache->Level != level || (cache->Type != CacheData && cache->Type != CacheUnified))
+			continue;
+
+		*size = cache->CacheSize;
+		*lineSize = cache->LineSize;
+		result = true;
+		break;
+	}
+
+	free(infos);
+	return result;
+}
+#endif
+
+//**********************************************************************************************************************
+size_t getLogicalCpuCount()
+{
+	#if __linux__ || __APPLE__
+	long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+	return cpuCount > 0 ? (size_t)cpuCount : 1;
+	#elif _WIN32
+	DWORD cpuCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+	return cpuCount > 0 ? (size_t)cpuCount : 1;
+	#endif
+}
+size_t getPhysicalCoreCount()
+{
+	#if __linux__
+	size_t coreCount = countCpuGroups(true);
+	#elif __APPLE__
+	size_t coreCount = getSysctlValue("hw.physicalcpu");
+	#elif _WIN32
+	size_t coreCount = countProcessorInfos(RelationProcessorCore);
+	#endif
+	return coreCount > 0 ? coreCount : getLogicalCpuCount();
+}
+size_t getCpuPackageCount()
+{
+	#if __linux__
+	size_t packageCount = countCpuGroups(false);
+	#elif __APPLE__
+	size_t packageCount = getSysctlValue("hw.packages");
+	#elif _WIN32
+	size_t packageCount = countProcessorInfos(RelationProcessorPackage);
+	#endif
+	return packageCount > 0 ? packageCount : 1;
+}
+size_t getSmtSiblingCount()
+{
+	#if __linux__
+	size_t cpuCount = 0, siblingCount = 0;
+	size_t* cpus = getOnlineCpus(&cpuCount);
+	if (cpus)
+	{
+		// Note: hybrid CPUs can have cores with and without SMT.
+		for (size_t i = 0; i < cpuCount; i++)
+		{
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/topology/thread_siblings_list", cpus[i]);
+			size_t count = 0;
+			size_t* siblings = readIndexList(path, &count);
+			if (!siblings)
+				continue;
+			if (count > siblingCount)
+				siblingCount = count;
+			free(siblings);
+		}
+		free(cpus);
+	}
+	if (siblingCount > 0)
+		return siblingCount;
+	#endif
+
+	size_t coreCount = getPhysicalCoreCount();
+	return (getLogicalCpuCount() + coreCount - 1) / coreCount;
+}
+
+size_t getCpuPackage(size_t cpu)
+{
+	#if __linux__
+	return readCpuValue(cpu, "topology/physical_package_id");
+	#elif __APPLE__
+	return SIZE_MAX;
+	#elif _WIN32
+	return findProcessorInfo(RelationProcessorPackage, cpu);
+	#endif
+}
+size_t getCpuCore(size_t cpu)
+{
+	#if __linux__
+	return readCpuValue(cpu, "topology/core_id");
+	#elif __APPLE__
+	return SIZE_MAX;
+	#elif _WIN32
+	return findProcessorInfo(RelationProcessorCore, cpu);
+	#endif
+}
+
+//**********************************************************************************************************************
+size_t getCpuCacheSize(uint8_t level)
+{
+	assert(level > 0);
+
+	#if __linux__ || _WIN32
+	size_t size = 0, lineSize = 0;
+	return findCpuCache(level, &size, &lineSize) ? size : 0;
+	#elif __APPLE__
+	if (level == 1)
+		return getSysctlValue("hw.l1dcachesize");
+	if (level == 2)
+		return getSysctlValue("hw.l2cachesize");
+	if (level == 3)
+		return getSysctlValue("hw.l3cachesize");
+	return 0;
+	#endif
+}
+size_t getCpuCacheLineSize(uint8_t level)
+{
+	assert(level > 0);
+
+	#if __linux__ || _WIN32
+	size_t size = 0, lineSize = 0;
+	if (!findCpuCache(level, &size, &lineSize))
+		return 0;
+	return lineSize != SIZE_MAX ? lineSize : 64;
+	#elif __APPLE__
+	return getCpuCacheSize(level) > 0 ? getSysctlValue("hw.cachelinesize") : 0;
+	#endif
+}
+
+//**********************************************************************************************************************
+size_t getNumaNodeCount()
+{
+	#if __linux__
+	size_t nodeCount = 0;
+	size_t* nodeIds = getNumaNodeIds(&nodeCount);
+	free(nodeIds);
+	return nodeCount > 0 ? nodeCount : 1;
+	#elif __APPLE__
+	return 1;
+	#elif _WIN32
+	ULONG highestNode = 0;
+	if (!GetNumaHighestNodeNumber(&highestNode))
+		return 1;
+	return (size_t)highestNode + 1;
+	#endif
+}
+size_t getNumaNodeCpus(size_t node, size_t* cpus, size_t capacity)
+{
+	assert(cpus || capacity == 0);
+
+	#if __linux__
+	size_t nodeCount = 0, cpuCount = 0;
+	size_t* nodeIds = getNumaNodeIds(&nodeCount);
+	size_t* nodeCpus = NULL;
+
+	if (nodeIds)
+	{
+		if (node < nodeCount)
+		{
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", nodeIds[node]);
+			nodeCpus = readIndexList(path, &cpuCount);
+		}
+		free(nodeIds);
+	}
+	else if (node == 0)
+	{
+		nodeCpus = getOnlineCpus(&cpuCount); // Note: no NUMA, all CPUs belong to the single node.
+	}
+
+	if (!nodeCpus)
+		return 0;
+
+	for (size_t i = 0; i < cpuCount && i < capacity; i++)
+		cpus[i] = nodeCpus[i];
+	free(nodeCpus);
+	return cpuCount;
+	#elif __APPLE__
+	if (node != 0)
+		return 0;
+
+	size_t cpuCount = getLogicalCpuCount();
+	for (size_t i = 0; i < cpuCount && i < capacity; i++)
+		cpus[i] = i;
+	return cpuCount;
+	#elif _WIN32
+	GROUP_AFFINITY affinity;
+	if (node > 0xFFFF || !GetNumaNodeProcessorMaskEx((USHORT)node, &affinity))
+		return 0;
+
+	size_t count = 0, groupOffset = (size_t)affinity.Group * sizeof(KAFFINITY) * 8;
+	for (size_t i = 0; i < sizeof(KAFFINITY) * 8; i++)
+	{
+		if (!(affinity.Mask & ((KAFFINITY)1 << i)))
+			continue;
+		if (count < capacity)
+			cpus[count] = groupOffset + i;
+		count++;
+	}
+	return count;
+	#endif
+}
+
+//**********************************************************************************************************************
+double getCpuQuota()
+{
+	#if __linux__
+	FILE* file = fopen("/proc/self/cgroup", "r");
+	if (!file)
+		return 0.0;
+
+	double quota = 0.0;
+	char line[512];
+
+	while (fgets(line, sizeof(line), file))
+	{
+		line[strcspn(line, "\n")] = '\0';
+		char* controllers = strchr(line, ':');
+		char* cgroup = controllers ? strchr(controllers + 1, ':') : NULL;
+		if (!cgroup)
+			continue;
+		*cgroup++ = '\0';
+		controllers++;
+
+		double groupQuota = 0.0;
+		if (strcmp(line, "0") == 0 && controllers[0] == '\0')
+		{
+			groupQuota = readCgroupQuota("/sys/fs/cgroup", cgroup, true);
+		}
+		else
+		{
+			// Note: v1 CPU controller can be mounted separately or together with the cpuacct.
+			char* controller = strtok(controllers, ",");
+			while (controller && strcmp(controller, "cpu") != 0)
+				controller = strtok(NULL, ",");
+			if (!controller)
+				continue;
+
+			groupQuota = readCgroupQuota("/sys/fs/cgroup/cpu", cgroup, false);
+			if (groupQuota == 0.0)
+				groupQuota = readCgroupQuota("/sys/fs/cgroup/cpu,cpuacct", cgroup, false);
+		}
+
+		if (groupQuota > 0.0 && (quota == 0.0 || groupQuota < quota))
+			quota = groupQuota;
+	}
+
+	fclose(file);
+	return quota;
+	#else
+	return 0.0;
+	#endif
+}
+size_t getAvailableCpuCount()
+{
+	size_t cpuCount = getCurrentThreadAffinity(NULL, 0);
+	if (cpuCount == 0)
+		cpuCount = getLogicalCpuCount();
+
+	double quota = getCpuQuota();
+	if (quota > 0.0)
+	{
+		size_t quotaCount = (size_t)quota;
+		if ((double)quotaCount < quota)
+			quotaCount++;
+		if (quotaCount < cpuCount)
+			cpuCount = quotaCount;
+	}
+	return cpuCount > 0 ? cpuCount : 1;
+}
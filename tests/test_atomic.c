@@ -13,9 +13,117 @@
 // limitations under the License.
 
 #include "mpmt/atomic.h"
+#include "mpmt/thread.h"
+
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 
+#ifdef MPMT_ATOMIC_TAGGED_PTR
+#define TEST_THREAD_COUNT 4
+#define TEST_NODE_COUNT 64
+#define TEST_ITERATION_COUNT 100000
+
+typedef struct StackNode
+{
+	atomic_ptr next;
+	atomic_size useCount;
+} StackNode;
+
+// Note: nodes are popped and pushed back all the time, so that the same pointer reappears on top (ABA).
+static void onTaggedStackTest(void* argument)
+{
+	atomic_tagged_ptr* top = (atomic_tagged_ptr*)argument;
+
+	for (size_t i = 0; i < TEST_ITERATION_COUNT; i++)
+	{
+		TaggedPtr expected = atomicLoadTaggedPtr(top);
+		StackNode* node;
+		do
+		{
+			node = (StackNode*)expected.ptr;
+			if (!node)
+				break;
+		}
+		while (!atomicCompareExchangeTaggedPtr(top, &expected, atomicLoadExplicitPtr(&node->next, ATOMIC_RELAXED)));
+
+		if (!node)
+			continue;
+
+		if (atomicFetchAddSize(&node->useCount, 1) != 0)
+			abort(); // Note: the same node is popped twice.
+		atomicFetchAddSize(&node->useCount, (size_t)-1);
+
+		expected = atomicLoadTaggedPtr(top);
+		do atomicStoreExplicitPtr(&node->next, expected.ptr, ATOMIC_RELAXED);
+		while (!atomicCompareExchangeTaggedPtr(top, &expected, node));
+	}
+}
+
+inline static bool testTaggedPtr()
+{
+	StackNode* nodes = calloc(TEST_NODE_COUNT, sizeof(StackNode));
+	atomic_tagged_ptr* top = calloc(1, sizeof(atomic_tagged_ptr));
+
+	if (!nodes || !top)
+	{
+		printf("testTaggedPtr: failed to allocate nodes.");
+		free(nodes); free((void*)top);
+		return false;
+	}
+
+	TaggedPtr expected = atomicLoadTaggedPtr(top);
+	for (size_t i = 0; i < TEST_NODE_COUNT; i++)
+	{
+		nodes[i].next = expected.ptr;
+		if (!atomicCompareExchangeTaggedPtr(top, &expected, &nodes[i]))
+		{
+			printf("testTaggedPtr: failed to push node.");
+			abort();
+		}
+		expected.ptr = &nodes[i];
+		expected.tag++;
+	}
+
+	Thread threads[TEST_THREAD_COUNT];
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		threads[i] = createThread(onTaggedStackTest, (void*)top);
+
+		if (!threads[i])
+		{
+			printf("testTaggedPtr: failed to create thread.");
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	size_t nodeCount = 0;
+	StackNode* node = (StackNode*)atomicLoadTaggedPtr(top).ptr;
+
+	while (node && nodeCount <= TEST_NODE_COUNT)
+	{
+		nodeCount++;
+		node = (StackNode*)node->next;
+	}
+
+	free((void*)top); free(nodes);
+
+	if (nodeCount != TEST_NODE_COUNT)
+	{
+		printf("testTaggedPtr: incorrect node count. (count: %zu)", nodeCount);
+		return false;
+	}
+
+	return true;
+}
+#endif
+
 int main()
 {
 	atomic_int32* value32 = calloc(1, sizeof(atomic_int32));
@@ -30,5 +138,62 @@ int main()
 	result &= atomicLoad32(value32) == 111 && atomicLoad64(value64) == 2222;
 	atomicFetchAnd32(value32, 1); atomicFetchAnd64(value64, 0);
 	result &= atomicLoad32(value32) == 1 && atomicLoad64(value64) == 0;
+
+	atomic_int8 value8 = 1; atomic_int16 value16 = 2;
+	int8_t expected8 = 0; int16_t expected16 = 2;
+	result &= !atomicCompareExchange8(&value8, &expected8, 5) && expected8 == 1;
+	result &= atomicCompareExchange16(&value16, &expected16, 6) && atomicLoad16(&value16) == 6;
+
+	int32_t expected32 = 1; int64_t expected64 = 1;
+	result &= atomicCompareExchange32(value32, &expected32, 7) && atomicLoad32(value32) == 7;
+	result &= !atomicCompareExchange64(value64, &expected64, 8) && expected64 == 0;
+	while (!atomicCompareExchangeWeak64(value64, &expected64, expected64 + 9)) { }
+	result &= atomicLoad64(value64) == 9;
+
+	atomicStoreExplicit32(value32, 10, ATOMIC_RELEASE);
+	result &= atomicLoadExplicit32(value32, ATOMIC_ACQUIRE) == 10;
+	result &= atomicFetchAddExplicit32(value32, 1, ATOMIC_RELAXED) == 10;
+	result &= atomicExchangeExplicit64(value64, 11, ATOMIC_ACQ_REL) == 9;
+	atomicFetchOrExplicit64(value64, 4, ATOMIC_RELAXED); atomicFetchXorExplicit64(value64, 1, ATOMIC_RELAXED);
+	result &= atomicLoadExplicit64(value64, ATOMIC_RELAXED) == 14;
+	expected32 = 11;
+	result &= atomicCompareExchangeExplicit32(value32, &expected32, 12, ATOMIC_RELEASE);
+	while (!atomicCompareExchangeWeakExplicit32(value32, &expected32, 13, ATOMIC_ACQUIRE)) { }
+	atomicThreadFence(ATOMIC_SEQ_CST); atomicSignalFence(ATOMIC_SEQ_CST);
+	result &= atomicLoad32(value32) == 13;
+
+	#ifdef MPMT_ATOMIC_INT128
+	atomic_int128* value128 = calloc(1, sizeof(atomic_int128));
+	Int128 expected128 = { 1, 2 }, desired128 = { 3, -4 };
+	result &= !atomicCompareExchange128(value128, &expected128, desired128);
+	result &= expected128.low == 0 && expected128.high == 0;
+	result &= atomicCompareExchange128(value128, &expected128, desired128);
+	result &= value128->low == 3 && value128->high == -4;
+	free((void*)value128);
+	#endif
+
+	int values[2] = { 0, 0 };
+	atomic_ptr pointer = NULL;
+	void* expectedPtr = &values[1];
+	atomicStorePtr(&pointer, &values[0]);
+	result &= atomicLoadPtr(&pointer) == &values[0];
+	result &= !atomicCompareExchangePtr(&pointer, &expectedPtr, NULL) && expectedPtr == &values[0];
+	result &= atomicCompareExchangePtr(&pointer, &expectedPtr, &values[1]);
+	result &= atomicExchangePtr(&pointer, NULL) == &values[1];
+	result &= atomicLoadExplicitPtr(&pointer, ATOMIC_ACQUIRE) == NULL;
+
+	atomic_size size = 0;
+	size_t expectedSize = 2;
+	atomicStoreSize(&size, 1);
+	result &= atomicFetchAddSize(&size, 1) == 1 && atomicLoadSize(&size) == 2;
+	result &= atomicCompareExchangeSize(&size, &expectedSize, SIZE_MAX) && atomicExchangeSize(&size, 0) == SIZE_MAX;
+	result &= atomicFetchAddExplicitSize(&size, 3, ATOMIC_RELAXED) == 0;
+	result &= atomicLoadExplicitSize(&size, ATOMIC_RELAXED) == 3;
+
+	#ifdef MPMT_ATOMIC_TAGGED_PTR
+	result &= testTaggedPtr();
+	#endif
+
+	free((void*)value32); free((void*)value64);
 	return result ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/object_pool.h"
+#include "mpmt/atomic.h"
+#include "mpmt/queue.h"
+#include "mpmt/thread.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_OBJECT_COUNT 1000
+#define TEST_BLOCK_CAPACITY 100
+
+typedef struct TestObject
+{
+	size_t id;
+	size_t value;
+} TestObject;
+
+inline static bool testAllocate()
+{
+	ObjectPool objectPool = createObjectPool(sizeof(TestObject), TEST_BLOCK_CAPACITY);
+
+	if (!objectPool)
+	{
+		printf("testAllocate: failed to create object pool.");
+		return false;
+	}
+
+	TestObject** objects = calloc(TEST_OBJECT_COUNT, sizeof(TestObject*));
+	if (!objects)
+		abort();
+
+	bool result = true;
+	for (size_t i = 0; i < TEST_OBJECT_COUNT; i++)
+	{
+		objects[i] = allocateObjectPoolObject(objectPool);
+		if (!objects[i] || (size_t)objects[i] % OBJECT_POOL_ALIGNMENT != 0)
+		{
+			printf("testAllocate: failed to allocate object.");
+			abort();
+		}
+		objects[i]->id = i;
+	}
+
+	for (size_t i = 0; i < TEST_OBJECT_COUNT; i++)
+	{
+		if (objects[i]->id != i)
+		{
+			printf("testAllocate: object is allocated twice. (index: %zu)", i);
+			result = false;
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < TEST_OBJECT_COUNT; i++)
+		freeObjectPoolObject(objectPool, objects[i]);
+
+	size_t capacity = getObjectPoolCapacity(objectPool);
+	for (size_t i = 0; i < TEST_OBJECT_COUNT; i++)
+		objects[i] = allocateObjectPoolObject(objectPool);
+	for (size_t i = 0; i < TEST_OBJECT_COUNT; i++)
+		freeObjectPoolObject(objectPool, objects[i]);
+
+	if (result && getObjectPoolCapacity(objectPool) != capacity)
+	{
+		printf("testAllocate: freed objects are not reused. (capacity: %zu)", getObjectPoolCapacity(objectPool));
+		result = false;
+	}
+
+	free(objects);
+	destroyObjectPool(objectPool);
+	return result;
+}
+
+//**********************************************************************************************************************
+#define TEST_THREAD_COUNT 2
+#define TEST_MESSAGE_COUNT 100000
+
+typedef struct MessageData
+{
+	ObjectPool objectPool;
+	LockFreeQueue queue;
+	atomic_size nextId;
+	atomic_size receivedCount;
+	atomic_int32 errorCount;
+} MessageData;
+
+// Note: objects are allocated on the producer and freed on the consumer, like the task arguments.
+static void onProducerTest(void* argument)
+{
+	MessageData* data = (MessageData*)argument;
+
+	for (size_t i = 0; i < TEST_MESSAGE_COUNT; i++)
+	{
+		TestObject* object = allocateObjectPoolObject(data->objectPool);
+		if (!object)
+			abort();
+
+		object->id = atomicFetchAddSize(&data->nextId, 1);
+		object->value = object->id * 3;
+
+		while (!tryPushLockFreeQueue(data->queue, &object))
+			yieldThread();
+	}
+}
+static void onConsumerTest(void* argument)
+{
+	MessageData* data = (MessageData*)argument;
+
+	while (atomicLoadSize(&data->receivedCount) < TEST_THREAD_COUNT * TEST_MESSAGE_COUNT)
+	{
+		TestObject* object;
+		if (!tryPopLockFreeQueue(data->queue, &object))
+		{
+			yieldThread();
+			continue;
+		}
+
+		if (object->value != object->id * 3)
+			atomicFetchAdd32(&data->errorCount, 1);
+		freeObjectPoolObject(data->objectPool, object);
+		atomicFetchAddSize(&data->receivedCount, 1);
+	}
+}
+
+inline static bool testProducerConsumer()
+{
+	MessageData data;
+	data.objectPool = createObjectPool(sizeof(TestObject), TEST_BLOCK_CAPACITY);
+	data.queue = createLockFreeQueue(256, sizeof(TestObject*));
+	data.nextId = 0;
+	data.receivedCount = 0;
+	data.errorCount = 0;
+
+	if (!data.objectPool || !data.queue)
+	{
+		printf("testProducerConsumer: failed to create object pool or queue.");
+		destroyLockFreeQueue(data.queue);
+		destroyObjectPool(data.objectPool);
+		return false;
+	}
+
+	Thread threads[TEST_THREAD_COUNT * 2];
+	for (size_t i = 0; i < TEST_THREAD_COUNT * 2; i++)
+	{
+		threads[i] = createThread(i % 2 == 0 ? onProducerTest : onConsumerTest, &data);
+
+		if (!threads[i])
+		{
+			printf("testProducerConsumer: failed to create thread.");
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT * 2; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	size_t capacity = getObjectPoolCapacity(data.objectPool);
+	destroyLockFreeQueue(data.queue);
+	destroyObjectPool(data.objectPool);
+
+	if (data.errorCount != 0)
+	{
+		printf("testProducerConsumer: object is allocated twice. (errors: %d)", (int)data.errorCount);
+		return false;
+	}
+	if (capacity > TEST_THREAD_COUNT * TEST_MESSAGE_COUNT / 10)
+	{
+		printf("testProducerConsumer: freed objects are not reused. (capacity: %zu)", capacity);
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	bool result = testAllocate();
+	result &= testProducerConsumer();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,175 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/queue.h"
+#include "mpmt/atomic.h"
+#include "mpmt/thread.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TEST_THREAD_COUNT 4
+#define TEST_ITEM_COUNT 100000
+
+inline static bool testPushPop()
+{
+	LockFreeQueue queue = createLockFreeQueue(3, sizeof(uint32_t));
+
+	if (!queue)
+	{
+		printf("testPushPop: failed to create lock-free queue.");
+		return false;
+	}
+
+	if (getLockFreeQueueCapacity(queue) != 4)
+	{
+		printf("testPushPop: incorrect queue capacity.");
+		destroyLockFreeQueue(queue);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		if (!tryPushLockFreeQueue(queue, &i))
+		{
+			printf("testPushPop: failed to push item. (index: %u)", i);
+			destroyLockFreeQueue(queue);
+			return false;
+		}
+	}
+
+	uint32_t item = 0;
+	if (tryPushLockFreeQueue(queue, &item))
+	{
+		printf("testPushPop: pushed item to already full queue.");
+		destroyLockFreeQueue(queue);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		if (!tryPopLockFreeQueue(queue, &item) || item != i)
+		{
+			printf("testPushPop: failed to pop item. (index: %u)", i);
+			destroyLockFreeQueue(queue);
+			return false;
+		}
+	}
+
+	bool result = tryPopLockFreeQueue(queue, &item);
+	destroyLockFreeQueue(queue);
+
+	if (result)
+	{
+		printf("testPushPop: popped item from empty queue.");
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+typedef struct ConcurrentData
+{
+	LockFreeQueue queue;
+	atomic_int64 popCount;
+	atomic_int64 popSum;
+} ConcurrentData;
+
+static void onProducerTest(void* argument)
+{
+	ConcurrentData* data = (ConcurrentData*)argument;
+
+	for (uint64_t i = 1; i <= TEST_ITEM_COUNT; i++)
+	{
+		while (!tryPushLockFreeQueue(data->queue, &i))
+			yieldThread();
+	}
+}
+static void onConsumerTest(void* argument)
+{
+	ConcurrentData* data = (ConcurrentData*)argument;
+
+	while (atomicLoad64(&data->popCount) < TEST_ITEM_COUNT * TEST_THREAD_COUNT)
+	{
+		uint64_t item;
+		if (!tryPopLockFreeQueue(data->queue, &item))
+		{
+			yieldThread();
+			continue;
+		}
+
+		atomicFetchAdd64(&data->popSum, (int64_t)item);
+		atomicFetchAdd64(&data->popCount, 1);
+	}
+}
+
+inline static bool testConcurrent()
+{
+	ConcurrentData* data = calloc(1, sizeof(ConcurrentData));
+
+	if (!data)
+	{
+		printf("testConcurrent: failed to allocate data.");
+		return false;
+	}
+
+	data->queue = createLockFreeQueue(64, sizeof(uint64_t));
+
+	if (!data->queue)
+	{
+		printf("testConcurrent: failed to create lock-free queue.");
+		free(data);
+		return false;
+	}
+
+	Thread threads[TEST_THREAD_COUNT * 2];
+	for (size_t i = 0; i < TEST_THREAD_COUNT * 2; i++)
+	{
+		threads[i] = createThread(i % 2 == 0 ? onProducerTest : onConsumerTest, data);
+
+		if (!threads[i])
+		{
+			printf("testConcurrent: failed to create thread.");
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT * 2; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	int64_t popSum = atomicLoad64(&data->popSum);
+	destroyLockFreeQueue(data->queue);
+	free(data);
+
+	int64_t expectedSum = (int64_t)TEST_ITEM_COUNT * (TEST_ITEM_COUNT + 1) / 2 * TEST_THREAD_COUNT;
+	if (popSum != expectedSum)
+	{
+		printf("testConcurrent: incorrect popped item sum. (sum: %lld)", (long long)popSum);
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	bool result = testPushPop();
+	result &= testConcurrent();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
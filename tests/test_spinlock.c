@@ -0,0 +1,130 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/spinlock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_THREAD_COUNT 4
+#define TEST_LOCK_COUNT 100000
+
+typedef struct SpinlockData
+{
+	Spinlock spinlock;
+	TicketLock ticketLock;
+	size_t counter;
+} SpinlockData;
+
+static void onSpinlockTest(void* argument)
+{
+	SpinlockData* data = (SpinlockData*)argument;
+
+	for (size_t i = 0; i < TEST_LOCK_COUNT; i++)
+	{
+		lockSpinlock(&data->spinlock);
+		data->counter++;
+		unlockSpinlock(&data->spinlock);
+	}
+}
+static void onTicketLockTest(void* argument)
+{
+	SpinlockData* data = (SpinlockData*)argument;
+
+	for (size_t i = 0; i < TEST_LOCK_COUNT; i++)
+	{
+		lockTicketLock(&data->ticketLock);
+		data->counter++;
+		unlockTicketLock(&data->ticketLock);
+	}
+}
+
+static bool runContention(const char* testName, void (*onTest)(void*), SpinlockData* data)
+{
+	Thread threads[TEST_THREAD_COUNT];
+	data->counter = 0;
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		threads[i] = createThread(onTest, data);
+
+		if (!threads[i])
+		{
+			printf("%s: failed to create thread.", testName);
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	if (data->counter != TEST_THREAD_COUNT * TEST_LOCK_COUNT)
+	{
+		printf("%s: incorrect counter value. (value: %zu)", testName, data->counter);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+inline static bool testSpinlock()
+{
+	SpinlockData data;
+	initSpinlock(&data.spinlock);
+
+	if (!tryLockSpinlock(&data.spinlock))
+	{
+		printf("testSpinlock: failed to lock free spinlock.");
+		return false;
+	}
+	if (tryLockSpinlock(&data.spinlock))
+	{
+		printf("testSpinlock: locked already locked spinlock.");
+		return false;
+	}
+
+	unlockSpinlock(&data.spinlock);
+	return runContention("testSpinlock", onSpinlockTest, &data);
+}
+
+inline static bool testTicketLock()
+{
+	SpinlockData data;
+	initTicketLock(&data.ticketLock);
+
+	if (!tryLockTicketLock(&data.ticketLock))
+	{
+		printf("testTicketLock: failed to lock free ticket lock.");
+		return false;
+	}
+	if (tryLockTicketLock(&data.ticketLock))
+	{
+		printf("testTicketLock: locked already locked ticket lock.");
+		return false;
+	}
+
+	unlockTicketLock(&data.ticketLock);
+	return runContention("testTicketLock", onTicketLockTest, &data);
+}
+
+int main()
+{
+	bool result = testSpinlock();
+	result &= testTicketLock();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
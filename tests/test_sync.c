@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "mpmt/atomic.h"
 #include "mpmt/sync.h"
 #include "mpmt/thread.h"
 
@@ -136,9 +137,419 @@ inline static bool testTryLock()
 	return true;
 }
 
+//**********************************************************************************************************************
+#define TEST_MUTEX_COUNT 16
+
+inline static bool testEmbedded()
+{
+	Mutex_T mutexes[TEST_MUTEX_COUNT];
+	Cond_T cond;
+
+	for (size_t i = 0; i < TEST_MUTEX_COUNT; i++)
+	{
+		if (!initMutex(&mutexes[i]))
+		{
+			printf("testEmbedded: failed to init mutex.");
+			return false;
+		}
+	}
+
+	if (!initCond(&cond))
+	{
+		printf("testEmbedded: failed to init cond.");
+		return false;
+	}
+
+	for (size_t i = 0; i < TEST_MUTEX_COUNT; i++)
+		lockMutex(&mutexes[i]);
+
+	signalCond(&cond);
+	deinitCond(&cond);
+
+	for (size_t i = 0; i < TEST_MUTEX_COUNT; i++)
+	{
+		unlockMutex(&mutexes[i]);
+		deinitMutex(&mutexes[i]);
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_THREAD_COUNT 4
+#define TEST_LOCK_COUNT 100000
+
+typedef struct ContentionData
+{
+	Mutex mutex;
+	size_t counter;
+} ContentionData;
+
+static void onContentionTest(void* argument)
+{
+	ContentionData* data = (ContentionData*)argument;
+
+	for (size_t i = 0; i < TEST_LOCK_COUNT; i++)
+	{
+		lockMutex(data->mutex);
+		data->counter++;
+		unlockMutex(data->mutex);
+	}
+}
+
+inline static bool testContention()
+{
+	ContentionData data;
+	data.mutex = createMutex();
+	data.counter = 0;
+
+	if (!data.mutex)
+	{
+		printf("testContention: failed to create mutex.");
+		return false;
+	}
+
+	Thread threads[TEST_THREAD_COUNT];
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		threads[i] = createThread(onContentionTest, &data);
+
+		if (!threads[i])
+		{
+			printf("testContention: failed to create thread.");
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	destroyMutex(data.mutex);
+
+	if (data.counter != TEST_THREAD_COUNT * TEST_LOCK_COUNT)
+	{
+		printf("testContention: incorrect counter value. (value: %zu)", data.counter);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_SIGNAL_COUNT 10000
+
+typedef struct CondData
+{
+	Mutex mutex;
+	Cond cond;
+	size_t value;
+} CondData;
+
+// Note: threads are taking turns, each one waits for the value parity.
+static void onCondTest(void* argument)
+{
+	CondData* data = (CondData*)argument;
+	lockMutex(data->mutex);
+
+	for (size_t i = 0; i < TEST_SIGNAL_COUNT; i++)
+	{
+		while (data->value % 2 == 0)
+			waitCond(data->cond, data->mutex);
+		data->value++;
+		signalCond(data->cond);
+	}
+
+	unlockMutex(data->mutex);
+}
+
+inline static bool testCond()
+{
+	CondData data;
+	data.mutex = createMutex();
+	data.cond = createCond();
+	data.value = 0;
+
+	if (!data.mutex || !data.cond)
+	{
+		printf("testCond: failed to create mutex or cond.");
+		destroyCond(data.cond);
+		destroyMutex(data.mutex);
+		return false;
+	}
+
+	Thread thread = createThread(onCondTest, &data);
+
+	if (!thread)
+	{
+		printf("testCond: failed to create thread.");
+		destroyCond(data.cond);
+		destroyMutex(data.mutex);
+		return false;
+	}
+
+	lockMutex(data.mutex);
+	for (size_t i = 0; i < TEST_SIGNAL_COUNT; i++)
+	{
+		while (data.value % 2 == 1)
+			waitCond(data.cond, data.mutex);
+		data.value++;
+		broadcastCond(data.cond);
+	}
+	unlockMutex(data.mutex);
+
+	joinThread(thread);
+	destroyThread(thread);
+	destroyCond(data.cond);
+	destroyMutex(data.mutex);
+
+	if (data.value != TEST_SIGNAL_COUNT * 2)
+	{
+		printf("testCond: incorrect value. (value: %zu)", data.value);
+		return false;
+	}
+
+	return true;
+}
+
+inline static bool testCondTimeout()
+{
+	Mutex mutex = createMutex();
+	Cond cond = createCond();
+
+	if (!mutex || !cond)
+	{
+		printf("testCondTimeout: failed to create mutex or cond.");
+		destroyCond(cond);
+		destroyMutex(mutex);
+		return false;
+	}
+
+	// Note: nobody signals the condition, wait should return after the timeout.
+	lockMutex(mutex);
+	waitCondFor(cond, mutex, 0.01);
+	waitCondFor(cond, mutex, 0.0);
+	unlockMutex(mutex);
+
+	destroyCond(cond);
+	destroyMutex(mutex);
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_RW_LOCK_COUNT 20000
+#define TEST_RW_LOCK_WRITE_RATE 10
+
+typedef struct RwLockData
+{
+	RwLock rwLock;
+	size_t firstValue;
+	size_t secondValue;
+	atomic_int32 errorCount;
+} RwLockData;
+
+static void onRwLockTest(void* argument)
+{
+	RwLockData* data = (RwLockData*)argument;
+
+	for (size_t i = 0; i < TEST_RW_LOCK_COUNT; i++)
+	{
+		if (i % TEST_RW_LOCK_WRITE_RATE == 0)
+		{
+			writeLockRwLock(data->rwLock);
+			data->firstValue++;
+			data->secondValue++;
+			writeUnlockRwLock(data->rwLock);
+		}
+		else
+		{
+			readLockRwLock(data->rwLock);
+			if (data->firstValue != data->secondValue)
+				atomicFetchAdd32(&data->errorCount, 1);
+			readUnlockRwLock(data->rwLock);
+		}
+	}
+}
+
+inline static bool testRwLock()
+{
+	RwLockData data;
+	data.rwLock = createRwLock();
+	data.firstValue = data.secondValue = 0;
+	data.errorCount = 0;
+
+	if (!data.rwLock)
+	{
+		printf("testRwLock: failed to create reader-writer lock.");
+		return false;
+	}
+
+	readLockRwLock(data.rwLock);
+	bool isReadLocked = tryReadLockRwLock(data.rwLock);
+	if (isReadLocked)
+		readUnlockRwLock(data.rwLock);
+	bool isWriteLocked = tryWriteLockRwLock(data.rwLock);
+	readUnlockRwLock(data.rwLock);
+
+	if (!isReadLocked || isWriteLocked)
+	{
+		printf("testRwLock: incorrect try lock result while reading.");
+		destroyRwLock(data.rwLock);
+		return false;
+	}
+
+	writeLockRwLock(data.rwLock);
+	isReadLocked = tryReadLockRwLock(data.rwLock);
+	writeUnlockRwLock(data.rwLock);
+
+	if (isReadLocked)
+	{
+		printf("testRwLock: incorrect try lock result while writing.");
+		destroyRwLock(data.rwLock);
+		return false;
+	}
+
+	Thread threads[TEST_THREAD_COUNT];
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		threads[i] = createThread(onRwLockTest, &data);
+
+		if (!threads[i])
+		{
+			printf("testRwLock: failed to create thread.");
+			abort();
+		}
+	}
+
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		joinThread(threads[i]);
+		destroyThread(threads[i]);
+	}
+
+	destroyRwLock(data.rwLock);
+
+	size_t writeCount = TEST_THREAD_COUNT * (TEST_RW_LOCK_COUNT / TEST_RW_LOCK_WRITE_RATE);
+	if (data.errorCount != 0 || data.firstValue != writeCount)
+	{
+		printf("testRwLock: incorrect values. (errors: %d, value: %zu)", (int)data.errorCount, data.firstValue);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+typedef struct DistRwLockData
+{
+	DistRwLock distRwLock;
+	size_t firstValue;
+	size_t secondValue;
+	atomic_int32 errorCount;
+} DistRwLockData;
+
+static void onDistRwLockTest(void* argument)
+{
+	DistRwLockData* data = (DistRwLockData*)argument;
+
+	for (size_t i = 0; i < TEST_RW_LOCK_COUNT; i++)
+	{
+		if (i % TEST_RW_LOCK_WRITE_RATE == 0)
+		{
+			writeLockDistRwLock(data->distRwLock);
+			data->firstValue++;
+			data->secondValue++;
+			writeUnlockDistRwLock(data->distRwLock);
+		}
+		else
+		{
+			readLockDistRwLock(data->distRwLock);
+			if (data->firstValue != data->secondValue)
+				atomicFetchAdd32(&data->errorCount, 1);
+			readUnlockDistRwLock(data->distRwLock);
+		}
+	}
+}
+
+inline static bool testDistRwLock()
+{
+	// Note: testing with the automatic and with the shared between threads slots.
+	size_t slotCounts[] = { 0, 2 };
+
+	for (size_t i = 0; i < sizeof(slotCounts) / sizeof(size_t); i++)
+	{
+		DistRwLockData data;
+		data.distRwLock = createDistRwLock(slotCounts[i]);
+		data.firstValue = data.secondValue = 0;
+		data.errorCount = 0;
+
+		if (!data.distRwLock)
+		{
+			printf("testDistRwLock: failed to create distributed reader-writer lock.");
+			return false;
+		}
+
+		readLockDistRwLock(data.distRwLock);
+		bool isWriteLocked = tryWriteLockDistRwLock(data.distRwLock);
+		readUnlockDistRwLock(data.distRwLock);
+
+		writeLockDistRwLock(data.distRwLock);
+		bool isReadLocked = tryReadLockDistRwLock(data.distRwLock);
+		writeUnlockDistRwLock(data.distRwLock);
+
+		if (isWriteLocked || isReadLocked)
+		{
+			printf("testDistRwLock: incorrect try lock result.");
+			destroyDistRwLock(data.distRwLock);
+			return false;
+		}
+
+		Thread threads[TEST_THREAD_COUNT];
+
+		for (size_t j = 0; j < TEST_THREAD_COUNT; j++)
+		{
+			threads[j] = createThread(onDistRwLockTest, &data);
+
+			if (!threads[j])
+			{
+				printf("testDistRwLock: failed to create thread.");
+				abort();
+			}
+		}
+
+		for (size_t j = 0; j < TEST_THREAD_COUNT; j++)
+		{
+			joinThread(threads[j]);
+			destroyThread(threads[j]);
+		}
+
+		destroyDistRwLock(data.distRwLock);
+
+		size_t writeCount = TEST_THREAD_COUNT * (TEST_RW_LOCK_COUNT / TEST_RW_LOCK_WRITE_RATE);
+		if (data.errorCount != 0 || data.firstValue != writeCount)
+		{
+			printf("testDistRwLock: incorrect values. (errors: %d, value: %zu)", 
+				(int)data.errorCount, data.firstValue);
+			return false;
+		}
+	}
+
+	return true;
+}
+
 int main()
 {
 	bool result = testLocking();
 	result &= testTryLock();
+	result &= testEmbedded();
+	result &= testContention();
+	result &= testCond();
+	result &= testCondTimeout();
+	result &= testRwLock();
+	result &= testDistRwLock();
 	return result ? EXIT_SUCCESS : EXIT_FAILURE;
 }
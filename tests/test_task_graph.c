@@ -0,0 +1,211 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/task_graph.h"
+#include "mpmt/atomic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_THREAD_COUNT 4
+#define TEST_NODE_COUNT 200
+#define TEST_MAX_PREDECESSOR_COUNT 3
+#define TEST_RUN_COUNT 50
+
+static size_t predecessors[TEST_NODE_COUNT][TEST_MAX_PREDECESSOR_COUNT];
+static size_t predecessorCounts[TEST_NODE_COUNT];
+static atomic_int64 nodeRuns[TEST_NODE_COUNT];
+static atomic_int64 orderErrorCount = 0;
+
+static void onGraphNode(void* argument)
+{
+	size_t node = (size_t)argument;
+	int64_t run = atomicLoad64(&nodeRuns[node]);
+
+	for (size_t i = 0; i < predecessorCounts[node]; i++)
+	{
+		if (atomicLoad64(&nodeRuns[predecessors[node][i]]) != run + 1)
+			atomicFetchAdd64(&orderErrorCount, 1);
+	}
+	atomicStore64(&nodeRuns[node], run + 1);
+}
+
+// Note: random layered graph, edges always point to the nodes with the greater index.
+inline static TaskGraph createTestGraph(ThreadPool threadPool)
+{
+	TaskGraph taskGraph = createTaskGraph(threadPool);
+	if (!taskGraph)
+		return NULL;
+
+	srand(1);
+	for (size_t i = 0; i < TEST_NODE_COUNT; i++)
+	{
+		ThreadPoolTask task = { onGraphNode, (void*)i };
+		size_t node;
+
+		if (!addTaskGraphNode(taskGraph, task, &node) || node != i)
+		{
+			destroyTaskGraph(taskGraph);
+			return NULL;
+		}
+
+		atomicStore64(&nodeRuns[i], 0);
+		predecessorCounts[i] = i < 8 ? 0 : (size_t)rand() % (TEST_MAX_PREDECESSOR_COUNT + 1);
+
+		for (size_t j = 0; j < predecessorCounts[i]; j++)
+		{
+			predecessors[i][j] = (size_t)rand() % i;
+			if (!addTaskGraphEdge(taskGraph, predecessors[i][j], i))
+			{
+				destroyTaskGraph(taskGraph);
+				return NULL;
+			}
+		}
+	}
+	return taskGraph;
+}
+
+inline static bool testGraphOrder()
+{
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT * 16, taskOrder);
+		if (!threadPool)
+		{
+			printf("testGraphOrder: failed to create thread pool.");
+			return false;
+		}
+
+		TaskGraph taskGraph = createTestGraph(threadPool);
+		if (!taskGraph)
+		{
+			printf("testGraphOrder: failed to create task graph.");
+			destroyThreadPool(threadPool);
+			return false;
+		}
+
+		atomicStore64(&orderErrorCount, 0);
+		for (int64_t run = 0; run < TEST_RUN_COUNT; run++)
+		{
+			if (!runTaskGraph(taskGraph))
+			{
+				printf("testGraphOrder: failed to run task graph. (order: %d)", (int)taskOrder);
+				destroyTaskGraph(taskGraph);
+				destroyThreadPool(threadPool);
+				return false;
+			}
+
+			for (size_t i = 0; i < TEST_NODE_COUNT; i++)
+			{
+				if (atomicLoad64(&nodeRuns[i]) != run + 1)
+				{
+					printf("testGraphOrder: node is not completed. (order: %d, node: %zu)", (int)taskOrder, i);
+					destroyTaskGraph(taskGraph);
+					destroyThreadPool(threadPool);
+					return false;
+				}
+			}
+		}
+
+		destroyTaskGraph(taskGraph);
+		destroyThreadPool(threadPool);
+
+		int64_t errorCount = atomicLoad64(&orderErrorCount);
+		if (errorCount != 0)
+		{
+			printf("testGraphOrder: node started before the predecessor. (order: %d, count: %lld)", 
+				(int)taskOrder, (long long)errorCount);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+static atomic_int64 cycleCounter = 0;
+
+static void onCycleNode(void* argument)
+{
+	atomicFetchAdd64(&cycleCounter, 1);
+}
+
+inline static bool testGraphCycle()
+{
+	ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, QUEUE_TASK_ORDER);
+	if (!threadPool)
+	{
+		printf("testGraphCycle: failed to create thread pool.");
+		return false;
+	}
+
+	TaskGraph taskGraph = createTaskGraph(threadPool);
+	if (!taskGraph)
+	{
+		printf("testGraphCycle: failed to create task graph.");
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	bool result = true;
+	if (!runTaskGraph(taskGraph) || isTaskGraphRunning(taskGraph))
+	{
+		printf("testGraphCycle: failed to run empty task graph.");
+		result = false;
+	}
+
+	ThreadPoolTask task = { onCycleNode, NULL };
+	for (size_t i = 0; i < 3; i++)
+		addTaskGraphNode(taskGraph, task, NULL);
+	addTaskGraphEdge(taskGraph, 0, 1);
+	addTaskGraphEdge(taskGraph, 1, 2);
+	addTaskGraphEdge(taskGraph, 2, 1);
+
+	if (result && (startTaskGraph(taskGraph) || atomicLoad64(&cycleCounter) != 0))
+	{
+		printf("testGraphCycle: cycle is not detected.");
+		result = false;
+	}
+
+	clearTaskGraph(taskGraph);
+	for (size_t i = 0; i < 3; i++)
+		addTaskGraphNode(taskGraph, task, NULL);
+	addTaskGraphEdge(taskGraph, 0, 2);
+	addTaskGraphEdge(taskGraph, 1, 2);
+
+	if (result && (!startTaskGraph(taskGraph) || getTaskGraphNodeCount(taskGraph) != 3))
+	{
+		printf("testGraphCycle: failed to start task graph.");
+		result = false;
+	}
+
+	waitTaskGraph(taskGraph);
+	if (result && atomicLoad64(&cycleCounter) != 3)
+	{
+		printf("testGraphCycle: incorrect executed node count. (count: %lld)", 
+			(long long)atomicLoad64(&cycleCounter));
+		result = false;
+	}
+
+	destroyTaskGraph(taskGraph);
+	destroyThreadPool(threadPool);
+	return result;
+}
+
+int main()
+{
+	bool result = testGraphOrder();
+	result &= testGraphCycle();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
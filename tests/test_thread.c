@@ -0,0 +1,308 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/atomic.h"
+#include "mpmt/thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct AffinityData
+{
+	size_t cpu;
+	atomic_int32 result;
+} AffinityData;
+
+static void onCurrentAffinityTest(void* argument)
+{
+	AffinityData* data = (AffinityData*)argument;
+	size_t cpu = SIZE_MAX;
+
+	if (!setCurrentThreadAffinity(&data->cpu, 1))
+		atomicStore32(&data->result, 1);
+	else if (getCurrentThreadAffinity(&cpu, 1) != 1 || cpu != data->cpu)
+		atomicStore32(&data->result, 2);
+	else
+		atomicStore32(&data->result, 3);
+}
+static void onThreadAffinityTest(void* argument)
+{
+	AffinityData* data = (AffinityData*)argument;
+	while (atomicLoad32(&data->result) == 0)
+		sleepThread(0.001);
+}
+
+inline static bool testAffinity()
+{
+	#if __APPLE__
+	return true; // Note: thread affinity is not supported on macOS.
+	#else
+	size_t allowedCount = getCurrentThreadAffinity(NULL, 0);
+	if (allowedCount == 0)
+	{
+		printf("testAffinity: failed to get current thread affinity.");
+		return false;
+	}
+
+	size_t* allowedCpus = malloc(allowedCount * sizeof(size_t));
+	if (!allowedCpus || getCurrentThreadAffinity(allowedCpus, allowedCount) != allowedCount)
+	{
+		printf("testAffinity: failed to get current thread CPUs.");
+		free(allowedCpus);
+		return false;
+	}
+
+	for (size_t i = 1; i < allowedCount; i++)
+	{
+		if (allowedCpus[i - 1] >= allowedCpus[i])
+		{
+			printf("testAffinity: CPUs are not in ascending order.");
+			free(allowedCpus);
+			return false;
+		}
+	}
+
+	AffinityData data;
+	data.cpu = allowedCpus[allowedCount - 1];
+	atomicStore32(&data.result, 0);
+	free(allowedCpus);
+
+	Thread thread = createThread(onCurrentAffinityTest, &data);
+	if (!thread)
+	{
+		printf("testAffinity: failed to create thread.");
+		return false;
+	}
+	joinThread(thread);
+	destroyThread(thread);
+
+	if (atomicLoad32(&data.result) != 3)
+	{
+		printf("testAffinity: failed to pin current thread. (result: %d)", (int)atomicLoad32(&data.result));
+		return false;
+	}
+
+	atomicStore32(&data.result, 0);
+	thread = createThread(onThreadAffinityTest, &data);
+	if (!thread)
+	{
+		printf("testAffinity: failed to create thread.");
+		return false;
+	}
+
+	size_t cpu = SIZE_MAX;
+	bool isPinned = setThreadAffinity(thread, &data.cpu, 1) && 
+		getThreadAffinity(thread, &cpu, 1) == 1 && cpu == data.cpu;
+	atomicStore32(&data.result, 1);
+	joinThread(thread);
+	destroyThread(thread);
+
+	if (!isPinned)
+	{
+		printf("testAffinity: failed to pin thread. (cpu: %zu)", cpu);
+		return false;
+	}
+	return true;
+	#endif
+}
+
+//**********************************************************************************************************************
+#define TEST_STACK_SIZE 1048576
+
+typedef struct OptionsData
+{
+	size_t cpu;
+	atomic_int32 result;
+} OptionsData;
+
+static void onOptionsTest(void* argument)
+{
+	OptionsData* data = (OptionsData*)argument;
+	volatile uint8_t buffer[4096]; // Note: touching the stack.
+	for (size_t i = 0; i < sizeof(buffer); i++)
+		buffer[i] = (uint8_t)i;
+
+	char name[16];
+	getThreadName(name, sizeof(name));
+	int32_t result = strcmp(name, "mpmt-options") == 0 && buffer[255] == 255 ? 1 : 2;
+
+	#if !__APPLE__
+	size_t cpu = SIZE_MAX;
+	if (data->cpu != SIZE_MAX && (getCurrentThreadAffinity(&cpu, 1) != 1 || cpu != data->cpu))
+		result = 3;
+	#endif
+
+	atomicStore32(&data->result, result);
+}
+
+inline static bool testOptions()
+{
+	OptionsData data;
+	data.cpu = SIZE_MAX;
+	atomicStore32(&data.result, 0);
+
+	ThreadOptions options;
+	memset(&options, 0, sizeof(ThreadOptions));
+	options.stackSize = 65536;
+	options.name = "mpmt-options";
+	options.priority = BACKGROUND_THREAD_PRIORITY;
+	options.isGuardless = true;
+
+	#if !__APPLE__
+	if (getCurrentThreadAffinity(&data.cpu, 1) == 0)
+	{
+		printf("testOptions: failed to get current thread affinity.");
+		return false;
+	}
+	options.cpus = &data.cpu;
+	options.cpuCount = 1;
+	#endif
+
+	Thread thread = createThreadWithOptions(onOptionsTest, &data, &options);
+	if (!thread)
+	{
+		printf("testOptions: failed to create thread.");
+		return false;
+	}
+	joinThread(thread);
+	destroyThread(thread);
+
+	if (atomicLoad32(&data.result) != 1)
+	{
+		printf("testOptions: incorrect thread configuration. (result: %d)", (int)atomicLoad32(&data.result));
+		return false;
+	}
+
+	#if !_WIN32
+	void* stack = malloc(TEST_STACK_SIZE);
+	if (!stack)
+	{
+		printf("testOptions: failed to allocate stack.");
+		return false;
+	}
+
+	memset(&options, 0, sizeof(ThreadOptions));
+	options.stack = stack;
+	options.stackSize = TEST_STACK_SIZE;
+	options.name = "mpmt-options";
+	atomicStore32(&data.result, 0);
+	data.cpu = SIZE_MAX;
+
+	thread = createThreadWithOptions(onOptionsTest, &data, &options);
+	if (!thread)
+	{
+		printf("testOptions: failed to create thread with stack.");
+		free(stack);
+		return false;
+	}
+	joinThread(thread);
+	destroyThread(thread);
+	free(stack);
+
+	if (atomicLoad32(&data.result) != 1)
+	{
+		printf("testOptions: incorrect stack thread result. (result: %d)", (int)atomicLoad32(&data.result));
+		return false;
+	}
+	#endif
+
+	return true;
+}
+
+static void onLongNameTest(void* argument)
+{
+	char name[16];
+	getThreadName(name, sizeof(name));
+	atomicStore32((atomic_int32*)argument, strcmp(name, "mpmt-long-name-") == 0 ? 1 : 2);
+}
+
+inline static bool testLongName()
+{
+	atomic_int32 result = 0;
+	ThreadOptions options;
+	memset(&options, 0, sizeof(ThreadOptions));
+	options.name = "mpmt-long-name-thread";
+
+	Thread thread = createThreadWithOptions(onLongNameTest, (void*)&result, &options);
+	if (!thread)
+	{
+		printf("testLongName: failed to create thread.");
+		return false;
+	}
+	joinThread(thread);
+	destroyThread(thread);
+
+	if (atomicLoad32(&result) != 1)
+	{
+		printf("testLongName: name is not truncated. (result: %d)", (int)atomicLoad32(&result));
+		return false;
+	}
+	return true;
+}
+
+static void onDetachedTest(void* argument)
+{
+	atomicStore32((atomic_int32*)argument, 1);
+}
+
+inline static bool testDetached()
+{
+	atomic_int32 isDone[2] = { 0, 0 };
+	ThreadOptions options;
+	memset(&options, 0, sizeof(ThreadOptions));
+	options.isDetached = true;
+
+	// Note: first instance is destroyed while the thread can be running, second one after it is finished.
+	Thread threads[2];
+	for (size_t i = 0; i < 2; i++)
+	{
+		threads[i] = createThreadWithOptions(onDetachedTest, (void*)&isDone[i], &options);
+		if (!threads[i])
+		{
+			printf("testDetached: failed to create thread.");
+			destroyThread(threads[0]);
+			return false;
+		}
+	}
+	destroyThread(threads[0]);
+
+	for (size_t i = 0; i < 10000 && (atomicLoad32(&isDone[0]) == 0 || atomicLoad32(&isDone[1]) == 0); i++)
+		sleepThread(0.001);
+
+	if (atomicLoad32(&isDone[0]) == 0 || atomicLoad32(&isDone[1]) == 0)
+	{
+		printf("testDetached: thread is not finished.");
+		destroyThread(threads[1]);
+		return false;
+	}
+	if (isThreadJoined(threads[1]))
+	{
+		printf("testDetached: detached thread is joined.");
+		destroyThread(threads[1]);
+		return false;
+	}
+
+	destroyThread(threads[1]);
+	return true;
+}
+
+int main()
+{
+	bool result = testAffinity();
+	result &= testOptions();
+	result &= testLongName();
+	result &= testDetached();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -12,11 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "mpmt/atomic.h"
 #include "mpmt/thread.h"
 #include "mpmt/thread_pool.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define TEST_THREAD_COUNT 4
 
@@ -48,6 +50,15 @@ inline static bool testAddBlocking()
 	destroyThreadPool(threadPool);
 	return true;
 }
+static atomic_int32 tryAddState = 0;
+
+static void onTryAddTest(void* argument)
+{
+	atomicStore32(&tryAddState, 1);
+	while (atomicLoad32(&tryAddState) != 2)
+		sleepThread(0.001);
+}
+
 inline static bool testTryAdd()
 {
 	ThreadPool threadPool = createThreadPool(1, 1, STACK_TASK_ORDER);
@@ -58,17 +69,25 @@ inline static bool testTryAdd()
 		return false;
 	}
 
-	ThreadPoolTask task = { onBlockingTest, NULL };
+	// Note: keeping the only thread busy, so that the added task stays in the buffer.
+	ThreadPoolTask task = { onTryAddTest, NULL };
+	addThreadPoolTask(threadPool, task);
+	while (atomicLoad32(&tryAddState) != 1)
+		sleepThread(0.001);
+
+	task.function = onBlockingTest;
 	bool result = tryAddThreadPoolTask(threadPool, task);
 
 	if (!result)
 	{
 		printf("testTryAdd: failed to try add thread pool task.");
+		atomicStore32(&tryAddState, 2);
 		destroyThreadPool(threadPool);
 		return false;
 	}
 
 	result = tryAddThreadPoolTask(threadPool, task);
+	atomicStore32(&tryAddState, 2);
 	destroyThreadPool(threadPool);
 
 	if (result)
@@ -80,9 +99,1212 @@ inline static bool testTryAdd()
 	return true;
 }
 
+#define TEST_QUEUE_TASK_COUNT 16
+
+static size_t queueOrder[TEST_QUEUE_TASK_COUNT];
+static size_t queueOrderCount = 0;
+
+static void onQueueTest(void* argument)
+{
+	queueOrder[queueOrderCount++] = (size_t)argument;
+}
+
+inline static bool testQueueOrder()
+{
+	ThreadPool threadPool = createThreadPool(1, 4, QUEUE_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testQueueOrder: failed to create thread pool.");
+		return false;
+	}
+
+	ThreadPoolTask tasks[TEST_QUEUE_TASK_COUNT];
+	for (size_t i = 0; i < TEST_QUEUE_TASK_COUNT; i++)
+	{
+		tasks[i].function = onQueueTest;
+		tasks[i].argument = (void*)i;
+	}
+
+	addThreadPoolTasks(threadPool, tasks, TEST_QUEUE_TASK_COUNT);
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+
+	if (queueOrderCount != TEST_QUEUE_TASK_COUNT)
+	{
+		printf("testQueueOrder: incorrect executed task count. (count: %zu)", queueOrderCount);
+		return false;
+	}
+
+	for (size_t i = 0; i < TEST_QUEUE_TASK_COUNT; i++)
+	{
+		if (queueOrder[i] != i)
+		{
+			printf("testQueueOrder: incorrect task order. (index: %zu)", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#define TEST_RESIZE_CAPACITY 4
+
+static atomic_int32 queueResizeState = 0;
+
+static void onQueueResizeBlock(void* argument)
+{
+	atomicStore32(&queueResizeState, 1);
+	while (atomicLoad32(&queueResizeState) != 2)
+		sleepThread(0.001);
+}
+
+inline static bool testQueueResize()
+{
+	ThreadPool threadPool = createThreadPool(1, TEST_RESIZE_CAPACITY, QUEUE_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testQueueResize: failed to create thread pool.");
+		return false;
+	}
+
+	// Note: blocked worker has taken the first slot, so the next tasks wrap around the ring end.
+	ThreadPoolTask task = { onQueueResizeBlock, NULL };
+	addThreadPoolTask(threadPool, task);
+	while (atomicLoad32(&queueResizeState) != 1)
+		sleepThread(0.001);
+
+	queueOrderCount = 0;
+	ThreadPoolTask tasks[TEST_RESIZE_CAPACITY * 2];
+	for (size_t i = 0; i < TEST_RESIZE_CAPACITY * 2; i++)
+	{
+		tasks[i].function = onQueueTest;
+		tasks[i].argument = (void*)i;
+	}
+	addThreadPoolTasks(threadPool, tasks, TEST_RESIZE_CAPACITY);
+
+	bool result = resizeThreadPoolTasks(threadPool, TEST_RESIZE_CAPACITY * 2);
+	if (result)
+		addThreadPoolTasks(threadPool, tasks + TEST_RESIZE_CAPACITY, TEST_RESIZE_CAPACITY);
+
+	atomicStore32(&queueResizeState, 2);
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+
+	if (!result)
+	{
+		printf("testQueueResize: failed to resize thread pool tasks.");
+		return false;
+	}
+	if (queueOrderCount != TEST_RESIZE_CAPACITY * 2)
+	{
+		printf("testQueueResize: incorrect executed task count. (count: %zu)", queueOrderCount);
+		return false;
+	}
+
+	for (size_t i = 0; i < TEST_RESIZE_CAPACITY * 2; i++)
+	{
+		if (queueOrder[i] != i)
+		{
+			printf("testQueueResize: incorrect task order. (index: %zu)", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_STEALING_DEPTH 12
+
+static ThreadPool stealingThreadPool = NULL;
+static atomic_int64 stealingCounter = 0;
+
+static void onStealingTest(void* argument)
+{
+	size_t depth = (size_t)argument;
+	atomicFetchAdd64(&stealingCounter, 1);
+
+	if (depth == 0)
+		return;
+
+	ThreadPoolTask task = { onStealingTest, (void*)(depth - 1) };
+	addThreadPoolTaskNumber(stealingThreadPool, task, 2);
+}
+
+inline static bool testStealing()
+{
+	ThreadPool threadPool = createThreadPool(
+		TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, STEALING_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testStealing: failed to create thread pool.");
+		return false;
+	}
+
+	stealingThreadPool = threadPool;
+
+	ThreadPoolTask task = { onStealingTest, (void*)(size_t)TEST_STEALING_DEPTH };
+	addThreadPoolTask(threadPool, task);
+	waitThreadPool(threadPool);
+
+	int64_t counter = atomicLoad64(&stealingCounter);
+	destroyThreadPool(threadPool);
+
+	if (counter != (1 << (TEST_STEALING_DEPTH + 1)) - 1)
+	{
+		printf("testStealing: incorrect executed task count. (count: %lld)", (long long)counter);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_LOCK_FREE_TASK_COUNT 10000
+
+static atomic_int64 lockFreeCounter = 0;
+
+static void onLockFreeTest(void* argument)
+{
+	atomicFetchAdd64(&lockFreeCounter, (int64_t)(size_t)argument);
+}
+
+inline static bool testLockFree()
+{
+	ThreadPool threadPool = createThreadPool(
+		TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, LOCK_FREE_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testLockFree: failed to create thread pool.");
+		return false;
+	}
+
+	ThreadPoolTask task = { onLockFreeTest, (void*)1 };
+	for (size_t i = 0; i < TEST_LOCK_FREE_TASK_COUNT; i++)
+		addThreadPoolTask(threadPool, task);
+
+	task.argument = (void*)2;
+	addThreadPoolTaskNumber(threadPool, task, TEST_LOCK_FREE_TASK_COUNT);
+	waitThreadPool(threadPool);
+
+	int64_t counter = atomicLoad64(&lockFreeCounter);
+	destroyThreadPool(threadPool);
+
+	if (counter != TEST_LOCK_FREE_TASK_COUNT * 3)
+	{
+		printf("testLockFree: incorrect executed task count. (count: %lld)", (long long)counter);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_NUMA_TASK_COUNT 10000
+
+static atomic_int64 numaCounter = 0;
+
+static void onNumaTest(void* argument)
+{
+	atomicFetchAdd64(&numaCounter, (int64_t)(size_t)argument);
+}
+
+inline static bool testNumaOrder()
+{
+	ThreadPool threadPool = createThreadPool(
+		TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, NUMA_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testNumaOrder: failed to create thread pool.");
+		return false;
+	}
+
+	size_t nodeCount = getThreadPoolNodeCount(threadPool);
+	for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+	{
+		if (getThreadPoolThreadNode(threadPool, i) >= nodeCount)
+		{
+			printf("testNumaOrder: incorrect thread node. (nodeCount: %zu)", nodeCount);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+	}
+
+	// Note: tasks exceed the pool capacity, so adding blocks and spills to the other nodes.
+	ThreadPoolTask tasks[TEST_THREAD_COUNT * 8];
+	for (size_t i = 0; i < TEST_THREAD_COUNT * 8; i++)
+	{
+		tasks[i].function = onNumaTest;
+		tasks[i].argument = (void*)3;
+	}
+
+	ThreadPoolTask task = { onNumaTest, (void*)1 };
+	for (size_t i = 0; i < TEST_NUMA_TASK_COUNT; i++)
+		addThreadPoolNodeTask(threadPool, task, i % (nodeCount + 1));
+
+	task.argument = (void*)2;
+	addThreadPoolTaskNumber(threadPool, task, TEST_NUMA_TASK_COUNT);
+	for (size_t i = 0; i < nodeCount; i++)
+		addThreadPoolNodeTasks(threadPool, tasks, TEST_THREAD_COUNT * 8, i);
+	addThreadPoolNodeTasks(threadPool, tasks, TEST_THREAD_COUNT * 8, THREAD_POOL_ANY_NODE);
+	waitThreadPool(threadPool);
+
+	bool isResized = resizeThreadPoolTasks(threadPool, TEST_THREAD_COUNT * 8);
+	int64_t counter = atomicLoad64(&numaCounter);
+	destroyThreadPool(threadPool);
+
+	int64_t expected = TEST_NUMA_TASK_COUNT * 3 + TEST_THREAD_COUNT * 8 * 3 * (int64_t)(nodeCount + 1);
+	if (counter != expected)
+	{
+		printf("testNumaOrder: incorrect executed task count. (count: %lld)", (long long)counter);
+		return false;
+	}
+	if (isResized)
+	{
+		printf("testNumaOrder: NUMA thread pool is resized.");
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_PARALLEL_FOR_SIZE 100000
+#define TEST_PARALLEL_FOR_OFFSET 10
+
+static void onParallelForTest(void* context, size_t rangeBegin, size_t rangeEnd)
+{
+	atomic_int32* values = (atomic_int32*)context;
+	for (size_t i = rangeBegin; i < rangeEnd; i++)
+		atomicFetchAdd32(&values[i], 1);
+}
+
+inline static bool testParallelFor()
+{
+	ThreadPool threadPool = createThreadPool(
+		TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, STACK_TASK_ORDER);
+
+	if (!threadPool)
+	{
+		printf("testParallelFor: failed to create thread pool.");
+		return false;
+	}
+
+	atomic_int32* values = calloc(TEST_PARALLEL_FOR_SIZE, sizeof(int32_t));
+
+	if (!values)
+	{
+		printf("testParallelFor: failed to allocate values.");
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	size_t grains[] = { 0, 1, 7, 1000, TEST_PARALLEL_FOR_SIZE * 2 };
+	size_t grainCount = sizeof(grains) / sizeof(size_t);
+
+	for (size_t i = 0; i < grainCount; i++)
+	{
+		parallelForThreadPool(threadPool, TEST_PARALLEL_FOR_OFFSET, 
+			TEST_PARALLEL_FOR_SIZE, grains[i], onParallelForTest, (void*)values);
+	}
+
+	destroyThreadPool(threadPool);
+
+	for (size_t i = 0; i < TEST_PARALLEL_FOR_SIZE; i++)
+	{
+		int32_t expected = i < TEST_PARALLEL_FOR_OFFSET ? 0 : (int32_t)grainCount;
+		if (values[i] != expected)
+		{
+			printf("testParallelFor: incorrect value. (index: %zu, value: %d)", i, (int)values[i]);
+			free((void*)values);
+			return false;
+		}
+	}
+
+	free((void*)values);
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_TASK_GROUP_COUNT 16
+#define TEST_TASK_GROUP_SIZE 64
+
+static atomic_int64 taskGroupCounter = 0;
+
+static void onTaskGroupInnerTest(void* argument)
+{
+	atomicFetchAdd64(&taskGroupCounter, 1);
+}
+static void onTaskGroupTest(void* argument)
+{
+	ThreadPool threadPool = (ThreadPool)argument;
+	TaskGroup taskGroup = createTaskGroup(threadPool);
+	if (!taskGroup)
+		abort();
+
+	// Note: waiting inside of the thread pool task, other groups are still running.
+	ThreadPoolTask task = { onTaskGroupInnerTest, NULL };
+	addTaskGroupTaskNumber(taskGroup, task, TEST_TASK_GROUP_SIZE);
+	waitTaskGroup(taskGroup);
+	destroyTaskGroup(taskGroup);
+}
+
+inline static bool testTaskGroup()
+{
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		ThreadPool threadPool = createThreadPool(
+			TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, taskOrder);
+
+		if (!threadPool)
+		{
+			printf("testTaskGroup: failed to create thread pool.");
+			return false;
+		}
+
+		TaskGroup taskGroup = createTaskGroup(threadPool);
+
+		if (!taskGroup)
+		{
+			printf("testTaskGroup: failed to create task group.");
+			destroyThreadPool(threadPool);
+			return false;
+		}
+
+		atomicStore64(&taskGroupCounter, 0);
+
+		ThreadPoolTask task = { onTaskGroupTest, threadPool };
+		addTaskGroupTaskNumber(taskGroup, task, TEST_TASK_GROUP_COUNT);
+		waitTaskGroup(taskGroup);
+
+		int64_t counter = atomicLoad64(&taskGroupCounter);
+		bool isRunning = isTaskGroupRunning(taskGroup);
+
+		destroyTaskGroup(taskGroup);
+		destroyThreadPool(threadPool);
+
+		if (isRunning || counter != TEST_TASK_GROUP_COUNT * TEST_TASK_GROUP_SIZE)
+		{
+			printf("testTaskGroup: incorrect executed task count. (order: %d, count: %lld)", 
+				(int)taskOrder, (long long)counter);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_INLINE_TASK_COUNT 256
+
+typedef struct InlinePayload
+{
+	atomic_int64* values;
+	size_t index;
+	int64_t value;
+} InlinePayload;
+
+static void onInlineTest(void* payload)
+{
+	InlinePayload inlinePayload;
+	memcpy(&inlinePayload, payload, sizeof(InlinePayload));
+	atomicFetchAdd64(&inlinePayload.values[inlinePayload.index], inlinePayload.value);
+}
+
+inline static bool testInlineTask()
+{
+	atomic_int64* values = calloc(TEST_INLINE_TASK_COUNT, sizeof(atomic_int64));
+	ThreadPoolInlineTask* tasks = calloc(TEST_INLINE_TASK_COUNT, sizeof(ThreadPoolInlineTask));
+	if (!values || !tasks)
+		abort();
+
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, taskOrder);
+		TaskGroup taskGroup = threadPool ? createTaskGroup(threadPool) : NULL;
+
+		if (!taskGroup)
+		{
+			printf("testInlineTask: failed to create thread pool.");
+			destroyThreadPool(threadPool);
+			free(tasks); free((void*)values);
+			return false;
+		}
+
+		for (size_t i = 0; i < TEST_INLINE_TASK_COUNT; i++)
+		{
+			atomicStore64(&values[i], 0);
+			InlinePayload payload = { values, i, (int64_t)i };
+			tasks[i].function = onInlineTest;
+			memcpy(tasks[i].payload, &payload, sizeof(InlinePayload));
+		}
+
+		// Note: each value gets index added by the bulk tasks and the group tasks, and 1 by the same tasks.
+		addThreadPoolInlineTasks(threadPool, tasks, TEST_INLINE_TASK_COUNT);
+		addTaskGroupInlineTasks(taskGroup, tasks, TEST_INLINE_TASK_COUNT);
+
+		InlinePayload payload = { values, 0, 1 };
+		ThreadPoolInlineTask task;
+		task.function = onInlineTest;
+		for (size_t i = 0; i < TEST_INLINE_TASK_COUNT; i++)
+		{
+			payload.index = i;
+			memcpy(task.payload, &payload, sizeof(InlinePayload));
+			addThreadPoolInlineTask(threadPool, &task);
+		}
+
+		payload.index = 0;
+		memcpy(task.payload, &payload, sizeof(InlinePayload));
+		addTaskGroupInlineTaskNumber(taskGroup, &task, TEST_INLINE_TASK_COUNT);
+
+		waitTaskGroup(taskGroup);
+		waitThreadPool(threadPool);
+		destroyTaskGroup(taskGroup);
+		destroyThreadPool(threadPool);
+
+		for (size_t i = 0; i < TEST_INLINE_TASK_COUNT; i++)
+		{
+			int64_t expected = (int64_t)i * 2 + 1 + (i == 0 ? TEST_INLINE_TASK_COUNT : 0);
+			if (atomicLoad64(&values[i]) != expected)
+			{
+				printf("testInlineTask: incorrect value. (order: %d, index: %zu, value: %lld)", 
+					(int)taskOrder, i, (long long)atomicLoad64(&values[i]));
+				free(tasks); free((void*)values);
+				return false;
+			}
+		}
+	}
+
+	free(tasks); free((void*)values);
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_PINNED_TASK_COUNT 64
+
+typedef struct PinnedData
+{
+	atomic_int64 taskCount;
+	atomic_int64 failCount;
+} PinnedData;
+
+static void onPinnedTest(void* argument)
+{
+	PinnedData* data = (PinnedData*)argument;
+	size_t cpu = SIZE_MAX;
+	if (getCurrentThreadAffinity(&cpu, 1) != 1 || cpu == SIZE_MAX)
+		atomicFetchAdd64(&data->failCount, 1);
+	atomicFetchAdd64(&data->taskCount, 1);
+}
+
+inline static bool testPinnedThreadPool()
+{
+	#if __APPLE__
+	return true; // Note: thread affinity is not supported on macOS.
+	#else
+	size_t allowedCpus[4];
+	size_t allowedCount = getCurrentThreadAffinity(allowedCpus, 4);
+	if (allowedCount == 0)
+	{
+		printf("testPinnedThreadPool: failed to get current thread affinity.");
+		return false;
+	}
+
+	size_t explicitCpu = allowedCpus[0];
+	for (ThreadPinning pinning = COMPACT_THREAD_PINNING; pinning < THREAD_PINNING_COUNT; pinning++)
+	{
+		ThreadPool threadPool = createPinnedThreadPool(TEST_THREAD_COUNT, 
+			TEST_PINNED_TASK_COUNT, QUEUE_TASK_ORDER, pinning, &explicitCpu, 1);
+
+		if (!threadPool)
+		{
+			printf("testPinnedThreadPool: failed to create thread pool. (pinning: %d)", (int)pinning);
+			return false;
+		}
+
+		for (size_t i = 0; i < TEST_THREAD_COUNT; i++)
+		{
+			size_t cpu = getThreadPoolThreadCpu(threadPool, i);
+			if (cpu == SIZE_MAX || (pinning == EXPLICIT_THREAD_PINNING && cpu != explicitCpu))
+			{
+				printf("testPinnedThreadPool: incorrect thread CPU. (pinning: %d, cpu: %zu)", (int)pinning, cpu);
+				destroyThreadPool(threadPool);
+				return false;
+			}
+		}
+
+		PinnedData data;
+		atomicStore64(&data.taskCount, 0);
+		atomicStore64(&data.failCount, 0);
+
+		ThreadPoolTask task;
+		task.function = onPinnedTest;
+		task.argument = &data;
+		addThreadPoolTaskNumber(threadPool, task, TEST_PINNED_TASK_COUNT);
+		waitThreadPool(threadPool);
+		destroyThreadPool(threadPool);
+
+		if (atomicLoad64(&data.taskCount) != TEST_PINNED_TASK_COUNT || atomicLoad64(&data.failCount) != 0)
+		{
+			printf("testPinnedThreadPool: worker is not pinned. (pinning: %d, failCount: %lld)", 
+				(int)pinning, (long long)atomicLoad64(&data.failCount));
+			return false;
+		}
+	}
+
+	ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT, QUEUE_TASK_ORDER);
+	if (!threadPool || getThreadPoolPinning(threadPool) != NO_THREAD_PINNING || 
+		getThreadPoolThreadCpu(threadPool, 0) != SIZE_MAX)
+	{
+		printf("testPinnedThreadPool: not pinned thread pool has CPU.");
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	destroyThreadPool(threadPool);
+	return true;
+	#endif
+}
+
+//**********************************************************************************************************************
+static atomic_int64 namedCounter = 0;
+
+static void onWorkerOptionsTest(void* argument)
+{
+	char name[16];
+	getThreadName(name, sizeof(name));
+	if (strncmp(name, "mpmt-worker", 11) == 0 && name[11] >= '0' && name[11] <= '9')
+		atomicFetchAdd64(&namedCounter, 1);
+}
+
+inline static bool testWorkerOptions()
+{
+	ThreadOptions options;
+	memset(&options, 0, sizeof(ThreadOptions));
+	options.stackSize = 131072;
+	options.name = "mpmt-worker";
+	options.isGuardless = true;
+
+	ThreadPool threadPool = createThreadPoolWithOptions(TEST_THREAD_COUNT, 
+		TEST_THREAD_COUNT * 4, QUEUE_TASK_ORDER, NO_THREAD_PINNING, NULL, 0, &options);
+
+	if (!threadPool)
+	{
+		printf("testWorkerOptions: failed to create thread pool.");
+		return false;
+	}
+
+	ThreadPoolTask task = { onWorkerOptionsTest, NULL };
+	addThreadPoolTaskNumber(threadPool, task, TEST_THREAD_COUNT * 16);
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+
+	int64_t counter = atomicLoad64(&namedCounter);
+	if (counter != TEST_THREAD_COUNT * 16)
+	{
+		printf("testWorkerOptions: incorrect worker name count. (count: %lld)", (long long)counter);
+		return false;
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_IDLE_TASK_COUNT 256
+
+static atomic_int64 idleCounter = 0;
+
+static void onIdlePolicyTest(void* argument)
+{
+	atomicFetchAdd64(&idleCounter, 1);
+}
+
+inline static bool testIdlePolicy()
+{
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		for (IdlePolicy idlePolicy = 0; idlePolicy < IDLE_POLICY_COUNT; idlePolicy++)
+		{
+			ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, taskOrder);
+			if (!threadPool)
+			{
+				printf("testIdlePolicy: failed to create thread pool.");
+				return false;
+			}
+
+			setThreadPoolIdlePolicy(threadPool, idlePolicy, 64, 4);
+			if (getThreadPoolIdlePolicy(threadPool) != idlePolicy)
+			{
+				printf("testIdlePolicy: incorrect idle policy. (policy: %d)", (int)idlePolicy);
+				destroyThreadPool(threadPool);
+				return false;
+			}
+
+			atomicStore64(&idleCounter, 0);
+			ThreadPoolTask task = { onIdlePolicyTest, NULL };
+
+			// Note: second burst is added after the workers went idle.
+			for (int i = 0; i < 2; i++)
+			{
+				addThreadPoolTaskNumber(threadPool, task, TEST_IDLE_TASK_COUNT);
+				waitThreadPool(threadPool);
+				sleepThread(0.001);
+			}
+			destroyThreadPool(threadPool);
+
+			int64_t counter = atomicLoad64(&idleCounter);
+			if (counter != TEST_IDLE_TASK_COUNT * 2)
+			{
+				printf("testIdlePolicy: incorrect executed task count. (order: %d, policy: %d, count: %lld)", 
+					(int)taskOrder, (int)idlePolicy, (long long)counter);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_PRODUCER_COUNT 4
+#define TEST_PRODUCER_TASK_COUNT 2000
+
+static atomic_int64 producerCounter = 0;
+
+static void onProducerTask(void* argument)
+{
+	atomicFetchAdd64(&producerCounter, 1);
+}
+static void onProducerThread(void* argument)
+{
+	ThreadPool threadPool = (ThreadPool)argument;
+	ThreadPoolTask task = { onProducerTask, NULL };
+	for (size_t i = 0; i < TEST_PRODUCER_TASK_COUNT; i++)
+		addThreadPoolTask(threadPool, task);
+	waitThreadPool(threadPool);
+}
+
+inline static bool testManyProducers()
+{
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		// Note: small capacity keeps the producers waiting for the free space most of the time.
+		ThreadPool threadPool = createThreadPool(TEST_THREAD_COUNT, TEST_THREAD_COUNT, taskOrder);
+		if (!threadPool)
+		{
+			printf("testManyProducers: failed to create thread pool.");
+			return false;
+		}
+
+		atomicStore64(&producerCounter, 0);
+		Thread producers[TEST_PRODUCER_COUNT];
+
+		for (size_t i = 0; i < TEST_PRODUCER_COUNT; i++)
+		{
+			producers[i] = createThread(onProducerThread, threadPool);
+			if (!producers[i])
+			{
+				printf("testManyProducers: failed to create producer thread.");
+				return false;
+			}
+		}
+		for (size_t i = 0; i < TEST_PRODUCER_COUNT; i++)
+		{
+			joinThread(producers[i]);
+			destroyThread(producers[i]);
+		}
+
+		waitThreadPool(threadPool);
+		destroyThreadPool(threadPool);
+
+		int64_t counter = atomicLoad64(&producerCounter);
+		if (counter != TEST_PRODUCER_COUNT * TEST_PRODUCER_TASK_COUNT)
+		{
+			printf("testManyProducers: incorrect executed task count. (order: %d, count: %lld)", 
+				(int)taskOrder, (long long)counter);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_ELASTIC_TASK_COUNT 32
+
+static atomic_int64 elasticCounter = 0;
+
+static void onElasticTest(void* argument)
+{
+	sleepThread(0.002);
+	atomicFetchAdd64(&elasticCounter, 1);
+}
+static bool waitThreadCount(ThreadPool threadPool, size_t threadCount)
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		if (getThreadPoolThreadCount(threadPool) == threadCount)
+			return true;
+		sleepThread(0.002);
+	}
+	return false;
+}
+
+inline static bool testElasticThreadPool()
+{
+	for (TaskOrder taskOrder = 0; taskOrder < TASK_ORDER_COUNT; taskOrder++)
+	{
+		ThreadPool threadPool = createElasticThreadPool(1, 
+			TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, taskOrder, 1, 0.01);
+		if (!threadPool)
+		{
+			printf("testElasticThreadPool: failed to create thread pool.");
+			return false;
+		}
+
+		if (getThreadPoolThreadCount(threadPool) != 1 || 
+			getThreadPoolThreadCapacity(threadPool) != TEST_THREAD_COUNT)
+		{
+			printf("testElasticThreadPool: incorrect initial thread count. (order: %d)", (int)taskOrder);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+
+		atomicStore64(&elasticCounter, 0);
+		ThreadPoolTask task = { onElasticTest, NULL };
+		addThreadPoolTaskNumber(threadPool, task, TEST_ELASTIC_TASK_COUNT);
+
+		size_t threadCount = getThreadPoolThreadCount(threadPool);
+		waitThreadPool(threadPool);
+
+		if (threadCount < 2)
+		{
+			printf("testElasticThreadPool: pool didn't grow. (order: %d)", (int)taskOrder);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+		if (!waitThreadCount(threadPool, 1))
+		{
+			printf("testElasticThreadPool: idle workers didn't retire. (order: %d)", (int)taskOrder);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+
+		if (!setThreadPoolThreadCount(threadPool, 3) || getThreadPoolThreadCount(threadPool) != 3)
+		{
+			printf("testElasticThreadPool: failed to set thread count. (order: %d)", (int)taskOrder);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+
+		// Note: shrinking while the tasks are running.
+		addThreadPoolTaskNumber(threadPool, task, TEST_ELASTIC_TASK_COUNT);
+		setThreadPoolThreadCount(threadPool, 2);
+		waitThreadPool(threadPool);
+
+		if (!waitThreadCount(threadPool, 2))
+		{
+			printf("testElasticThreadPool: extra workers didn't retire. (order: %d)", (int)taskOrder);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+		destroyThreadPool(threadPool);
+
+		int64_t counter = atomicLoad64(&elasticCounter);
+		if (counter != TEST_ELASTIC_TASK_COUNT * 2)
+		{
+			printf("testElasticThreadPool: incorrect executed task count. (order: %d, count: %lld)", 
+				(int)taskOrder, (long long)counter);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+inline static bool testElasticKeepAlive()
+{
+	ThreadPool threadPool = createElasticThreadPool(1, 
+		TEST_THREAD_COUNT, TEST_THREAD_COUNT * 4, QUEUE_TASK_ORDER, 1, 10.0);
+	if (!threadPool)
+	{
+		printf("testElasticKeepAlive: failed to create thread pool.");
+		return false;
+	}
+
+	ThreadPoolTask task = { onElasticTest, NULL };
+	addThreadPoolTaskNumber(threadPool, task, TEST_ELASTIC_TASK_COUNT);
+	waitThreadPool(threadPool);
+	size_t threadCount = getThreadPoolThreadCount(threadPool);
+
+	// Note: each task wakes an idle worker, which should not retire if the other worker takes the task.
+	for (size_t i = 0; i < TEST_ELASTIC_TASK_COUNT; i++)
+	{
+		addThreadPoolTask(threadPool, task);
+		sleepThread(0.002);
+	}
+	waitThreadPool(threadPool);
+
+	size_t keptCount = getThreadPoolThreadCount(threadPool);
+	destroyThreadPool(threadPool);
+
+	if (keptCount < threadCount)
+	{
+		printf("testElasticKeepAlive: workers retired before the keep-alive timeout. (count: %zu, kept: %zu)", 
+			threadCount, keptCount);
+		return false;
+	}
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_SEGMENTED_TASK_COUNT 1000
+
+static atomic_int64 segmentedGate = 0;
+static size_t segmentedOrder[TEST_SEGMENTED_TASK_COUNT];
+static size_t segmentedOrderCount = 0;
+
+static void onSegmentedGate(void* argument)
+{
+	while (atomicLoad64(&segmentedGate) == 0)
+		sleepThread(0.001);
+}
+static void onSegmentedTest(void* argument)
+{
+	segmentedOrder[segmentedOrderCount++] = (size_t)argument;
+}
+
+inline static bool checkSegmentedOrder(const char* stage)
+{
+	if (segmentedOrderCount != TEST_SEGMENTED_TASK_COUNT)
+	{
+		printf("testSegmentedQueue: incorrect executed task count. (stage: %s, count: %zu)", 
+			stage, segmentedOrderCount);
+		return false;
+	}
+	for (size_t i = 0; i < TEST_SEGMENTED_TASK_COUNT; i++)
+	{
+		if (segmentedOrder[i] != i)
+		{
+			printf("testSegmentedQueue: incorrect task order. (stage: %s, index: %zu)", stage, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+inline static bool testSegmentedQueue()
+{
+	ThreadPool threadPool = createThreadPool(1, THREAD_POOL_UNBOUNDED_CAPACITY, SEGMENTED_TASK_ORDER);
+	if (!threadPool)
+	{
+		printf("testSegmentedQueue: failed to create thread pool.");
+		return false;
+	}
+
+	ThreadPoolTask* tasks = malloc(TEST_SEGMENTED_TASK_COUNT * sizeof(ThreadPoolTask));
+	if (!tasks)
+		abort();
+
+	for (size_t i = 0; i < TEST_SEGMENTED_TASK_COUNT; i++)
+	{
+		tasks[i].function = onSegmentedTest;
+		tasks[i].argument = (void*)i;
+	}
+
+	// Note: the only worker is blocked, so all tasks are queued without blocking the producer.
+	ThreadPoolTask gate = { onSegmentedGate, NULL };
+	atomicStore64(&segmentedGate, 0);
+	addThreadPoolTask(threadPool, gate);
+	addThreadPoolTasks(threadPool, tasks, TEST_SEGMENTED_TASK_COUNT);
+
+	// Note: capping the memory usage below the queued task count applies backpressure.
+	if (!resizeThreadPoolTasks(threadPool, 8) || tryAddThreadPoolTask(threadPool, gate))
+	{
+		printf("testSegmentedQueue: task capacity limit is not applied.");
+		atomicStore64(&segmentedGate, 1);
+		destroyThreadPool(threadPool);
+		free(tasks);
+		return false;
+	}
+
+	atomicStore64(&segmentedGate, 1);
+	waitThreadPool(threadPool);
+
+	bool result = checkSegmentedOrder("segmented");
+	if (result && !tryAddThreadPoolTask(threadPool, gate))
+	{
+		printf("testSegmentedQueue: failed to add task after the queue is drained.");
+		result = false;
+	}
+
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+
+	if (!result)
+	{
+		free(tasks);
+		return false;
+	}
+
+	// Note: ring resize keeps queued tasks and does not wait for them.
+	threadPool = createThreadPool(1, 4, QUEUE_TASK_ORDER);
+	if (!threadPool)
+	{
+		printf("testSegmentedQueue: failed to create thread pool.");
+		free(tasks);
+		return false;
+	}
+
+	segmentedOrderCount = 0;
+	atomicStore64(&segmentedGate, 0);
+	addThreadPoolTask(threadPool, gate);
+	addThreadPoolTasks(threadPool, tasks, 3);
+
+	if (!resizeThreadPoolTasks(threadPool, TEST_SEGMENTED_TASK_COUNT + 1) || 
+		!isThreadPoolRunning(threadPool) || atomicLoad64(&segmentedGate) != 0)
+	{
+		printf("testSegmentedQueue: failed to resize running thread pool.");
+		atomicStore64(&segmentedGate, 1);
+		destroyThreadPool(threadPool);
+		free(tasks);
+		return false;
+	}
+
+	addThreadPoolTasks(threadPool, tasks + 3, TEST_SEGMENTED_TASK_COUNT - 3);
+	atomicStore64(&segmentedGate, 1);
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+	free(tasks);
+	return checkSegmentedOrder("resized queue");
+}
+
+//**********************************************************************************************************************
+#define TEST_PRIORITY_TASK_COUNT 4
+
+static atomic_int64 priorityGate = 0;
+static atomic_int64 priorityGateStarted = 0;
+static TaskPriority priorityOrder[TEST_PRIORITY_TASK_COUNT * TASK_PRIORITY_COUNT];
+static size_t priorityOrderCount = 0;
+
+static void onPriorityGate(void* argument)
+{
+	atomicStore64(&priorityGateStarted, 1);
+	while (atomicLoad64(&priorityGate) == 0)
+		sleepThread(0.001);
+}
+static void onPriorityTest(void* argument)
+{
+	priorityOrder[priorityOrderCount++] = (TaskPriority)(size_t)argument;
+}
+
+inline static bool checkTaskPriority(TaskOrder taskOrder, uint32_t weight, const char* expectedOrder)
+{
+	ThreadPool threadPool = createThreadPool(1, 64, taskOrder);
+	if (!threadPool)
+	{
+		printf("testTaskPriority: failed to create thread pool.");
+		return false;
+	}
+
+	setThreadPoolPriorityWeights(threadPool, weight, weight);
+
+	// Note: holding the only worker, so that all priority queues are filled before the first pop.
+	ThreadPoolTask gate = { onPriorityGate, NULL };
+	atomicStore64(&priorityGate, 0);
+	atomicStore64(&priorityGateStarted, 0);
+	addThreadPoolTask(threadPool, gate);
+
+	while (atomicLoad64(&priorityGateStarted) == 0)
+		yieldThread();
+
+	priorityOrderCount = 0;
+	ThreadPoolTask task = { onPriorityTest, (void*)(size_t)LOW_TASK_PRIORITY };
+	addThreadPoolPriorityTaskNumber(threadPool, task, TEST_PRIORITY_TASK_COUNT, LOW_TASK_PRIORITY);
+
+	ThreadPoolTask tasks[TEST_PRIORITY_TASK_COUNT];
+	for (size_t i = 0; i < TEST_PRIORITY_TASK_COUNT; i++)
+	{
+		tasks[i].function = onPriorityTest;
+		tasks[i].argument = (void*)(size_t)NORMAL_TASK_PRIORITY;
+	}
+	addThreadPoolTasks(threadPool, tasks, TEST_PRIORITY_TASK_COUNT);
+
+	task.argument = (void*)(size_t)HIGH_TASK_PRIORITY;
+	for (size_t i = 0; i < TEST_PRIORITY_TASK_COUNT; i++)
+	{
+		if (!tryAddThreadPoolPriorityTask(threadPool, task, HIGH_TASK_PRIORITY))
+		{
+			printf("testTaskPriority: failed to add task. (order: %d)", (int)taskOrder);
+			atomicStore64(&priorityGate, 1);
+			destroyThreadPool(threadPool);
+			return false;
+		}
+	}
+
+	atomicStore64(&priorityGate, 1);
+	waitThreadPool(threadPool);
+	destroyThreadPool(threadPool);
+
+	// Note: priorities are encoded as the 'H', 'N' and 'L' characters.
+	for (size_t i = 0; i < TEST_PRIORITY_TASK_COUNT * TASK_PRIORITY_COUNT; i++)
+	{
+		if ("HNL"[priorityOrder[i]] != expectedOrder[i])
+		{
+			printf("testTaskPriority: incorrect task order. (order: %d, weight: %u, index: %zu)", 
+				(int)taskOrder, weight, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+inline static bool testTaskPriority()
+{
+	TaskOrder taskOrders[3] = { STACK_TASK_ORDER, QUEUE_TASK_ORDER, SEGMENTED_TASK_ORDER };
+	for (size_t i = 0; i < 3; i++)
+	{
+		if (!checkTaskPriority(taskOrders[i], 0, "HHHHNNNNLLLL"))
+			return false;
+		if (!checkTaskPriority(taskOrders[i], 1, "HNHLHNHLNLNL"))
+			return false;
+	}
+	return true;
+}
+
+//**********************************************************************************************************************
+#define TEST_FUTURE_CHAIN_LENGTH 100
+
+static Future nestedFuture = NULL;
+
+static void* onFutureSquare(void* argument, void* result)
+{
+	size_t value = (size_t)argument;
+	return (void*)(value * value);
+}
+static void* onFutureIncrement(void* argument, void* result)
+{
+	return (void*)((size_t)result + (size_t)argument);
+}
+// Note: waiting inside of the only worker, nested future task is executed by the waiting thread.
+static void* onFutureNested(void* argument, void* result)
+{
+	nestedFuture = addThreadPoolFutureTask((ThreadPool)argument, onFutureSquare, (void*)(size_t)7);
+	return nestedFuture ? waitFuture(nestedFuture) : NULL;
+}
+static void onFuturePromise(void* argument)
+{
+	sleepThread(0.01);
+	setFutureResult((Future)argument, (void*)(size_t)5);
+}
+
+inline static bool testFuture()
+{
+	ThreadPool threadPool = createThreadPool(1, 4, QUEUE_TASK_ORDER);
+	if (!threadPool)
+	{
+		printf("testFuture: failed to create thread pool.");
+		return false;
+	}
+
+	Future future = addThreadPoolFutureTask(threadPool, onFutureSquare, (void*)(size_t)3);
+	if (!future || (size_t)waitFuture(future) != 9 || !isFutureReady(future))
+	{
+		printf("testFuture: incorrect future task result.");
+		destroyFuture(future);
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	// Note: continuation of the ready future is scheduled right away.
+	Future continuation = addFutureContinuation(future, onFutureIncrement, (void*)(size_t)1);
+	destroyFuture(future);
+	if (!continuation || (size_t)waitFuture(continuation) != 10)
+	{
+		printf("testFuture: incorrect ready future continuation result.");
+		destroyFuture(continuation);
+		destroyThreadPool(threadPool);
+		return false;
+	}
+	destroyFuture(continuation);
+
+	Future promise = createFuture(threadPool);
+	if (!promise)
+	{
+		printf("testFuture: failed to create future.");
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	// Note: chain is built before the promise is set, intermediate handles are released early.
+	Future chain = promise;
+	for (size_t i = 0; i < TEST_FUTURE_CHAIN_LENGTH; i++)
+	{
+		Future next = addFutureContinuation(chain, onFutureIncrement, (void*)(size_t)1);
+		if (chain != promise)
+			destroyFuture(chain);
+		chain = next;
+		if (!chain)
+			abort();
+	}
+
+	Thread thread = createThread(onFuturePromise, promise);
+	if (!thread)
+		abort();
+
+	size_t result = (size_t)waitFuture(chain);
+	joinThread(thread);
+	destroyThread(thread);
+	destroyFuture(chain);
+	destroyFuture(promise);
+
+	if (result != 5 + TEST_FUTURE_CHAIN_LENGTH)
+	{
+		printf("testFuture: incorrect continuation chain result. (result: %zu)", result);
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	future = addThreadPoolFutureTask(threadPool, onFutureNested, threadPool);
+	if (!future || (size_t)waitFuture(future) != 49)
+	{
+		printf("testFuture: incorrect nested future result.");
+		destroyFuture(future);
+		destroyThreadPool(threadPool);
+		return false;
+	}
+
+	destroyFuture(nestedFuture);
+	destroyFuture(future);
+	destroyThreadPool(threadPool);
+	return true;
+}
+
 int main()
 {
 	bool result = testAddBlocking();
 	result &= testTryAdd();
+	result &= testQueueOrder();
+	result &= testQueueResize();
+	result &= testStealing();
+	result &= testLockFree();
+	result &= testNumaOrder();
+	result &= testParallelFor();
+	result &= testTaskGroup();
+	result &= testInlineTask();
+	result &= testPinnedThreadPool();
+	result &= testWorkerOptions();
+	result &= testIdlePolicy();
+	result &= testManyProducers();
+	result &= testElasticThreadPool();
+	result &= testElasticKeepAlive();
+	result &= testSegmentedQueue();
+	result &= testTaskPriority();
+	result &= testFuture();
 	return result ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,144 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpmt/topology.h"
+#include "mpmt/thread_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+inline static bool testCpuCounts()
+{
+	size_t logicalCount = getLogicalCpuCount();
+	size_t coreCount = getPhysicalCoreCount();
+	size_t packageCount = getCpuPackageCount();
+	size_t siblingCount = getSmtSiblingCount();
+
+	if (logicalCount == 0 || coreCount == 0 || packageCount == 0 || siblingCount == 0)
+	{
+		printf("testCpuCounts: zero CPU count. (logical: %zu, cores: %zu, packages: %zu, siblings: %zu)", 
+			logicalCount, coreCount, packageCount, siblingCount);
+		return false;
+	}
+	if (coreCount > logicalCount || packageCount > coreCount || coreCount * siblingCount < logicalCount)
+	{
+		printf("testCpuCounts: inconsistent CPU counts. (logical: %zu, cores: %zu, packages: %zu, siblings: %zu)", 
+			logicalCount, coreCount, packageCount, siblingCount);
+		return false;
+	}
+
+	size_t availableCount = getAvailableCpuCount();
+	double quota = getCpuQuota();
+	if (availableCount == 0 || quota < 0.0 || (quota > 0.0 && (double)availableCount >= quota + 1.0))
+	{
+		printf("testCpuCounts: incorrect available CPU count. (available: %zu, quota: %f)", availableCount, quota);
+		return false;
+	}
+
+	return true;
+}
+
+inline static bool testCpuCaches()
+{
+	for (uint8_t level = 1; level <= 4; level++)
+	{
+		size_t size = getCpuCacheSize(level);
+		size_t lineSize = getCpuCacheLineSize(level);
+
+		if ((size == 0) != (lineSize == 0) || (lineSize & (lineSize - 1)) != 0)
+		{
+			printf("testCpuCaches: incorrect cache. (level: %d, size: %zu, lineSize: %zu)", 
+				(int)level, size, lineSize);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+inline static bool testNumaNodes()
+{
+	size_t nodeCount = getNumaNodeCount();
+	if (nodeCount == 0)
+	{
+		printf("testNumaNodes: zero node count.");
+		return false;
+	}
+
+	size_t totalCount = 0;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		size_t cpuCount = getNumaNodeCpus(i, NULL, 0);
+		size_t* cpus = cpuCount > 0 ? malloc(cpuCount * sizeof(size_t)) : NULL;
+		if (cpuCount > 0 && (!cpus || getNumaNodeCpus(i, cpus, cpuCount) != cpuCount))
+		{
+			printf("testNumaNodes: failed to get node CPUs. (node: %zu)", i);
+			free(cpus);
+			return false;
+		}
+
+		for (size_t j = 1; j < cpuCount; j++)
+		{
+			if (cpus[j - 1] >= cpus[j])
+			{
+				printf("testNumaNodes: CPUs are not in ascending order. (node: %zu)", i);
+				free(cpus);
+				return false;
+			}
+		}
+
+		free(cpus);
+		totalCount += cpuCount;
+	}
+
+	if (totalCount == 0 || getNumaNodeCpus(nodeCount, NULL, 0) != 0)
+	{
+		printf("testNumaNodes: incorrect node CPU count. (count: %zu)", totalCount);
+		return false;
+	}
+
+	return true;
+}
+
+inline static bool testAutoThreadCount()
+{
+	size_t availableCount = getAvailableCpuCount();
+	ThreadPool threadPool = createThreadPool(0, 256, QUEUE_TASK_ORDER);
+	if (!threadPool)
+	{
+		printf("testAutoThreadCount: failed to create thread pool.");
+		return false;
+	}
+
+	size_t threadCount = getThreadPoolThreadCount(threadPool);
+	destroyThreadPool(threadPool);
+
+	if (threadCount != (availableCount < 256 ? availableCount : 256))
+	{
+		printf("testAutoThreadCount: incorrect thread count. (count: %zu, available: %zu)", 
+			threadCount, availableCount);
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	bool result = testCpuCounts();
+	result &= testCpuCaches();
+	result &= testNumaNodes();
+	result &= testAutoThreadCount();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,237 @@
+// Copyright 2020-2026 Nikita Fediuchin. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/***********************************************************************************************************************
+ * @file
+ * @brief Thread pool future and promise.
+ * @details See the @ref createFuture()
+ */
+
+#pragma once
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <cassert>
+
+extern "C"
+{
+#include "mpmt/thread_pool.h"
+}
+
+namespace mpmt
+{
+
+using namespace std;
+
+template<typename T> class Promise;
+
+/**
+ * @brief Thread pool future of the typed result.
+ *
+ * @details
+ * See the @ref createFuture(). Result is stored in the state shared by the future copies, promise and
+ * not completed continuations. Task and continuation functions are executed by the thread pool workers,
+ * so they should not throw exceptions.
+ *
+ * @tparam T type of the future result
+ */
+template<typename T>
+class Future final
+{
+	struct State final
+	{
+		::Future instance = nullptr;
+		unique_ptr<T> result;
+
+		~State() { destroyFuture(instance); }
+	};
+	template<typename F>
+	struct Task final
+	{
+		shared_ptr<State> state;
+		F function;
+	};
+	template<typename F, typename R>
+	struct Continuation final
+	{
+		shared_ptr<State> antecedent;
+		shared_ptr<typename Future<R>::State> state;
+		F function;
+	};
+
+	shared_ptr<State> state;
+
+	explicit Future(shared_ptr<State> state) noexcept : state(std::move(state)) { }
+
+	template<typename F>
+	static void* onTask(void* argument, void*)
+	{
+		auto task = static_cast<Task<F>*>(argument);
+		auto taskState = task->state;
+		taskState->result.reset(new T(task->function()));
+		delete task;
+		return taskState->result.get();
+	}
+	template<typename F, typename R>
+	static void* onContinuation(void* argument, void* result)
+	{
+		auto continuation = static_cast<Continuation<F, R>*>(argument);
+		auto continuationState = continuation->state;
+		continuationState->result.reset(new R(continuation->function(*static_cast<T*>(result))));
+		delete continuation;
+		return continuationState->result.get();
+	}
+
+	template<typename U> friend class Future;
+	friend class Promise<T>;
+public:
+	/**
+	 * @brief Creates a new invalid future.
+	 */
+	Future() noexcept = default;
+
+	/**
+	 * @brief Adds a new future task to the thread pool. (Blocking)
+	 * @details See the @ref addThreadPoolFutureTask().
+	 *
+	 * @param threadPool thread pool instance
+	 * @param function future task function, returns the result
+	 *
+	 * @return Future of the function result, or invalid future on failure.
+	 */
+	template<typename F>
+	static Future run(ThreadPool threadPool, F&& function)
+	{
+		auto futureState = make_shared<State>();
+		auto task = new Task<typename decay<F>::type>{ futureState, std::forward<F>(function) };
+		futureState->instance = addThreadPoolFutureTask(threadPool, onTask<typename decay<F>::type>, task);
+
+		if (!futureState->instance)
+		{
+			delete task;
+			return Future();
+		}
+		return Future(std::move(futureState));
+	}
+
+	/**
+	 * @brief Adds a new continuation to the future. (Blocking)
+	 * @details See the @ref addFutureContinuation().
+	 *
+	 * @param function continuation function, receives the result reference and returns the new result
+	 * @return Future of the continuation function result, or invalid future on failure.
+	 */
+	template<typename F>
+	auto then(F&& function) -> Future<typename decay<decltype(function(declval<T&>()))>::type>
+	{
+		assert(isValid());
+		using R = typename decay<decltype(function(declval<T&>()))>::type;
+		using C = Continuation<typename decay<F>::type, R>;
+
+		auto continuationState = make_shared<typename Future<R>::State>();
+		auto continuation = new C{ state, continuationState, std::forward<F>(function) };
+		continuationState->instance = addFutureContinuation(state->instance,
+			onContinuation<typename decay<F>::type, R>, continuation);
+
+		if (!continuationState->instance)
+		{
+			delete continuation;
+			return Future<R>();
+		}
+		return Future<R>(std::move(continuationState));
+	}
+
+	/**
+	 * @brief Returns true if future has an instance.
+	 */
+	bool isValid() const noexcept { return state && state->instance; }
+	/**
+	 * @brief Returns true if future result is set.
+	 * @details See the @ref isFutureReady().
+	 */
+	bool isReady() const noexcept
+	{
+		assert(isValid());
+		return isFutureReady(state->instance);
+	}
+
+	/**
+	 * @brief Returns future result.
+	 * @details See the @ref getFutureResult().
+	 * @warning Future should be ready.
+	 */
+	T& get() const noexcept
+	{
+		assert(isReady());
+		return *static_cast<T*>(getFutureResult(state->instance));
+	}
+	/**
+	 * @brief Waits until the future is ready and returns its result. (Blocking)
+	 * @details See the @ref waitFuture().
+	 */
+	T& wait() const noexcept
+	{
+		assert(isValid());
+		return *static_cast<T*>(waitFuture(state->instance));
+	}
+};
+
+/**
+ * @brief Thread pool promise of the typed result.
+ * @details See the @ref createFuture().
+ * @tparam T type of the future result
+ */
+template<typename T>
+class Promise final
+{
+	shared_ptr<typename Future<T>::State> state;
+public:
+	/**
+	 * @brief Creates a new promise with the not ready future.
+	 * @details See the @ref createFuture().
+	 * @param threadPool thread pool instance, that executes future continuations
+	 */
+	explicit Promise(ThreadPool threadPool) : state(make_shared<typename Future<T>::State>())
+	{
+		state->instance = createFuture(threadPool);
+	}
+
+	/**
+	 * @brief Returns true if promise has a future instance.
+	 */
+	bool isValid() const noexcept { return state->instance; }
+	/**
+	 * @brief Returns promise future.
+	 */
+	Future<T> getFuture() const noexcept
+	{
+		assert(isValid());
+		return Future<T>(state);
+	}
+
+	/**
+	 * @brief Sets future result and adds its continuations to the thread pool. (Blocking)
+	 * @details See the @ref setFutureResult().
+	 * @warning Future result can be set only once.
+	 * @param result future result value
+	 */
+	void set(T result)
+	{
+		assert(isValid());
+		state->result.reset(new T(std::move(result)));
+		setFutureResult(state->instance, state->result.get());
+	}
+};
+
+} // namespace mpmt
@@ -92,6 +92,27 @@ public:
 		setThreadBackgroundPriority();
 	}
 
+	/**
+	 * @brief Sets current thread CPU affinity. (Pins thread to the specified logical CPUs)
+	 * @details See the @ref setCurrentThreadAffinity().
+	 * @param[in] cpus array of the logical CPU indices
+	 * @param cpuCount logical CPU index array size
+	 */
+	static bool setAffinity(const size_t* cpus, size_t cpuCount) noexcept
+	{
+		return setCurrentThreadAffinity(cpus, cpuCount);
+	}
+	/**
+	 * @brief Returns current thread CPU affinity. (Logical CPUs it can run on)
+	 * @details See the @ref getCurrentThreadAffinity().
+	 * @param[out] cpus pointer to the logical CPU index array or NULL
+	 * @param capacity logical CPU index array size
+	 */
+	static size_t getAffinity(size_t* cpus, size_t capacity) noexcept
+	{
+		return getCurrentThreadAffinity(cpus, capacity);
+	}
+
 	/**
 	 * @brief Blocks the execution of the current thread for a specified time.
 	 * @details See the @ref setThreadBackgroundPriority().